@@ -0,0 +1,28 @@
+#include "ClothBatch.h"
+
+int main(int argc, char* argv[])
+{
+   std::string batch_path, output_path = std::string(CMAKE_BINARY_DIR) + "/batch";
+   int job_num = 0;
+   bool valid = argc > 1;
+   for (int i = 1; i < argc && valid; ++i) {
+      const std::string option(argv[i]);
+      const bool has_value = i + 1 < argc;
+      if (option == "--jobs" && has_value) valid = (job_num = std::atoi( argv[++i] )) > 0;
+      else if (option == "--output" && has_value) output_path = argv[++i];
+      else if (batch_path.empty() && option.rfind( "--", 0 ) != 0) batch_path = option;
+      else valid = false;
+   }
+   if (!valid || batch_path.empty()) {
+      std::cerr << "Usage: " << argv[0] << " <batch file> [--jobs <number>] [--output <directory>]\n";
+      return 1;
+   }
+
+   ClothBatch batch;
+   if (!batch.read( batch_path )) return 1;
+   const bool done = batch.run( output_path, job_num );
+   const std::string summary_path = output_path + "/summary.csv";
+   if (!batch.writeSummary( summary_path )) return 1;
+   std::cout << "The summary is written into " << summary_path << "\n";
+   return done ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "ClothBenchmark.h"
+
+int main(int argc, char* argv[])
+{
+   ClothBenchmark::Options options;
+   std::string output_path;
+   const auto get_numbers = [](const std::string& list, std::vector<int>& numbers) {
+      numbers.clear();
+      std::istringstream stream(list);
+      std::string number;
+      while (std::getline( stream, number, ',' )) {
+         const int value = std::atoi( number.c_str() );
+         if (value <= 0) return false;
+         numbers.emplace_back( value );
+      }
+      return !numbers.empty();
+   };
+   bool valid = true;
+   for (int i = 1; i < argc && valid; ++i) {
+      const std::string option(argv[i]);
+      const bool has_value = i + 1 < argc;
+      if (option == "--sizes" && has_value) valid = get_numbers( argv[++i], options.GridSizes );
+      else if (option == "--substeps" && has_value) valid = get_numbers( argv[++i], options.SubstepNums );
+      else if (option == "--modes" && has_value) {
+         options.Modes.clear();
+         std::istringstream stream(argv[++i]);
+         std::string mode;
+         while (std::getline( stream, mode, ',' )) {
+            valid = valid && (mode == "serial" || mode == "threaded" || mode == "gpu");
+            options.Modes.emplace_back( mode );
+         }
+      }
+      else if (option == "--warmup" && has_value) valid = (options.WarmupFrameNum = std::atoi( argv[++i] )) >= 0;
+      else if (option == "--frames" && has_value) valid = (options.FrameNum = std::atoi( argv[++i] )) > 0;
+      else if (option == "--repetitions" && has_value) valid = (options.RepetitionNum = std::atoi( argv[++i] )) > 0;
+      else if (option == "--threads" && has_value) options.ThreadNum = std::atoi( argv[++i] );
+      else if (option == "--no-sphere") options.UseSphereCollider = false;
+      else if (option == "--output" && has_value) output_path = argv[++i];
+      else valid = false;
+   }
+   if (!valid) {
+      std::cerr << "Usage: " << argv[0]
+         << " [--sizes 64,128,...] [--substeps 1,2,...] [--modes serial,threaded,gpu] [--warmup <frames>]"
+         << " [--frames <frames>] [--repetitions <number>] [--threads <number>] [--no-sphere] [--output <file.json>]\n";
+      return 1;
+   }
+
+   ClothBenchmark benchmark(options);
+   benchmark.run();
+   return benchmark.writeJSON( output_path ) ? 0 : 1;
+}
\ No newline at end of file
@@ -5,5 +5,41 @@ target_link_libraries(
         pthread
         dl
         X11
+        EGL
         freeimage
+)
+
+target_link_libraries(
+     ClothBenchmark
+        glad
+        glfw3
+        pthread
+        dl
+        X11
+        EGL
+)
+
+target_link_libraries(
+     VertexBenchmark
+        glad
+        glfw3
+        pthread
+        dl
+        X11
+        EGL
+)
+
+target_link_libraries(
+     ClothValidation
+        glad
+        glfw3
+        pthread
+        dl
+        X11
+        EGL
+)
+
+target_link_libraries(
+     ClothBatch
+        pthread
 )
\ No newline at end of file
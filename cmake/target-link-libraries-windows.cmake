@@ -1,4 +1,7 @@
 target_link_libraries(ClothSimulation glad glfw3dll)
+target_link_libraries(ClothBenchmark glad glfw3dll)
+target_link_libraries(VertexBenchmark glad glfw3dll)
+target_link_libraries(ClothValidation glad glfw3dll)
 
 if(${CMAKE_BUILD_TYPE} MATCHES Debug)
    target_link_libraries(ClothSimulation FreeImaged)
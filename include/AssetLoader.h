@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Object.h"
+#include "ZoneProfiler.h"
+
+// The obj files are parsed and the images are decoded in the worker threads, and then the render thread streams
+// them into GL through a persistently mapped staging buffer, spending at most UploadBudget bytes per frame.
+// The staging buffer is split into the slots for the frames in flight, and a slot is reused only after its fence
+// is signaled, so the render thread never waits for the GPU.
+class AssetLoaderGL final
+{
+public:
+   AssetLoaderGL(const AssetLoaderGL&) = delete;
+   AssetLoaderGL(const AssetLoaderGL&&) = delete;
+   AssetLoaderGL& operator=(const AssetLoaderGL&) = delete;
+   AssetLoaderGL& operator=(const AssetLoaderGL&&) = delete;
+
+   explicit AssetLoaderGL(int thread_num = 2);
+   ~AssetLoaderGL();
+
+   // The object keeps its vertex format set before this call, and it is not drawable until on_ready is called.
+   void requestObject(
+      ObjectGL* object,
+      GLenum draw_mode,
+      const std::string& obj_file_path,
+      std::function<void()> on_ready = nullptr
+   );
+   // A white texel is added to the object right away as a placeholder, which is replaced when the texture is ready.
+   // It returns the index of the texture in the object.
+   int requestTexture(
+      ObjectGL* object,
+      const std::string& texture_file_path,
+      bool is_grayscale = false,
+      std::function<void()> on_ready = nullptr
+   );
+   // It should be called once per frame in the render thread.
+   void update();
+   [[nodiscard]] bool isIdle() const { return RequestNum == 0; }
+
+private:
+   struct Transfer
+   {
+      const uint8_t* Data;
+      size_t Size;
+      size_t CopiedSize;
+      GLuint Target;
+      bool IsTexture;
+      GLint Level;
+      GLsizei Width;
+      GLsizei Height;
+      GLenum InternalFormat;
+
+      Transfer(const uint8_t* data, size_t size, GLuint buffer) :
+         Data( data ), Size( size ), CopiedSize( 0 ), Target( buffer ), IsTexture( false ), Level( 0 ), Width( 0 ),
+         Height( 0 ), InternalFormat( 0 ) {}
+      Transfer(const uint8_t* data, size_t size, GLuint texture, GLint level, GLsizei width, GLsizei height, GLenum format) :
+         Data( data ), Size( size ), CopiedSize( 0 ), Target( texture ), IsTexture( true ), Level( level ),
+         Width( width ), Height( height ), InternalFormat( format ) {}
+   };
+
+   struct Asset
+   {
+      ObjectGL* Object;
+      GLenum DrawMode;
+      int TextureIndex;
+      bool IsGrayscale;
+      bool Loaded;
+      std::string FilePath;
+      std::function<void()> OnReady;
+      std::unique_ptr<ObjectGL::MeshData> Mesh;
+      std::unique_ptr<ObjectGL::TextureData> Texture;
+      GLuint TextureID;
+      std::vector<Transfer> Transfers;
+      size_t NextTransfer;
+
+      Asset() :
+         Object( nullptr ), DrawMode( 0 ), TextureIndex( -1 ), IsGrayscale( false ), Loaded( false ), TextureID( 0 ),
+         NextTransfer( 0 ) {}
+   };
+
+   inline static constexpr int FramesInFlight = 3;
+   inline static constexpr size_t UploadBudget = 4 * 1024 * 1024;
+   inline static constexpr int CompressedBlockSize = 4;
+
+   bool Stop;
+   int RequestNum;
+   GLuint StagingBuffer;
+   uint8_t* StagingData;
+   int StagingSlot;
+   std::array<GLsync, FramesInFlight> StagingFences;
+   std::vector<std::thread> Workers;
+   std::mutex Mutex;
+   std::condition_variable Condition;
+   std::deque<std::unique_ptr<Asset>> PendingAssets;
+   std::deque<std::unique_ptr<Asset>> LoadedAssets;
+   std::deque<std::unique_ptr<Asset>> UploadingAssets;
+
+   void work();
+   static void load(Asset& asset);
+   void enqueue(std::unique_ptr<Asset> asset);
+   void prepareUpload(Asset& asset) const;
+   [[nodiscard]] size_t copy(Transfer& transfer, size_t staging_offset, size_t budget) const;
+   static void finish(Asset& asset);
+};
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "_Common.h"
+
+// It writes a file into a temporary one next to it and renames it over the file only if everything is written,
+// so a crash in the middle never leaves a broken cache or checkpoint behind, and a reader sees either the old
+// file or the new one.
+class AtomicFile final
+{
+public:
+   AtomicFile() = delete;
+
+   // The directories of the path are created, and the description of the file is used in the error messages.
+   [[nodiscard]] static bool write(
+      const std::string& file_path,
+      const std::string& description,
+      const std::function<void(std::ofstream&)>& write_contents
+   );
+};
\ No newline at end of file
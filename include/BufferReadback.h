@@ -0,0 +1,41 @@
+#pragma once
+
+#include "GPUMemory.h"
+
+// It copies a buffer into a ring of persistently mapped slots and hands each copy to on_read once its fence
+// is signaled, so reading the simulation back does not stall the pipeline.
+// The copies are delivered in the order of the requests.
+class BufferReadbackGL final
+{
+public:
+   BufferReadbackGL(const BufferReadbackGL&) = delete;
+   BufferReadbackGL(const BufferReadbackGL&&) = delete;
+   BufferReadbackGL& operator=(const BufferReadbackGL&) = delete;
+   BufferReadbackGL& operator=(const BufferReadbackGL&&) = delete;
+
+   BufferReadbackGL(GLsizeiptr size, std::function<void(const uint8_t*)> on_read);
+   ~BufferReadbackGL();
+
+   // If every slot is still in flight, it waits for the oldest one, which happens only if GPU is far behind.
+   void request(GLuint buffer);
+   // It should be called once per frame to deliver the copies that are ready without waiting.
+   void update();
+   // It waits for all the copies in flight and delivers them.
+   void flush();
+   // The copies whose fences failed are never delivered, so the readers see a gap there.
+   [[nodiscard]] int getDroppedNum() const { return DroppedNum; }
+
+private:
+   inline static constexpr int SlotNum = 4;
+
+   GLsizeiptr Size;
+   GLuint Buffer;
+   const uint8_t* Data;
+   int OldestSlot;
+   int PendingNum;
+   int DroppedNum;
+   std::array<GLsync, SlotNum> Fences;
+   std::function<void(const uint8_t*)> OnRead;
+
+   [[nodiscard]] bool deliverOldest(GLuint64 timeout);
+};
\ No newline at end of file
@@ -34,6 +34,7 @@ public:
    void zoomOut();
    void resetCamera();
    void updateWindowSize(int width, int height);
+   void getFrustumPlanes(std::array<glm::vec4, 6>& planes) const;
 
 private:
    bool IsMoving;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ClothSolver.h"
+#include "ClothInvariants.h"
+#include "SceneFile.h"
+#include "PointCacheWriter.h"
+
+// It runs the variants of a scene, which a batch file sweeps over, and writes the point cache and the scene of each
+// variant with a summary of their timings and final invariants. The batch file has the settings of the base scene as
+// a scene file does, and
+//    scene <file>                         reads the base scene, relative to the batch file
+//    checkpoint <file>                    starts each variant from a checkpoint, relative to the batch file
+//    frames <number>                      simulates the steps of each variant
+//    sweep <keyword> <numbers> | ...      makes a variant of each numbers of the setting
+// The checkpoint also places the cloth and the sphere, while the physics still comes from the settings and the sweeps,
+// so the variants differ only after the state they share. The variants are the combinations of all the sweeps, and
+// each runs on the serial CPU solver of a worker thread, as a GPU would run them one after another anyway.
+class ClothBatch final
+{
+public:
+   ClothBatch(const ClothBatch&) = delete;
+   ClothBatch(const ClothBatch&&) = delete;
+   ClothBatch& operator=(const ClothBatch&) = delete;
+   ClothBatch& operator=(const ClothBatch&&) = delete;
+
+   ClothBatch();
+   ~ClothBatch() = default;
+
+   [[nodiscard]] bool read(const std::string& file_path);
+   // It uses all the hardware threads if the number of the jobs is not positive.
+   [[nodiscard]] bool run(const std::string& output_directory_path, int job_num);
+   [[nodiscard]] bool writeSummary(const std::string& file_path) const;
+   [[nodiscard]] int getVariantNum() const { return static_cast<int>(Variants.size()); }
+
+private:
+   struct Sweep
+   {
+      std::string Keyword;
+      std::vector<std::string> Values; // the numbers of each variant as they are written in the batch file
+   };
+
+   struct Variant
+   {
+      std::string Name;
+      SceneDescription Scene;
+      std::vector<std::string> Values; // of each sweep
+   };
+
+   struct Result
+   {
+      bool Done;
+      double Seconds;
+      ClothInvariants Invariants;
+   };
+
+   inline static constexpr int DefaultFrameNum = 300;
+   int FrameNum;
+   SceneDescription BaseScene;
+   std::string CheckpointPath;
+   std::vector<Sweep> Sweeps;
+   std::vector<Variant> Variants;
+   std::vector<Result> Results;
+
+   [[nodiscard]] bool readSweep(const std::string& arguments);
+   [[nodiscard]] bool setVariants();
+   [[nodiscard]] Result simulate(const Variant& variant, const std::filesystem::path& directory_path) const;
+};
\ No newline at end of file
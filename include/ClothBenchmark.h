@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ClothSolver.h"
+#include "ClothSimulator.h"
+#include "OffscreenContext.h"
+
+// It measures the throughput of the solvers over the grid sizes, sub-step counts and solver modes, and writes the
+// results as JSON. The GPU mode runs only if OffscreenContextGL creates an OpenGL 4.6 context, through EGL first on
+// Linux and then through a hidden window.
+class ClothBenchmark final
+{
+public:
+   struct Options
+   {
+      std::vector<int> GridSizes;
+      std::vector<int> SubstepNums;
+      std::vector<std::string> Modes; // serial, threaded and gpu
+      int WarmupFrameNum;
+      int FrameNum;
+      int RepetitionNum;
+      int ThreadNum;
+      bool UseSphereCollider;
+
+      Options() :
+         GridSizes{ 64, 128, 256, 512, 1024, 2048 }, SubstepNums{ 1 }, Modes{ "serial", "threaded", "gpu" },
+         WarmupFrameNum( 3 ), FrameNum( 10 ), RepetitionNum( 5 ), ThreadNum( 0 ), UseSphereCollider( true ) {}
+   };
+
+   ClothBenchmark(const ClothBenchmark&) = delete;
+   ClothBenchmark(const ClothBenchmark&&) = delete;
+   ClothBenchmark& operator=(const ClothBenchmark&) = delete;
+   ClothBenchmark& operator=(const ClothBenchmark&&) = delete;
+
+   explicit ClothBenchmark(Options options);
+   ~ClothBenchmark() = default;
+
+   void run();
+   // The results go to the standard output if the path is empty.
+   [[nodiscard]] bool writeJSON(const std::string& file_path) const;
+
+private:
+   struct Result
+   {
+      std::string Mode;
+      int GridSize;
+      int SubstepNum;
+      int ThreadNum;
+      int64_t PointNum;
+      int64_t SpringNum;
+      std::vector<double> StepsPerSecond; // of each repetition
+   };
+
+   struct Statistics
+   {
+      double Mean;
+      double Median;
+      double StandardDeviation;
+      double Min;
+      double Max;
+   };
+
+   Options Settings;
+   OffscreenContextGL Context;
+   std::vector<Result> Results;
+
+   [[nodiscard]] static Statistics getStatistics(std::vector<double> samples);
+   // A frame advances the cloth by the time step of the parameters, which the sub-steps split evenly.
+   template<typename StepFunction, typename FinishFunction>
+   void measure(Result& result, StepFunction step, FinishFunction finish) const
+   {
+      for (int i = 0; i < Settings.WarmupFrameNum * result.SubstepNum; ++i) step();
+      finish();
+      for (int r = 0; r < Settings.RepetitionNum; ++r) {
+         const auto start_time = std::chrono::steady_clock::now();
+         for (int i = 0; i < Settings.FrameNum * result.SubstepNum; ++i) step();
+         finish();
+         const double elapsed_time =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+         result.StepsPerSecond.emplace_back(
+            static_cast<double>(Settings.FrameNum) * result.SubstepNum / std::max( elapsed_time, 1e-9 )
+         );
+      }
+   }
+};
\ No newline at end of file
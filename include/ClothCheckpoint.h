@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ClothParameters.h"
+#include "AtomicFile.h"
+
+// The complete state of the cloth solver, from which the simulation continues exactly as it was saved.
+// Only the positions of the three steps in the ring are stored for each point, and the texture coordinates once,
+// because the solver does not change the others.
+class ClothCheckpoint final
+{
+public:
+   struct Header
+   {
+      std::array<char, 4> Magic;
+      uint32_t Version;
+      uint32_t PointNum;
+      uint32_t TargetIndex; // of the previous step in the ring of the renderer or ClothSolver
+      ClothParameters Parameters;
+      glm::mat4 ClothWorldMatrix;
+      glm::mat4 SphereWorldMatrix;
+      glm::vec3 SpherePosition;
+      float SphereRadius;
+   };
+
+   inline static constexpr int RingSize = 3;
+   using Ring = std::array<std::vector<GLfloat>, RingSize>;
+
+   ClothCheckpoint() = default;
+   ~ClothCheckpoint() = default;
+
+   // The buffers have the points of stride floats, whose first three floats are the position,
+   // and the last two are the texture coordinates.
+   [[nodiscard]] static bool write(const std::string& file_path, Header header, const Ring& buffers, int stride);
+   // The buffers should already have the points of the same number, whose positions and texture coordinates
+   // are overwritten.
+   [[nodiscard]] static bool read(const std::string& file_path, Header& header, Ring& buffers, int stride);
+
+private:
+   inline static constexpr std::array<char, 4> Magic = { 'C', 'C', 'K', 'P' };
+   inline static constexpr uint32_t Version = 1;
+};
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ClothParameters.h"
+
+// The physical quantities of a step of the cloth, which do not depend on the order of the points, so they compare
+// the solvers whose points drift apart as well as the runs of different parameters.
+struct ClothInvariants
+{
+   double Energy; // the kinetic, gravitational and elastic energy
+   float MaxStrain; // the largest stretch of the structural springs over their rest length
+   float Penetration; // the deepest point inside the sphere or under the floor
+   bool Finite;
+
+   ClothInvariants() : Energy( 0.0 ), MaxStrain( 0.0f ), Penetration( 0.0f ), Finite( true ) {}
+
+   // The velocities are of the previous points, which can be the current ones if the cloth is at rest.
+   [[nodiscard]] static ClothInvariants get(
+      const ClothSetup& setup,
+      const ClothParameters& parameters,
+      const std::vector<glm::vec3>& previous_points,
+      const std::vector<glm::vec3>& points
+   );
+};
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "_Common.h"
+
+// The physical constants of the cloth solver. The rest lengths are not here because they follow the grid.
+struct ClothParameters
+{
+   float SpringStiffness;
+   float SpringDamping;
+   float ShearStiffness;
+   float ShearDamping;
+   float FlexionStiffness;
+   float FlexionDamping;
+   float GravityConstant;
+   float GravityDamping;
+   float TimeStep;
+   float Mass;
+
+   ClothParameters() :
+      SpringStiffness( 10.0f ), SpringDamping( -0.5f ), ShearStiffness( 10.0f ), ShearDamping( -0.5f ),
+      FlexionStiffness( 5.0f ), FlexionDamping( -0.5f ), GravityConstant( -5.0f ), GravityDamping( -0.3f ),
+      TimeStep( 0.1f ), Mass( 1.0f ) {}
+};
+
+// The cloth and the sphere the solver runs with, whose defaults are the scene of the renderer.
+// The cloth starts flat on the xz-plane of its local space, and the points are spread evenly over the grid.
+struct ClothSetup
+{
+   glm::ivec2 PointNum;
+   glm::vec2 GridSize;
+   glm::mat4 ClothWorldMatrix;
+   glm::mat4 SphereWorldMatrix;
+   glm::vec3 SpherePosition;
+   float SphereRadius;
+   bool UseSphereCollider;
+
+   ClothSetup() :
+      PointNum( 100, 100 ), GridSize( 50.0f, 50.0f ),
+      ClothWorldMatrix( translate( glm::mat4(1.0f), glm::vec3(50.0f, 100.0f, 0.0f) ) ),
+      SphereWorldMatrix( translate( glm::mat4(1.0f), glm::vec3(100.0f, 30.0f, 20.0f) ) ),
+      SpherePosition( 0.0f, 0.0f, 0.0f ), SphereRadius( 20.0f ), UseSphereCollider( true ) {}
+
+   // The points are in rows along x, and the texture coordinates span [0, 1] over the grid.
+   void buildPoints(std::vector<glm::vec3>& points, std::vector<glm::vec2>& texture_coordinates) const
+   {
+      const float ds = 1.0f / static_cast<float>(PointNum.x - 1);
+      const float dt = 1.0f / static_cast<float>(PointNum.y - 1);
+      const float dx = GridSize.x * ds;
+      const float dy = GridSize.y * dt;
+      points.clear();
+      texture_coordinates.clear();
+      points.reserve( static_cast<size_t>(PointNum.x) * PointNum.y );
+      texture_coordinates.reserve( static_cast<size_t>(PointNum.x) * PointNum.y );
+      for (int j = 0; j < PointNum.y; ++j) {
+         const auto y = static_cast<float>(j);
+         for (int i = 0; i < PointNum.x; ++i) {
+            const auto x = static_cast<float>(i);
+            points.emplace_back( x * dx, 0.0f, y * dy );
+            texture_coordinates.emplace_back( x * ds, y * dt );
+         }
+      }
+   }
+   // It follows the renderer, which divides the grid by the number of the points rather than the intervals.
+   [[nodiscard]] float getSpringRestLength() const { return GridSize.x / static_cast<float>(PointNum.x); }
+   // Each spring is counted at both of its ends, as the solver evaluates it for each point.
+   [[nodiscard]] int64_t getSpringNum() const
+   {
+      const auto x = static_cast<int64_t>(PointNum.x), y = static_cast<int64_t>(PointNum.y);
+      const int64_t structural = (x - 1) * y + x * (y - 1);
+      const int64_t shear = 2 * (x - 1) * (y - 1);
+      const int64_t flexion = std::max<int64_t>( x - 2, 0 ) * y + x * std::max<int64_t>( y - 2, 0 );
+      return 2 * (structural + shear + flexion);
+   }
+};
\ No newline at end of file
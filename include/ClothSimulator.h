@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ClothParameters.h"
+#include "Shader.h"
+#include "VertexLayout.h"
+#include "GPUMemory.h"
+
+// It runs ClothSimulator.comp on its own ring of storage buffers, which lets the solver run without the renderer.
+// The kernel is specialized for the grid as the renderer does, and the buffers have the vertex layout of the cloth.
+class ClothSimulatorGL final
+{
+public:
+   ClothSimulatorGL(const ClothSimulatorGL&) = delete;
+   ClothSimulatorGL(const ClothSimulatorGL&&) = delete;
+   ClothSimulatorGL& operator=(const ClothSimulatorGL&) = delete;
+   ClothSimulatorGL& operator=(const ClothSimulatorGL&&) = delete;
+
+   ClothSimulatorGL();
+   ~ClothSimulatorGL();
+
+   [[nodiscard]] bool setCloth(const ClothSetup& setup);
+   void step(const ClothParameters& parameters);
+   // It replaces the points of the last two steps, so the next step continues from the state of another solver.
+   void setPoints(const std::vector<glm::vec3>& previous_points, const std::vector<glm::vec3>& points);
+   // It waits for the steps in flight, so the points are the ones of the last step.
+   void getPoints(std::vector<glm::vec3>& points) const;
+   [[nodiscard]] int getPointNum() const { return Setup.PointNum.x * Setup.PointNum.y; }
+
+private:
+   inline static constexpr int WorkGroupSize = 16;
+   inline static constexpr int PointStride = 8; // the floats of Attributes in the shaders
+
+   uint TargetIndex;
+   ClothSetup Setup;
+   std::array<GLuint, 3> Buffers;
+   std::unique_ptr<ShaderGL> Shader;
+
+   void deleteBuffers();
+};
\ No newline at end of file
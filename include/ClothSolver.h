@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ClothParameters.h"
+#include "ClothCheckpoint.h"
+#include "ZoneProfiler.h"
+
+// It is the CPU port of ClothSimulator.comp, which follows the kernel operation by operation so that both can be
+// compared. The points are kept in the same ring of the previous, current, and next steps, and the threaded mode
+// splits the rows among the workers, which wait for each step on a condition variable.
+class ClothSolver final
+{
+public:
+   enum class SolverMode { Serial = 0, Threaded };
+
+   ClothSolver(const ClothSolver&) = delete;
+   ClothSolver(const ClothSolver&&) = delete;
+   ClothSolver& operator=(const ClothSolver&) = delete;
+   ClothSolver& operator=(const ClothSolver&&) = delete;
+
+   // The threaded mode uses all the hardware threads if the number of the threads is not positive.
+   explicit ClothSolver(SolverMode mode = SolverMode::Serial, int thread_num = 0);
+   ~ClothSolver();
+
+   void setCloth(const ClothSetup& setup);
+   void step(const ClothParameters& parameters);
+   // It replaces the points of the last two steps, so the next step continues from the state of another solver.
+   void setPoints(const std::vector<glm::vec3>& previous_points, const std::vector<glm::vec3>& points);
+   // The checkpoint has the same ring as the one the F5 key of the renderer saves, so either continues from the other.
+   // The cloth should be set first with the same number of the points, and the matrices and the sphere of the
+   // checkpoint replace those of the cloth, as the points are placed by them.
+   [[nodiscard]] bool saveCheckpoint(const std::string& file_path, const ClothParameters& parameters) const;
+   [[nodiscard]] bool loadCheckpoint(const std::string& file_path, ClothParameters& parameters);
+   [[nodiscard]] const ClothSetup& getSetup() const { return Setup; }
+   [[nodiscard]] int getPointNum() const { return Setup.PointNum.x * Setup.PointNum.y; }
+   [[nodiscard]] SolverMode getMode() const { return Mode; }
+   [[nodiscard]] int getThreadNum() const { return static_cast<int>(Workers.size()) + 1; }
+   [[nodiscard]] const std::vector<glm::vec3>& getPoints() const { return Points[(TargetIndex + 1) % 3]; }
+   [[nodiscard]] const std::vector<glm::vec2>& getTextureCoordinates() const { return TextureCoordinates; }
+
+private:
+   enum class SpringType { Structural = 0, Shear, Flexion };
+
+   inline static constexpr int CheckpointPointStride = 5; // the position and the texture coordinates
+
+   struct Neighbor
+   {
+      glm::ivec2 Offset;
+      SpringType Type;
+   };
+
+   // The order is the one of the kernel, so the forces are summed in the same order.
+   inline static const std::array<Neighbor, 12> Neighbors = {
+      Neighbor{ { 0, -1 }, SpringType::Structural }, Neighbor{ { 0, 1 }, SpringType::Structural },
+      Neighbor{ { -1, 0 }, SpringType::Structural }, Neighbor{ { 1, 0 }, SpringType::Structural },
+      Neighbor{ { -1, -1 }, SpringType::Shear }, Neighbor{ { 1, -1 }, SpringType::Shear },
+      Neighbor{ { -1, 1 }, SpringType::Shear }, Neighbor{ { 1, 1 }, SpringType::Shear },
+      Neighbor{ { 0, -2 }, SpringType::Flexion }, Neighbor{ { 0, 2 }, SpringType::Flexion },
+      Neighbor{ { -2, 0 }, SpringType::Flexion }, Neighbor{ { 2, 0 }, SpringType::Flexion }
+   };
+
+   struct StepConstants
+   {
+      std::array<float, 3> Stiffness;
+      std::array<float, 3> RestLength;
+      std::array<float, 3> Damping;
+      glm::vec3 Gravity;
+      glm::vec3 SphereCenter;
+      glm::mat4 ClothToWorld;
+      glm::mat4 WorldToCloth;
+      float GravityDamping;
+      float TimeStep;
+      float Mass;
+      float SphereRadius;
+   };
+
+   SolverMode Mode;
+   uint TargetIndex;
+   ClothSetup Setup;
+   StepConstants Constants;
+   std::array<std::vector<glm::vec3>, 3> Points;
+   std::vector<glm::vec2> TextureCoordinates;
+   std::vector<std::thread> Workers;
+   std::mutex Mutex;
+   std::condition_variable Condition;
+   uint64_t Generation;
+   int RunningWorkerNum;
+   bool Stop;
+
+   void work(int worker_index);
+   void solveRows(int begin_row, int end_row);
+   [[nodiscard]] glm::ivec2 getRows(int worker_index) const;
+   [[nodiscard]] glm::vec3 solvePoint(int x, int y) const;
+};
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "BufferReadback.h"
+
+// It collects the counters that ClothSimulator.comp writes with USE_COUNTERS, which are read back a few steps later
+// without waiting for GPU, so they cost only the atomics of each workgroup. The counters of every step are kept, so
+// they can be written with the step and compared with the frame time and the scene.
+class ClothStatisticsGL final
+{
+public:
+   // It is the layout of Counters in the kernel.
+   struct Counters
+   {
+      uint32_t MovedPoints;
+      uint32_t EvaluatedSprings;
+      uint32_t CollisionTests;
+      uint32_t Contacts;
+      uint32_t AwakeTiles;
+   };
+
+   inline static constexpr GLuint CounterBinding = 6;
+
+   ClothStatisticsGL(const ClothStatisticsGL&) = delete;
+   ClothStatisticsGL(const ClothStatisticsGL&&) = delete;
+   ClothStatisticsGL& operator=(const ClothStatisticsGL&) = delete;
+   ClothStatisticsGL& operator=(const ClothStatisticsGL&&) = delete;
+
+   ClothStatisticsGL();
+   ~ClothStatisticsGL();
+
+   // The tiles are the workgroups of a step, which is the upper bound of the awake ones.
+   void prepare(int point_num, int tile_num);
+   [[nodiscard]] bool isPrepared() const { return CounterBuffer != 0; }
+   // It binds the counters for the next step, which should be requested right after it is dispatched.
+   void bind() const;
+   void request();
+   // It should be called once per frame to collect the counters that are ready.
+   void update() { if (Readback) Readback->update(); }
+   // It waits for the counters in flight, so it should be called only at the end.
+   void flush() { if (Readback) Readback->flush(); }
+   [[nodiscard]] int getPointNum() const { return PointNum; }
+   [[nodiscard]] int getTileNum() const { return TileNum; }
+   [[nodiscard]] int getStepNum() const { return static_cast<int>(Steps.size()); }
+   [[nodiscard]] const Counters& getLatest() const { return Latest; }
+   // It is the mean of each counter over the last RollingStepNum steps.
+   [[nodiscard]] std::array<double, 5> getRollingAverage() const;
+   [[nodiscard]] bool writeCSV(const std::string& file_path) const;
+
+private:
+   inline static constexpr int RollingStepNum = 60;
+
+   int PointNum;
+   int TileNum;
+   GLuint CounterBuffer;
+   Counters Latest;
+   std::vector<Counters> Steps;
+   std::unique_ptr<BufferReadbackGL> Readback;
+
+   [[nodiscard]] static std::array<uint32_t, 5> toArray(const Counters& counters);
+};
\ No newline at end of file
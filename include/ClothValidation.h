@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ClothSolver.h"
+#include "ClothSimulator.h"
+#include "ClothInvariants.h"
+#include "OffscreenContext.h"
+
+// It runs the same cloth on the serial CPU solver, which is the reference, and on the threaded CPU solver and
+// ClothSimulator.comp in lockstep, and compares the points of every step within the tolerances. The physical
+// invariants of every solver are checked as well, and those of the reference can be compared with a baseline
+// written before a change, which catches the changes made to the kernel and its CPU port alike. A checkpoint saved in
+// the middle of the reference is also restored into another solver, which must continue with the same bits.
+// The GPU solver runs only if an OpenGL 4.6 context can be created, which may be a software one such as llvmpipe.
+class ClothValidation final
+{
+public:
+   struct Options
+   {
+      std::vector<int> GridSizes;
+      int StepNum;
+      int ThreadNum;
+      bool UseSphereCollider;
+      bool RequireGPU;
+      // The lengths are relative to the rest length of the structural springs, and the energy to the initial one.
+      float PositionTolerance;
+      float EnergyTolerance;
+      float StrainTolerance;
+      float PenetrationTolerance;
+      float MaxStrain;
+      float MaxPenetration;
+      float MaxEnergyGain;
+
+      Options() :
+         GridSizes{ 33, 100 }, StepNum( 300 ), ThreadNum( 0 ), UseSphereCollider( true ), RequireGPU( false ),
+         PositionTolerance( 0.001f ), EnergyTolerance( 0.01f ), StrainTolerance( 0.25f ),
+         PenetrationTolerance( 0.02f ), MaxStrain( 4.0f ), MaxPenetration( 0.1f ), MaxEnergyGain( 0.01f ) {}
+   };
+
+   ClothValidation(const ClothValidation&) = delete;
+   ClothValidation(const ClothValidation&&) = delete;
+   ClothValidation& operator=(const ClothValidation&) = delete;
+   ClothValidation& operator=(const ClothValidation&&) = delete;
+
+   explicit ClothValidation(Options options);
+   ~ClothValidation() = default;
+
+   // It returns true if every solver stays within the tolerances at every step.
+   [[nodiscard]] bool run();
+   [[nodiscard]] bool readBaseline(const std::string& file_path);
+   [[nodiscard]] bool writeBaseline(const std::string& file_path) const;
+   void printResults() const;
+
+private:
+   struct Run
+   {
+      std::unique_ptr<ClothSolver> CPU;
+      std::unique_ptr<ClothSimulatorGL> GPU;
+      std::vector<glm::vec3> PreviousPoints;
+      std::vector<glm::vec3> Points;
+   };
+
+   // Each solver runs twice. The free run is compared with the reference by the invariants only, since the contacts
+   // with the sphere amplify the rounding differences of the solvers step by step. The synced run starts every step
+   // from the points of the reference, so its points are compared with those of the reference.
+   struct Candidate
+   {
+      std::string Solver;
+      Run Free;
+      Run Synced;
+   };
+
+   struct Result
+   {
+      std::string Solver;
+      int GridSize;
+      float MaxDeviation;
+      float RMSDeviation; // at the step of the largest deviation
+      double MaxEnergyError;
+      float MaxStrainError;
+      float MaxPenetrationError;
+      int FailedStep; // -1 if it passes
+      std::string Failure;
+   };
+
+   Options Settings;
+   OffscreenContextGL Context;
+   ClothParameters Parameters;
+   std::map<int, std::vector<ClothInvariants>> ReferenceInvariants; // of each grid size
+   std::map<int, std::vector<ClothInvariants>> BaselineInvariants;
+   std::vector<Result> Results;
+
+   [[nodiscard]] static ClothSetup getSetup(int grid_size, bool use_sphere_collider);
+   [[nodiscard]] static Result getEmptyResult(const std::string& solver, int grid_size);
+   // Only the first failure of a solver is kept, as the later ones usually follow from it.
+   static void fail(Result& result, int step, const std::string& failure);
+   void checkInvariants(Result& result, int step, const ClothInvariants& invariants, double initial_energy, float rest_length) const;
+   void compareInvariants(
+      Result& result,
+      int step,
+      const ClothInvariants& invariants,
+      const ClothInvariants& reference,
+      double initial_energy,
+      float rest_length
+   ) const;
+   void comparePoints(Result& result, int step, const Run& run, const Run& reference, float rest_length) const;
+   [[nodiscard]] bool createRun(Run& run, const std::string& solver, const ClothSetup& setup) const;
+   void step(Run& run) const;
+   void validate(int grid_size);
+   void validateCheckpoint(int grid_size);
+};
\ No newline at end of file
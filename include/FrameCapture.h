@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ZoneProfiler.h"
+#include "GPUMemory.h"
+
+// It captures the rendered frames without stalling the pipeline. Each frame is read into a slot of a ring of
+// pixel pack buffers, which is mapped only after its fence is signaled a few frames later, and the pixels are
+// handed to a background thread that writes them.
+class FrameCaptureGL final
+{
+public:
+   // Raw is a single file of the RGB frames from the top row, PNG is a file per frame,
+   // and Y4M is a single YUV 4:2:0 stream that most video tools read.
+   enum class CaptureFormat { Raw = 0, PNG, Y4M };
+
+   FrameCaptureGL(const FrameCaptureGL&) = delete;
+   FrameCaptureGL(const FrameCaptureGL&&) = delete;
+   FrameCaptureGL& operator=(const FrameCaptureGL&) = delete;
+   FrameCaptureGL& operator=(const FrameCaptureGL&&) = delete;
+
+   FrameCaptureGL();
+   ~FrameCaptureGL();
+
+   // The frames are written into the directory, whose size is fixed while capturing.
+   [[nodiscard]] bool start(const std::string& directory_path, CaptureFormat format, int width, int height, int fps);
+   // It should be called after rendering a frame and before swapping the buffers.
+   void capture();
+   void stop();
+   [[nodiscard]] bool isCapturing() const { return Writer.joinable(); }
+   [[nodiscard]] int getWidth() const { return Width; }
+   [[nodiscard]] int getHeight() const { return Height; }
+   [[nodiscard]] int getFrameNum() const { return FrameNum; }
+   // The frames whose fences failed are never written, so the capture skips them.
+   [[nodiscard]] int getDroppedFrameNum() const { return DroppedFrameNum; }
+
+private:
+   inline static constexpr int SlotNum = 3;
+   // The render thread waits for the writer only if this many frames are not written yet.
+   inline static constexpr int MaxPendingFrameNum = 8;
+
+   CaptureFormat Format;
+   int Width;
+   int Height;
+   int FrameNum;
+   int WrittenFrameNum;
+   int DroppedFrameNum;
+   bool Stop;
+   GLuint PackBuffer;
+   GLsizeiptr SlotSize;
+   const uint8_t* Data;
+   int OldestSlot;
+   int PendingSlotNum;
+   std::array<GLsync, SlotNum> Fences;
+   std::string DirectoryPath;
+   std::ofstream File;
+   std::thread Writer;
+   std::mutex Mutex;
+   std::condition_variable Condition;
+   std::deque<std::vector<uint8_t>> PendingFrames;
+
+   [[nodiscard]] bool deliverOldest(GLuint64 timeout);
+   void write();
+   void writeFrame(const std::vector<uint8_t>& rgba, int frame_index);
+   void writeRaw(const std::vector<uint8_t>& rgba);
+   void writePNG(const std::vector<uint8_t>& rgba, int frame_index) const;
+   void writeY4M(const std::vector<uint8_t>& rgba);
+};
\ No newline at end of file
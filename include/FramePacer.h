@@ -0,0 +1,82 @@
+#pragma once
+
+#include "_Common.h"
+
+// It paces the frames of the play loop and bounds how many of them GPU may lag behind, which bounds the latency
+// from an input to the frame showing it. A frame with inputs gets a timestamp query right after its swap, which is
+// converted into the CPU clock, so the end of the latency is when GPU completed the frame and queued it for
+// presentation; the scan-out adds at most a refresh interval to it. GLFW gives no time of an event, so the latency
+// is measured from the previous poll, which the event arrived after, and also from the callback, which is the
+// lower bound. The true latency lies between the two.
+class FramePacerGL final
+{
+public:
+   // VSync waits in the swap, Uncapped never waits, and Fixed sleeps and then spins until the deadline of its rate.
+   enum class PacingMode { VSync = 0, Uncapped, Fixed };
+
+   inline static constexpr int MaxFramesInFlight = 8;
+
+   FramePacerGL(const FramePacerGL&) = delete;
+   FramePacerGL(const FramePacerGL&&) = delete;
+   FramePacerGL& operator=(const FramePacerGL&) = delete;
+   FramePacerGL& operator=(const FramePacerGL&&) = delete;
+
+   FramePacerGL();
+   ~FramePacerGL();
+
+   void setMode(PacingMode mode, double target_rate = 60.0);
+   // It is clamped into [1, MaxFramesInFlight], where 1 lets GPU start a frame only after the previous one is done.
+   void setFramesInFlight(int frame_num) { FramesInFlight = std::clamp( frame_num, 1, MaxFramesInFlight ); }
+   // Nothing swaps the buffers without a window, so VSync does not wait there.
+   [[nodiscard]] int getSwapInterval() const { return Mode == PacingMode::VSync ? 1 : 0; }
+   // It should be called by the input callbacks, and the earliest callback of a frame is kept.
+   void markInput();
+   // It should be called right after the events are polled, as the next events arrive after it.
+   void markPoll() { LastPollTime = Clock::now(); }
+   // It should be called before the events are polled, so the frame handles the inputs right after the wait.
+   void beginFrame();
+   // It should be called right after the frame is swapped or flushed.
+   void endFrame();
+   // It waits for the frames in flight and deletes the queries, so it should be called only at the end.
+   void finish();
+   void printSummary() const;
+
+private:
+   using Clock = std::chrono::steady_clock;
+
+   // The sleep of the operating system can overshoot by this much, so the rest of the wait spins.
+   inline static constexpr std::chrono::microseconds SpinMargin{ 2000 };
+
+   struct FrameInFlight
+   {
+      GLsync Fence;
+      GLuint Query;
+      bool HasInput;
+      Clock::time_point PollTime;
+      Clock::time_point CallbackTime;
+   };
+
+   PacingMode Mode;
+   int FramesInFlight;
+   Clock::duration TargetInterval;
+   Clock::time_point Deadline;
+   Clock::time_point LastFrameTime;
+   Clock::time_point LastPollTime;
+   bool HasPendingInput;
+   Clock::time_point PendingPollTime;
+   Clock::time_point PendingCallbackTime;
+   int OldestSlot;
+   int PendingNum;
+   int BlockedFrameNum;
+   std::array<FrameInFlight, MaxFramesInFlight> Frames;
+   std::vector<double> FrameIntervals;
+   std::vector<double> PollLatencies;
+   std::vector<double> CallbackLatencies;
+
+   [[nodiscard]] bool retireOldest(GLuint64 timeout);
+   [[nodiscard]] static Clock::time_point getPresentTime(GLuint query);
+   void waitForDeadline();
+   [[nodiscard]] static const char* getModeName(PacingMode mode);
+   [[nodiscard]] static double getPercentile(const std::vector<double>& sorted_times, double percentile);
+   static void printTimes(const std::string& name, std::vector<double> times);
+};
\ No newline at end of file
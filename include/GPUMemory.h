@@ -0,0 +1,67 @@
+#pragma once
+
+#include "_Common.h"
+
+// It records every buffer, texture and renderbuffer with its size, owner and label, and labels the GL object so that
+// the debuggers such as RenderDoc show the same names. The totals of each category are reported at exit, the objects
+// still recorded after all the owners are destroyed are reported as leaks, and a scene beyond the budget is refused.
+// The GL objects are created and deleted only on the thread of the context, so it takes no lock.
+class GPUMemoryGL final
+{
+public:
+   enum class Category { Vertex = 0, Index, Storage, Indirect, Transfer, Texture, Renderbuffer };
+
+   GPUMemoryGL() = delete;
+
+   // The object should be recorded right after its storage is allocated, as the label needs the object created.
+   static void addBuffer(GLuint buffer, Category category, GLsizeiptr size, const std::string& owner, const std::string& label);
+   static void addTexture(GLuint texture, GLsizeiptr size, const std::string& owner, const std::string& label);
+   static void addRenderbuffer(GLuint renderbuffer, GLsizeiptr size, const std::string& owner, const std::string& label);
+   // The texture created for another object, e.g. by the asset loader, is given to its new owner.
+   static void setTextureOwner(GLuint texture, const std::string& owner, const std::string& label);
+   // They should be called with the names given to glDelete*, where 0 is ignored as GL does.
+   static void removeBuffers(GLsizei n, const GLuint* buffers);
+   static void removeTextures(GLsizei n, const GLuint* textures);
+   static void removeRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+   // No budget is enforced if it is not positive.
+   static void setBudget(int64_t size) { Budget = size; }
+   [[nodiscard]] static bool fits(int64_t size) { return Budget <= 0 || TotalSize + size <= Budget; }
+   [[nodiscard]] static bool isOverBudget() { return Budget > 0 && TotalSize > Budget; }
+   [[nodiscard]] static int64_t getTotalSize() { return TotalSize; }
+   [[nodiscard]] static int64_t getBudget() { return Budget; }
+   [[nodiscard]] static double toMiB(int64_t size) { return static_cast<double>(size) / (1024.0 * 1024.0); }
+   static void printReport();
+   // It returns the number of the leaked objects, which are printed with their owners and labels.
+   static int reportLeaks();
+
+private:
+   inline static constexpr int CategoryNum = 7;
+   inline static constexpr std::array<const char*, CategoryNum> CategoryNames = {
+      "vertex", "index", "storage", "indirect", "transfer", "texture", "renderbuffer"
+   };
+
+   struct Resource
+   {
+      Category Type;
+      int64_t Size;
+      std::string Owner;
+      std::string Label;
+   };
+
+   struct Usage
+   {
+      int Count;
+      int64_t Size;
+      int64_t PeakSize;
+   };
+
+   // They are keyed by the identifier of glObjectLabel and the name, as the names of the kinds overlap.
+   inline static std::map<std::pair<GLenum, GLuint>, Resource> Resources;
+   inline static std::array<Usage, CategoryNum> Usages{};
+   inline static int64_t TotalSize = 0;
+   inline static int64_t PeakTotalSize = 0;
+   inline static int64_t Budget = 0;
+
+   static void add(GLenum identifier, GLuint name, Category category, GLsizeiptr size, const std::string& owner, const std::string& label);
+   static void remove(GLenum identifier, GLsizei n, const GLuint* names);
+};
\ No newline at end of file
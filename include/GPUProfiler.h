@@ -0,0 +1,85 @@
+#pragma once
+
+#include "_Common.h"
+
+// It measures the named scopes of each frame on GPU with timestamp queries, which can be nested unlike
+// GL_TIME_ELAPSED. The queries of a frame are read FrameLatency frames later only if they are available,
+// so it never waits for GPU, and a frame whose results are still not ready is dropped.
+class GPUProfilerGL final
+{
+public:
+   GPUProfilerGL(const GPUProfilerGL&) = delete;
+   GPUProfilerGL(const GPUProfilerGL&&) = delete;
+   GPUProfilerGL& operator=(const GPUProfilerGL&) = delete;
+   GPUProfilerGL& operator=(const GPUProfilerGL&&) = delete;
+
+   GPUProfilerGL();
+   ~GPUProfilerGL();
+
+   // Nothing is measured until it is enabled, so the scopes can be left in the code.
+   void setEnabled(bool enabled) { Enabled = enabled; }
+   [[nodiscard]] bool isEnabled() const { return Enabled; }
+   void beginFrame();
+   void endFrame();
+   void beginScope(const std::string& name);
+   void endScope();
+   // It waits for the frames in flight, so it should be called only at the end.
+   void finish();
+   // The statistics are of the last MaxSampleFrameNum frames, which is the whole run unless it is long, and the rolling
+   // average is of the last RollingFrameNum frames.
+   void printSummary() const;
+   [[nodiscard]] bool writeCSV(const std::string& file_path) const;
+
+private:
+   inline static constexpr int FrameLatency = 4;
+   inline static constexpr int RollingFrameNum = 120;
+   // The samples of the older frames are discarded, so a long interactive session does not grow them without bound.
+   inline static constexpr int MaxSampleFrameNum = 18000;
+
+   struct Scope
+   {
+      int NameIndex;
+      int Depth;
+      GLuint BeginQuery;
+      GLuint EndQuery;
+
+      Scope(int name_index, int depth, GLuint begin_query, GLuint end_query) :
+         NameIndex( name_index ), Depth( depth ), BeginQuery( begin_query ), EndQuery( end_query ) {}
+   };
+
+   struct FrameQueries
+   {
+      int FrameIndex;
+      int UsedQueryNum;
+      bool Pending;
+      std::vector<GLuint> Queries;
+      std::vector<Scope> Scopes;
+
+      FrameQueries() : FrameIndex( -1 ), UsedQueryNum( 0 ), Pending( false ) {}
+   };
+
+   struct Sample
+   {
+      int FrameIndex;
+      int NameIndex;
+      int Depth;
+      double Milliseconds;
+
+      Sample(int frame_index, int name_index, int depth, double milliseconds) :
+         FrameIndex( frame_index ), NameIndex( name_index ), Depth( depth ), Milliseconds( milliseconds ) {}
+   };
+
+   bool Enabled;
+   int FrameIndex;
+   int DroppedFrameNum;
+   std::array<FrameQueries, FrameLatency> Frames;
+   std::vector<int> OpenScopes;
+   std::vector<std::string> Names;
+   std::unordered_map<std::string, int> NameIndices;
+   std::deque<Sample> Samples;
+
+   [[nodiscard]] FrameQueries& getCurrentFrame() { return Frames[FrameIndex % FrameLatency]; }
+   [[nodiscard]] GLuint getQuery(FrameQueries& frame);
+   [[nodiscard]] bool collect(FrameQueries& frame, bool wait);
+   [[nodiscard]] static double getPercentile(std::vector<double>& sorted_times, double percentile);
+};
\ No newline at end of file
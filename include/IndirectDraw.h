@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GPUMemory.h"
+
+class IndirectDrawGL final
+{
+public:
+   // It has the same layout with DrawElementsIndirectCommand of OpenGL.
+   // BaseInstance is not used for the instanced attributes, so it holds the index of the object to be culled.
+   struct DrawElementsCommand
+   {
+      GLuint Count;
+      GLuint InstanceCount;
+      GLuint FirstIndex;
+      GLint BaseVertex;
+      GLuint BaseInstance;
+
+      DrawElementsCommand(GLuint count, GLuint first_index) :
+         Count( count ), InstanceCount( 1 ), FirstIndex( first_index ), BaseVertex( 0 ), BaseInstance( 0 ) {}
+   };
+
+   inline static constexpr GLuint CullingWorkGroupSize = 64;
+   inline static constexpr GLuint BoundingSphereBinding = 3;
+
+   IndirectDrawGL();
+   ~IndirectDrawGL();
+
+   [[nodiscard]] int addObject(const std::vector<DrawElementsCommand>& commands);
+   // The number of commands of the object should be the same as when it is added.
+   void setCommands(int object_index, const std::vector<DrawElementsCommand>& commands);
+   void setBoundingSphere(int object_index, const glm::vec4& sphere_in_wc);
+   // The sphere of the object is written on GPU into the buffer bound by bindBoundingSpheres() before each cull,
+   // so it is not uploaded from setBoundingSphere().
+   void setBoundingSphereOnGPU(int object_index) { BoundingSpheresOnGPU[object_index] = true; }
+   void bindBoundingSpheres() const;
+   void prepareBuffers();
+   void cull() const;
+   void draw(int object_index, GLenum draw_mode) const;
+
+private:
+   struct CommandRange
+   {
+      GLsizei First;
+      GLsizei Count;
+
+      CommandRange(GLsizei first, GLsizei count) : First( first ), Count( count ) {}
+   };
+
+   inline static constexpr GLuint CommandBinding = 4;
+
+   GLuint CommandBuffer;
+   GLuint BoundingSphereBuffer;
+   std::vector<DrawElementsCommand> Commands;
+   std::vector<CommandRange> Ranges;
+   std::vector<glm::vec4> BoundingSpheres;
+   std::vector<bool> BoundingSpheresOnGPU;
+
+   void deleteBuffers();
+};
\ No newline at end of file
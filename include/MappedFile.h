@@ -0,0 +1,33 @@
+#pragma once
+
+#include "_Common.h"
+
+class MappedFile final
+{
+public:
+   MappedFile(const MappedFile&) = delete;
+   MappedFile(const MappedFile&&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&&) = delete;
+
+   MappedFile();
+   ~MappedFile();
+
+   // The whole file is mapped read-only, so the pages are loaded by the kernel only when they are touched.
+   [[nodiscard]] bool open(const std::string& file_path);
+   void close();
+   [[nodiscard]] bool isOpen() const { return IsOpen; }
+   [[nodiscard]] const char* getData() const { return Data; }
+   [[nodiscard]] size_t getSize() const { return Size; }
+
+private:
+   bool IsOpen;
+   const char* Data;
+   size_t Size;
+#ifdef _WIN32
+   void* FileHandle;
+   void* MappingHandle;
+#else
+   int FileDescriptor;
+#endif
+};
\ No newline at end of file
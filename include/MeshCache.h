@@ -0,0 +1,50 @@
+#pragma once
+
+#include "SourceCache.h"
+
+// The vertices and indices of a mesh after parsing, deduplication, cache optimization, and packing,
+// which are laid out in a file as they are uploaded to the buffers.
+class MeshCache final : public SourceCache
+{
+public:
+   struct Header
+   {
+      std::array<char, 4> Magic;
+      uint32_t Version;
+      int64_t SourceModifiedTime;
+      uint64_t SourceSize;
+      uint64_t VertexOffset; // aligned to VertexAlignment from the beginning of the file
+      uint64_t IndexOffset;
+      uint32_t VertexNum;
+      uint32_t IndexNum;
+      uint32_t BytesPerVertex;
+      uint32_t PositionFormat;
+      uint32_t NormalFormat;
+      uint32_t TextureFormat;
+      glm::vec3 PositionScale;
+      glm::vec3 PositionOffset;
+      glm::vec4 BoundingSphere;
+      uint32_t SourcePathLength; // the source path follows the header to tell apart the paths of the same hash
+      uint32_t Reserved;
+   };
+
+   explicit MeshCache(const std::string& source_file_path);
+   ~MeshCache() = default;
+
+   // The cache is valid only if it is also written with the same vertex formats.
+   [[nodiscard]] bool load(uint32_t position_format, uint32_t normal_format, uint32_t texture_format);
+   // The magic, version, source information, and offsets of the header are filled here.
+   [[nodiscard]] bool write(Header header, const void* vertex_data, const GLuint* index_data) const;
+   [[nodiscard]] const Header& getHeader() const { return *reinterpret_cast<const Header*>(File.getData()); }
+   [[nodiscard]] const void* getVertexData() const { return File.getData() + getHeader().VertexOffset; }
+   [[nodiscard]] const GLuint* getIndexData() const
+   {
+      return reinterpret_cast<const GLuint*>(File.getData() + getHeader().IndexOffset);
+   }
+
+private:
+   inline static constexpr std::array<char, 4> Magic = { 'C', 'M', 'S', 'H' };
+   inline static constexpr uint32_t Version = 1;
+   inline static constexpr uint64_t VertexAlignment = 4096;
+   inline static constexpr uint64_t IndexAlignment = 256;
+};
\ No newline at end of file
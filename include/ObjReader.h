@@ -0,0 +1,71 @@
+#pragma once
+
+#include "_Common.h"
+
+class ObjReader final
+{
+public:
+   // The indices are 0-based and already resolved, and -1 means that the face does not have the attribute.
+   struct Corner
+   {
+      int Position;
+      int Texture;
+      int Normal;
+
+      Corner() : Position( -1 ), Texture( -1 ), Normal( -1 ) {}
+   };
+
+   // The corners of an 'o' or 'g' block, which are triangulated, so CornerNum is a multiple of 3.
+   struct Group
+   {
+      std::string Name;
+      size_t FirstCorner;
+      size_t CornerNum;
+
+      Group(std::string name, size_t first_corner) :
+         Name( std::move( name ) ), FirstCorner( first_corner ), CornerNum( 0 ) {}
+   };
+
+   ObjReader() = default;
+   ~ObjReader() = default;
+
+   // The file is memory-mapped and split into chunks at the line breaks, which are parsed in parallel.
+   // The polygons are fan-triangulated, and the negative indices are resolved after all chunks are parsed.
+   [[nodiscard]] bool read(const std::string& file_path, int thread_num = 0);
+   [[nodiscard]] const std::vector<glm::vec3>& getPositions() const { return Positions; }
+   [[nodiscard]] const std::vector<glm::vec2>& getTextures() const { return Textures; }
+   [[nodiscard]] const std::vector<glm::vec3>& getNormals() const { return Normals; }
+   [[nodiscard]] const std::vector<Corner>& getCorners() const { return Corners; }
+   [[nodiscard]] const std::vector<Group>& getGroups() const { return Groups; }
+
+private:
+   enum RelativeFlag : uint8_t { RelativePosition = 1, RelativeTexture = 2, RelativeNormal = 4 };
+
+   struct Chunk
+   {
+      bool Valid;
+      std::vector<glm::vec3> Positions;
+      std::vector<glm::vec2> Textures;
+      std::vector<glm::vec3> Normals;
+      std::vector<Corner> Corners;
+      std::vector<std::pair<size_t, uint8_t>> RelativeCorners; // <corner index, relative flags>
+      std::vector<Group> Groups;
+
+      Chunk() : Valid( true ) {}
+   };
+
+   inline static constexpr size_t MinChunkSize = 1 << 20;
+
+   std::vector<glm::vec3> Positions;
+   std::vector<glm::vec2> Textures;
+   std::vector<glm::vec3> Normals;
+   std::vector<Corner> Corners;
+   std::vector<Group> Groups;
+
+   [[nodiscard]] static bool isSpace(char c);
+   [[nodiscard]] static const char* skipSpaces(const char* ptr, const char* end);
+   static const char* parseFloat(const char* ptr, const char* end, float& value);
+   static const char* parseIndex(const char* ptr, const char* end, int& value, bool& exists);
+   static void parseChunk(const char* begin, const char* end, Chunk& chunk);
+   [[nodiscard]] bool mergeChunks(std::vector<Chunk>& chunks);
+};
\ No newline at end of file
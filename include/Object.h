@@ -1,20 +1,66 @@
 #pragma once
 
 #include "Shader.h"
+#include "MeshCache.h"
+#include "TextureCache.h"
+#include "VertexLayout.h"
+#include "GPUMemory.h"
 
 class ObjectGL
 {
 public:
    enum LayoutLocation { VertexLoc = 0, NormalLoc, TextureLoc };
+   enum class PositionFormat { Float32 = 0, Unorm16 };
+   enum class NormalFormat { Float32 = 0, Snorm10_10_10_2, Octahedral16 };
+   enum class TextureFormat { Float32 = 0, HalfFloat16, Unorm16 };
+
+   // The packed vertices and indices of an obj file, which are mapped from the cache if it is valid.
+   struct MeshData
+   {
+      MeshCache::Header Header;
+      std::unique_ptr<MeshCache> Cache;
+      std::vector<GLuint> Vertices; // the 32-bit words of the interleaved vertices, which are packed if not Float32
+      std::vector<GLuint> Indices;
+
+      [[nodiscard]] const void* getVertexData() const { return Cache ? Cache->getVertexData() : Vertices.data(); }
+      [[nodiscard]] const GLuint* getIndexData() const { return Cache ? Cache->getIndexData() : Indices.data(); }
+      [[nodiscard]] size_t getVertexDataSize() const
+      {
+         return static_cast<size_t>(Header.VertexNum) * Header.BytesPerVertex;
+      }
+   };
+
+   // The compressed mip levels of an image, which point into the cache if it is valid, or into Levels otherwise.
+   struct TextureData
+   {
+      GLenum InternalFormat;
+      int Width;
+      int Height;
+      std::unique_ptr<TextureCache> Cache;
+      std::vector<std::vector<uint8_t>> Levels;
+      std::vector<std::pair<const uint8_t*, size_t>> LevelData;
+
+      TextureData() : InternalFormat( 0 ), Width( 0 ), Height( 0 ) {}
+   };
 
    ObjectGL();
    ~ObjectGL();
 
+   // It owns the GL objects of the object in GPUMemoryGL and names them in the debuggers, so it should be set first.
+   void setName(const std::string& name) { Name = name; }
+
    void setEmissionColor(const glm::vec4& emission_color);
    void setAmbientReflectionColor(const glm::vec4& ambient_reflection_color);
    void setDiffuseReflectionColor(const glm::vec4& diffuse_reflection_color);
    void setSpecularReflectionColor(const glm::vec4& specular_reflection_color);
    void setSpecularReflectionExponent(const float& specular_reflection_exponent);
+   // The packed formats are only for the objects set with normals and textures, which are rendered but not simulated.
+   // Unorm16 positions are quantized in the bounding box of the object, and Unorm16 textures should be in [0, 1].
+   void setVertexFormat(
+      PositionFormat position_format,
+      NormalFormat normal_format,
+      TextureFormat texture_format
+   );
    void setObject(GLenum draw_mode, const std::vector<glm::vec3>& vertices);
    void setObject(
       GLenum draw_mode,
@@ -42,21 +88,34 @@ public:
       const std::string& texture_file_path,
       bool is_grayscale = false
    );
+   // The parsed mesh is cached in the build directory for each vertex format, and it is mapped from there
+   // instead of parsing the obj file again until the obj file is modified.
    void setObject(
       GLenum draw_mode, 
       const std::string& obj_file_path, 
       const std::string& texture_file_name
    );
+   // With upload_data false, the buffers are only allocated to be filled later, e.g. by copying from a staging buffer.
+   void setObject(GLenum draw_mode, const MeshData& mesh, bool upload_data = true);
    void setSquareObject(GLenum draw_mode, bool use_texture = true);
    void setSquareObject(
       GLenum draw_mode,
       const std::string& texture_file_path,
       bool is_grayscale = false
    );
+   // The image is compressed to BC7, or BC4 if it is grayscale, with all mip levels when it is added for the first
+   // time, and it is cached in the build directory, so the image is not decoded again until the file is modified.
    int addTexture(const std::string& texture_file_path, bool is_grayscale = false);
    void addTexture(int width, int height, bool is_grayscale = false);
    int addTexture(const uint8_t* image_buffer, int width, int height, bool is_grayscale = false);
-   void setElementBuffer(std::vector<GLuint>& indices) const;
+   // The previous texture at the index is deleted, and the object owns the new one.
+   void setTexture(int index, GLuint texture_id);
+   // They do not call any GL function, so they can run in another thread while the object is not in use.
+   [[nodiscard]] bool loadMesh(MeshData& mesh, const std::string& obj_file_path) const;
+   [[nodiscard]] static bool loadTexture(TextureData& texture, const std::string& texture_file_path, bool is_grayscale);
+   [[nodiscard]] static GLuint createTexture(const TextureData& texture, bool upload_data = true);
+   void setElementBuffer(std::vector<GLuint>& indices);
+   void setElementBuffer(const GLuint* indices, GLsizei index_num);
    void transferUniformsToShader(const ShaderGL* shader);
    void updateDataBuffer(const std::vector<glm::vec3>& vertices, const std::vector<glm::vec3>& normals);
    void updateDataBuffer(
@@ -66,13 +125,20 @@ public:
    );
    void replaceVertices(const std::vector<glm::vec3>& vertices, bool normals_exist, bool textures_exist);
    void replaceVertices(const std::vector<float>& vertices, bool normals_exist, bool textures_exist);
+   // The vertices are the tightly packed xyz of each vertex, which only overwrite the positions in the buffer.
+   void replaceVertices(const GLfloat* vertices, size_t vertex_num, bool normals_exist, bool textures_exist);
    [[nodiscard]] GLuint getVAO() const { return VAO; }
+   [[nodiscard]] GLuint getVBO() const { return VBO; }
+   [[nodiscard]] GLuint getIBO() const { return IBO; }
    [[nodiscard]] GLenum getDrawMode() const { return DrawMode; }
    [[nodiscard]] GLsizei getVertexNum() const { return VerticesCount; }
+   [[nodiscard]] GLsizei getIndexNum() const { return IndicesCount; }
    [[nodiscard]] GLuint getTextureID(int index) const { return TextureID[index]; }
    [[nodiscard]] int getTextureNum() const { return static_cast<int>(TextureID.size()); }
+   [[nodiscard]] const glm::vec4& getBoundingSphere() const { return BoundingSphere; }
+   // The vertices are moved into the buffers of the simulation, and the vertex array keeps only the element buffer.
    void prepareShaderStorageBuffer();
-   [[nodiscard]] GLuint getShaderStorageBuffer(int buffer_index) { return ShaderStorageBufferObjects[buffer_index]; }
+   [[nodiscard]] GLuint getShaderStorageBuffer(int buffer_index) const { return ShaderStorageBufferObjects[buffer_index]; }
 
    template<typename T>
    void addShaderStorageBufferObject(const std::string& name, GLuint binding_index, int data_size)
@@ -81,6 +147,7 @@ public:
       glCreateBuffers( 1, &buffer );
       glBindBufferBase( GL_SHADER_STORAGE_BUFFER, binding_index, buffer );
       glBufferStorage( GL_SHADER_STORAGE_BUFFER, sizeof( T ) * data_size, nullptr, GL_DYNAMIC_DRAW );
+      GPUMemoryGL::addBuffer( buffer, GPUMemoryGL::Category::Storage, sizeof( T ) * data_size, Name, name );
       CustomBuffers[name] = buffer;
    }
 
@@ -96,6 +163,7 @@ public:
       glCreateBuffers( 1, &buffer );
       glBindBuffer( target, buffer );
       glBufferStorage( target, sizeof( T ) * data.size(), data.data(), usage );
+      GPUMemoryGL::addBuffer( buffer, getBufferCategory( target ), sizeof( T ) * data.size(), Name, name );
       CustomBuffers[name] = buffer;
    }
 
@@ -109,15 +177,24 @@ public:
    }
 
 private:
+   std::string Name;
    uint8_t* ImageBuffer;
-   std::vector<GLfloat> DataBuffer;
+   std::vector<GLfloat> DataBuffer; // the interleaved vertices of Float32, which is empty for the packed formats
    GLuint VAO;
    GLuint VBO;
+   GLuint IBO;
    GLenum DrawMode;
    std::vector<GLuint> TextureID;
    std::map<std::string, GLuint> CustomBuffers;
    std::vector<GLuint> ShaderStorageBufferObjects;
    GLsizei VerticesCount;
+   GLsizei IndicesCount;
+   PositionFormat VertexPositionFormat;
+   NormalFormat VertexNormalFormat;
+   TextureFormat VertexTextureFormat;
+   glm::vec3 PositionScale;
+   glm::vec3 PositionOffset;
+   glm::vec4 BoundingSphere; // (center, radius) in the object coordinate
    glm::vec4 EmissionColor;
    glm::vec4 AmbientReflectionColor; // It is usually set to the same color with DiffuseReflectionColor.
                                      // Otherwise, it should be in balance with DiffuseReflectionColor.
@@ -125,19 +202,57 @@ private:
    glm::vec4 SpecularReflectionColor;
    float SpecularReflectionExponent;
 
-   [[nodiscard]] bool prepareTexture2DUsingFreeImage(const std::string& file_path, bool is_grayscale) const;
+   [[nodiscard]] static bool readImageUsingFreeImage(
+      std::vector<uint8_t>& image,
+      int& width,
+      int& height,
+      const std::string& file_path,
+      bool is_grayscale
+   );
+   [[nodiscard]] bool isFloatVertexFormat() const;
+   [[nodiscard]] static GPUMemoryGL::Category getBufferCategory(GLenum target);
+   [[nodiscard]] static int getPositionSize(PositionFormat format);
+   [[nodiscard]] static int getNormalSize(NormalFormat format);
+   [[nodiscard]] static int getTextureSize(TextureFormat format);
+   [[nodiscard]] static glm::vec2 encodeOctahedralNormal(const glm::vec3& normal);
+   static void pushComponents(std::vector<GLuint>& data, const GLfloat* components, int component_num);
+   void packDataBuffer(
+      std::vector<GLuint>& data,
+      glm::vec3& position_scale,
+      glm::vec3& position_offset,
+      const std::vector<glm::vec3>& vertices,
+      const std::vector<glm::vec3>& normals,
+      const std::vector<glm::vec2>& textures
+   ) const;
    void prepareTexture(bool normals_exist) const;
    void prepareVertexBuffer(int n_bytes_per_vertex);
+   void prepareVertexBuffer(int n_bytes_per_vertex, const void* data, size_t size);
    void prepareNormal() const;
+   [[nodiscard]] static glm::vec4 calculateBoundingSphere(
+      const GLfloat* data,
+      size_t vertex_num,
+      int n_floats_per_vertex,
+      PositionFormat position_format,
+      const glm::vec3& position_scale,
+      const glm::vec3& position_offset
+   );
    static void getSquareObject(
       std::vector<glm::vec3>& vertices,
       std::vector<glm::vec3>& normals,
       std::vector<glm::vec2>& textures
    );
+   static void optimizeVertexCache(std::vector<GLuint>& indices, size_t vertex_num);
+   static void reorderVertices(
+      std::vector<glm::vec3>& vertices,
+      std::vector<glm::vec3>& normals,
+      std::vector<glm::vec2>& textures,
+      std::vector<GLuint>& indices
+   );
    bool readObjectFile(
       std::vector<glm::vec3>& vertices, 
       std::vector<glm::vec3>& normals, 
       std::vector<glm::vec2>& textures, 
+      std::vector<GLuint>& indices,
       const std::string& file_path
    ) const;
 };
\ No newline at end of file
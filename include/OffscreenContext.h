@@ -0,0 +1,43 @@
+#pragma once
+
+#include "GPUMemory.h"
+
+// It makes an OpenGL 4.6 context current without showing a window, for the tools that render nothing on screen and
+// for the headless renderer. EGL needs no display server, so it is tried first on Linux, where it runs on the render
+// nodes of a GPU and on Mesa without any GPU. A hidden GLFW window is the fallback and the only backend on Windows.
+class OffscreenContextGL final
+{
+public:
+   enum class Backend { None = 0, EGL, HiddenWindow };
+
+   OffscreenContextGL(const OffscreenContextGL&) = delete;
+   OffscreenContextGL(const OffscreenContextGL&&) = delete;
+   OffscreenContextGL& operator=(const OffscreenContextGL&) = delete;
+   OffscreenContextGL& operator=(const OffscreenContextGL&&) = delete;
+
+   OffscreenContextGL();
+   ~OffscreenContextGL();
+
+   // It returns false if no context can be created, and then the GL functions must not be called.
+   [[nodiscard]] bool create();
+   // The context has no default framebuffer, so this one takes its place and stays bound for drawing and reading.
+   [[nodiscard]] bool createFramebuffer(int width, int height);
+   void destroy();
+   [[nodiscard]] bool isCreated() const { return ContextBackend != Backend::None; }
+   [[nodiscard]] Backend getBackend() const { return ContextBackend; }
+   [[nodiscard]] const std::string& getRenderer() const { return Renderer; }
+   [[nodiscard]] GLuint getFramebuffer() const { return Framebuffer; }
+
+private:
+   Backend ContextBackend;
+   GLFWwindow* Window;
+   void* Display;
+   void* Context;
+   GLuint Framebuffer;
+   std::array<GLuint, 2> Renderbuffers; // the color and the depth-stencil
+   std::string Renderer;
+
+   [[nodiscard]] bool createEGLContext();
+   [[nodiscard]] bool createWindowContext();
+   void destroyEGLContext();
+};
\ No newline at end of file
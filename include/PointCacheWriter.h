@@ -0,0 +1,42 @@
+#pragma once
+
+#include "_Common.h"
+
+// It writes the positions of every frame into a PC2 point cache, which the DCC tools read as a baked animation.
+// PC2 has the sample number in the header, so it is rewritten when the cache is closed.
+class PointCacheWriter final
+{
+public:
+   PointCacheWriter(const PointCacheWriter&) = delete;
+   PointCacheWriter(const PointCacheWriter&&) = delete;
+   PointCacheWriter& operator=(const PointCacheWriter&) = delete;
+   PointCacheWriter& operator=(const PointCacheWriter&&) = delete;
+
+   PointCacheWriter();
+   ~PointCacheWriter();
+
+   [[nodiscard]] bool open(const std::string& file_path, int point_num, float start_frame = 0.0f, float sample_rate = 1.0f);
+   // The positions are the first three floats of each point, and the points are stride floats apart.
+   void addFrame(const float* points, int stride);
+   void close();
+   [[nodiscard]] bool isOpen() const { return File.is_open(); }
+   [[nodiscard]] int getFrameNum() const { return Header.SampleNum; }
+
+private:
+   // It is the header of PC2 in little endian, which has no padding.
+   struct PC2Header
+   {
+      std::array<char, 12> Signature;
+      int32_t FileVersion;
+      int32_t PointNum;
+      float StartFrame;
+      float SampleRate;
+      int32_t SampleNum;
+   };
+
+   inline static constexpr std::array<char, 12> Signature = { 'P', 'O', 'I', 'N', 'T', 'C', 'A', 'C', 'H', 'E', '2', '\0' };
+
+   PC2Header Header;
+   std::ofstream File;
+   std::vector<float> Positions;
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "_Common.h"
+
+// The codec of the recorded cloth, which encodes a chunk of consecutive frames of the same points.
+// The positions are quantized in the bounding box of the chunk, predicted from the neighbor point in the first frame
+// and from the previous frames in the others, and the residuals are Rice-coded.
+// The residuals are lossless in the quantized space, so the error does not accumulate over the frames.
+class PointCodec final
+{
+public:
+   inline static constexpr int QuantizationBits = 16;
+
+   PointCodec() = default;
+   ~PointCodec() = default;
+
+   // The positions are stored frame by frame, and each frame has point_num positions.
+   static void encodeChunk(std::vector<uint8_t>& encoded, const std::vector<glm::vec3>& positions, int point_num);
+   [[nodiscard]] static bool decodeChunk(
+      std::vector<glm::vec3>& positions,
+      const uint8_t* encoded,
+      size_t size,
+      int point_num,
+      int frame_num
+   );
+
+private:
+   inline static constexpr int RiceBlockSize = 64;
+   inline static constexpr uint32_t EscapeQuotient = 16;
+   inline static constexpr uint32_t QuantizedMax = (1u << QuantizationBits) - 1;
+
+   struct BitWriter
+   {
+      std::vector<uint8_t>& Bytes;
+      uint64_t Bits;
+      int BitNum;
+
+      explicit BitWriter(std::vector<uint8_t>& bytes) : Bytes( bytes ), Bits( 0 ), BitNum( 0 ) {}
+
+      void write(uint32_t value, int bit_num);
+      void flush();
+   };
+
+   struct BitReader
+   {
+      const uint8_t* Bytes;
+      size_t Size;
+      size_t Position;
+      uint64_t Bits;
+      int BitNum;
+
+      BitReader(const uint8_t* bytes, size_t size) : Bytes( bytes ), Size( size ), Position( 0 ), Bits( 0 ), BitNum( 0 ) {}
+
+      [[nodiscard]] bool read(uint32_t& value, int bit_num);
+   };
+
+   [[nodiscard]] static int getPrediction(const std::vector<uint32_t>& quantized, int point_num, int frame, int index);
+   [[nodiscard]] static int getRiceParameter(const uint32_t* values, int value_num);
+};
\ No newline at end of file
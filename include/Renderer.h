@@ -9,6 +9,20 @@
 #include "_Common.h"
 #include "Light.h"
 #include "Object.h"
+#include "IndirectDraw.h"
+#include "AssetLoader.h"
+#include "BufferReadback.h"
+#include "SimulationPlayer.h"
+#include "PointCacheWriter.h"
+#include "ClothCheckpoint.h"
+#include "FrameCapture.h"
+#include "GPUProfiler.h"
+#include "ZoneProfiler.h"
+#include "OffscreenContext.h"
+#include "SceneFile.h"
+#include "ClothStatistics.h"
+#include "TextOverlay.h"
+#include "FramePacer.h"
 
 class RendererGL
 {
@@ -19,32 +33,121 @@ public:
    RendererGL& operator=(const RendererGL&&) = delete;
 
 
-   RendererGL();
+   // The headless renderer draws into a framebuffer of the frame size without any window, so it needs no display.
+   explicit RendererGL(bool headless = false, int frame_width = 1920, int frame_height = 1080);
    ~RendererGL() = default;
 
-   void play();
+   // It runs until the window is closed, or only for the frame limit if it is positive, which the headless one needs.
+   // It returns false if the scene cannot be set, e.g. when it exceeds the GPU memory budget.
+   [[nodiscard]] bool play();
+   [[nodiscard]] bool isInitialized() const { return Headless ? HeadlessContext->isCreated() : Window != nullptr; }
+   // It runs only the solver as fast as possible without drawing, and writes the cloth into a PC2 point cache.
+   [[nodiscard]] bool bake(int frame_num, const std::string& point_cache_path);
+   // The simulation starts from the checkpoint instead of the flat cloth.
+   void setWarmStart(const std::string& checkpoint_path) { WarmStartPath = checkpoint_path; }
+   void setCaptureFormat(FrameCaptureGL::CaptureFormat format) { CaptureFormat = format; }
+   void setCaptureOnStart(bool capture) { CaptureOnStart = capture; }
+   void setFrameLimit(int frame_num) { FrameLimit = frame_num; }
+   // The scene is built when it plays or bakes, so it has to be set before them.
+   void setSceneDescription(const SceneDescription& scene);
+   // The cloth is drawn as the tessellated surface, whose edges are refined to about the given pixels on the screen,
+   // and a length that is not positive keeps the one of the scene.
+   void setTessellation(float edge_length)
+   {
+      UseTessellation = true;
+      if (edge_length > 0.0f) TessellationEdgeLength = edge_length;
+   }
+   // The GPU time of each pass is measured, summarized at exit, and written into the CSV file if it is given.
+   void setGPUProfile(const std::string& csv_path)
+   {
+      GPUProfiler->setEnabled( true );
+      GPUProfilePath = csv_path;
+   }
+   // The GPU memory of each category is reported at exit, and the scene is refused if it exceeds a positive budget.
+   void setGPUMemoryReport(int64_t budget)
+   {
+      GPUMemoryReport = true;
+      GPUMemoryGL::setBudget( budget );
+   }
+   // The solver counts its work of each step, which is shown on the overlay and written into the CSV file if it is given.
+   void setStatistics(const std::string& csv_path)
+   {
+      UseStatistics = true;
+      ShowOverlay = true;
+      StatisticsPath = csv_path;
+   }
+   // The pacing and the frames in flight apply only to play, as bake runs the solver as fast as possible.
+   void setFramePacing(FramePacerGL::PacingMode mode, double target_rate = 60.0) { Pacer->setMode( mode, target_rate ); }
+   void setFramesInFlight(int frame_num) { Pacer->setFramesInFlight( frame_num ); }
+   // It is null unless the statistics are enabled, and the counters of a step arrive a few frames after it.
+   [[nodiscard]] const ClothStatisticsGL* getClothStatistics() const { return UseStatistics ? Statistics.get() : nullptr; }
 
 private:
    inline static RendererGL* Renderer = nullptr;
+   inline static constexpr GLuint ClothPointsBinding = 5;
+   inline static constexpr int ClothWorkGroupSize = 16;
+   inline static constexpr int ClothPointStride = 8; // the floats of Attributes in the shaders
+   inline static constexpr int CaptureFPS = 60;
+   bool UseTessellation;
+   bool Headless;
+   bool CaptureOnStart;
+   bool GPUMemoryReport;
+   bool UseStatistics;
+   bool ShowOverlay;
+   int FrameLimit;
    GLFWwindow* Window;
    int FrameWidth;
    int FrameHeight;
    glm::ivec2 ClickedPoint;
    uint ClothTargetIndex;
+   int ClothDrawIndex;
+   int ClothPatchDrawIndex;
+   int SphereDrawIndex;
    glm::ivec2 ClothPointNumSize;
-   glm::ivec2 ClothGridSize;
+   glm::vec2 ClothGridSize;
    glm::vec3 SpherePosition;
    float SphereRadius;
+   bool UseSphereCollider;
+   float TessellationEdgeLength;
    glm::mat4 ClothWorldMatrix;
    glm::mat4 SphereWorldMatrix;
+   ClothParameters ClothPhysics;
+   glm::vec4 LightPosition;
+   glm::vec4 LightAmbientColor;
+   glm::vec4 LightDiffuseColor;
+   glm::vec4 LightSpecularColor;
+   std::string WarmStartPath;
+   std::string GPUProfilePath;
+   std::string StatisticsPath;
+   FrameCaptureGL::CaptureFormat CaptureFormat;
+   double FrameTime; // the smoothed one in milliseconds
+   int PlaybackFrame;
+   std::vector<GLfloat> PlaybackPoints;
+   // It is the first of the GL objects, so it is destroyed after all the others.
+   std::unique_ptr<OffscreenContextGL> HeadlessContext;
    std::unique_ptr<CameraGL> MainCamera;
    std::unique_ptr<ShaderGL> ObjectShader;
+   std::unique_ptr<ShaderGL> ClothShader;
+   std::unique_ptr<ShaderGL> ClothSurfaceShader;
    std::unique_ptr<ObjectGL> ClothObject;
    std::unique_ptr<ObjectGL> SphereObject;
    std::unique_ptr<LightGL> Lights;
+   std::unique_ptr<IndirectDrawGL> IndirectDraws;
+   std::unique_ptr<AssetLoaderGL> AssetLoader;
+   std::unique_ptr<SimulationRecorder> Recorder;
+   std::unique_ptr<SimulationPlayer> Player;
+   std::unique_ptr<PointCacheWriter> PointCache;
+   std::unique_ptr<BufferReadbackGL> ClothReadback;
+   std::unique_ptr<FrameCaptureGL> Capture;
+   std::unique_ptr<GPUProfilerGL> GPUProfiler;
+   std::unique_ptr<ClothStatisticsGL> Statistics;
+   std::unique_ptr<TextOverlayGL> Overlay;
+   std::unique_ptr<FramePacerGL> Pacer;
  
    void registerCallbacks() const;
-   void initialize();
+   [[nodiscard]] bool initialize();
+   [[nodiscard]] bool createWindow();
+   [[nodiscard]] bool shouldClose(int frame_index) const;
 
    static void printOpenGLInformation();
 
@@ -64,11 +167,39 @@ private:
    static void reshapeWrapper(GLFWwindow* window, int width, int height);
 
    void setLights() const;
+   void setComputeShaders() const;
    void setClothObject() const;
-   void setSphereObject() const;
+   void setSphereObject();
    void setClothPhysicsVariables() const;
+   void setCullingVariables() const;
+   void setClothShaderVariables() const;
+   void setIndirectDraws();
+   [[nodiscard]] glm::vec4 getSphereBoundingSphere() const;
+   [[nodiscard]] GLuint getNewestClothBuffer() const;
+   [[nodiscard]] bool setScene();
+   [[nodiscard]] static std::string getRecordingPath();
+   [[nodiscard]] static std::string getPointCachePath();
+   [[nodiscard]] int getClothPointNum() const { return ClothPointNumSize.x * ClothPointNumSize.y; }
+   [[nodiscard]] glm::ivec2 getClothWorkGroupNum() const
+   {
+      return (ClothPointNumSize + ClothWorkGroupSize - 1) / ClothWorkGroupSize;
+   }
+   [[nodiscard]] static std::string getCheckpointPath();
+   void saveCheckpoint() const;
+   bool loadCheckpoint(const std::string& checkpoint_path);
+   void prepareClothReadback();
+   void toggleRecording();
+   void togglePointCacheExport();
+   void togglePlayback();
+   void toggleFrameCapture();
+   void playRecording();
    void applyForces();
+   void cullObjects() const;
    void drawClothObject() const;
    void drawSphereObject() const;
+   void drawOverlay() const;
    void render();
+   void reportGPUProfile() const;
+   void reportGPUMemory() const;
+   void reportStatistics() const;
 };
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ClothParameters.h"
+
+// Everything of the scene the renderer and the batch runner can change, whose defaults are the scene of the renderer.
+struct SceneDescription
+{
+   ClothSetup Cloth;
+   ClothParameters Physics;
+   glm::vec4 LightPosition;
+   glm::vec4 LightAmbientColor;
+   glm::vec4 LightDiffuseColor;
+   glm::vec4 LightSpecularColor;
+   // The tessellated surface lets a coarse grid of the solver look smooth, as its patches are refined until an edge is
+   // about TessellationEdgeLength pixels long on the screen.
+   bool UseTessellation;
+   float TessellationEdgeLength;
+
+   SceneDescription() :
+      LightPosition( 30.0f, 500.0f, 30.0f, 1.0f ), LightAmbientColor( 1.0f, 1.0f, 1.0f, 1.0f ),
+      LightDiffuseColor( 0.7f, 0.7f, 0.7f, 1.0f ), LightSpecularColor( 0.9f, 0.9f, 0.9f, 1.0f ),
+      UseTessellation( false ), TessellationEdgeLength( 8.0f ) {}
+};
+
+// A scene file has a setting on each line, which is a keyword and its numbers as in an OBJ file, and '#' starts a
+// comment. The settings missing in the file keep their defaults, so a file of a few lines is a variant of the default
+// scene. The cloth and the sphere are placed only by the translations of their world matrices.
+class SceneFile final
+{
+public:
+   SceneFile() = delete;
+
+   [[nodiscard]] static bool read(const std::string& file_path, SceneDescription& scene);
+   // Every setting is written, so the file keeps the scene even if the defaults change later.
+   [[nodiscard]] static bool write(const std::string& file_path, const SceneDescription& scene);
+   // It applies a line of a scene file, and returns false if the keyword is unknown or its numbers do not fit.
+   [[nodiscard]] static bool set(SceneDescription& scene, const std::string& line);
+   // It tells why the scene cannot be simulated, and it is empty if the scene is valid.
+   [[nodiscard]] static std::string getError(const SceneDescription& scene);
+
+private:
+   // Exactly one of the pointers is not null, which points to the first of the values.
+   struct Setting
+   {
+      const char* Keyword;
+      int ValueNum;
+      float* Floats;
+      int* Integers;
+      bool* Flag;
+   };
+
+   [[nodiscard]] static std::vector<Setting> getSettings(SceneDescription& scene);
+};
\ No newline at end of file
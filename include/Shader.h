@@ -2,10 +2,15 @@
 
 #include "_Common.h"
 #include "Camera.h"
+#include "ZoneProfiler.h"
+#include "AtomicFile.h"
 
 class ShaderGL
 {
 public:
+   // The name and value of each #define injected right after #version, which makes a variant of the program.
+   using DefineSet = std::map<std::string, std::string>;
+
    struct LightLocationSet
    {
       GLint LightSwitch, LightPosition;
@@ -23,24 +28,35 @@ public:
       GLint MaterialEmission, MaterialAmbient, MaterialDiffuse, MaterialSpecular, MaterialSpecularExponent;
       std::map<GLint, GLint> Texture; // <binding point, texture id>
       GLint UseTexture, UseLight, LightNum, GlobalAmbient;
+      GLint PositionScale, PositionOffset, OctahedralNormal;
       std::vector<LightLocationSet> Lights;
 
       LocationSet() : World( 0 ), View( 0 ), Projection( 0 ), ModelViewProjection( 0 ), MaterialEmission( 0 ),
       MaterialAmbient( 0 ), MaterialDiffuse( 0 ), MaterialSpecular( 0 ), MaterialSpecularExponent( 0 ),
-      UseTexture( 0 ), UseLight( 0 ), LightNum( 0 ), GlobalAmbient( 0 ) {}
+      UseTexture( 0 ), UseLight( 0 ), LightNum( 0 ), GlobalAmbient( 0 ), PositionScale( 0 ), PositionOffset( 0 ),
+      OctahedralNormal( 0 ) {}
    };
 
    ShaderGL();
    virtual ~ShaderGL();
 
+   // The linked programs are cached in the build directory as the driver's binaries, which are keyed by the sources
+   // and the driver, and the shaders are compiled only if the binary is missing or rejected by the driver.
+   // The sources are preprocessed first: #include "path" is resolved relative to the including file,
+   // and the defines are injected, so the variants of the same files are cached separately.
    void setShader(
       const char* vertex_shader_path,
       const char* fragment_shader_path,
       const char* geometry_shader_path = nullptr,
       const char* tessellation_control_shader_path = nullptr,
-      const char* tessellation_evaluation_shader_path = nullptr
+      const char* tessellation_evaluation_shader_path = nullptr,
+      const DefineSet& defines = {}
+   );
+   // The i-th define set is for the i-th compute shader, and the shaders without it are not specialized.
+   void setComputeShaders(
+      const std::vector<const char*>& compute_shader_paths,
+      const std::vector<DefineSet>& defines = {}
    );
-   void setComputeShaders(const std::vector<const char*>& compute_shader_paths);
    void setUniformLocations(int light_num);
    void addUniformLocation(const std::string& name);
    void addUniformLocationToComputeShader(const std::string& name, int shader_index);
@@ -53,6 +69,9 @@ public:
    [[nodiscard]] GLint getMaterialDiffuseLocation() const { return Location.MaterialDiffuse; }
    [[nodiscard]] GLint getMaterialSpecularLocation() const { return Location.MaterialSpecular; }
    [[nodiscard]] GLint getMaterialSpecularExponentLocation() const { return Location.MaterialSpecularExponent; }
+   [[nodiscard]] GLint getPositionScaleLocation() const { return Location.PositionScale; }
+   [[nodiscard]] GLint getPositionOffsetLocation() const { return Location.PositionOffset; }
+   [[nodiscard]] GLint getOctahedralNormalLocation() const { return Location.OctahedralNormal; }
    [[nodiscard]] GLint getLightAvailabilityLocation() const { return Location.UseLight; }
    [[nodiscard]] GLint getLightNumLocation() const { return Location.LightNum; }
    [[nodiscard]] GLint getGlobalAmbientLocation() const { return Location.GlobalAmbient; }
@@ -94,14 +113,40 @@ public:
    }
 
 protected:
+   using ShaderSource = std::pair<GLenum, std::string>;
+
+   struct ProgramCacheHeader
+   {
+      std::array<char, 4> Magic;
+      uint32_t Version;
+      GLenum Format;
+      uint32_t Length;
+   };
+
+   inline static constexpr std::array<char, 4> ProgramCacheMagic = { 'C', 'P', 'R', 'G' };
+   inline static constexpr uint32_t ProgramCacheVersion = 1;
+
    GLuint ShaderProgram;
+   std::unordered_map<uint64_t, GLuint> Programs; // every variant linked so far, keyed by getProgramKey()
    LocationSet Location;
    std::unordered_map<std::string, GLint> CustomLocations;
    std::vector<GLuint> ComputeShaderPrograms;
 
-   static void readShaderFile(std::string& shader_contents, const char* shader_path);
+   [[nodiscard]] static bool readShaderFile(std::string& shader_contents, const char* shader_path);
+   [[nodiscard]] static bool preprocess(
+      std::string& shader_contents,
+      const std::filesystem::path& shader_path,
+      const DefineSet& defines,
+      std::vector<std::string>& included_paths
+   );
    [[nodiscard]] static std::string getShaderTypeString(GLenum shader_type);
    [[nodiscard]] static bool checkCompileError(GLenum shader_type, const GLuint& shader);
-   [[nodiscard]] static GLuint getCompiledShader(GLenum shader_type, const char* shader_path);
+   [[nodiscard]] static bool checkLinkError(const GLuint& program);
+   [[nodiscard]] static GLuint getCompiledShader(GLenum shader_type, const std::string& shader_contents);
+   [[nodiscard]] static uint64_t getProgramKey(const std::vector<ShaderSource>& sources);
+   [[nodiscard]] static std::string getProgramCachePath(uint64_t key);
+   [[nodiscard]] static bool loadProgramBinary(GLuint program, const std::string& cache_path);
+   static void saveProgramBinary(GLuint program, const std::string& cache_path);
+   [[nodiscard]] GLuint getProgram(const std::vector<ShaderSource>& sources);
    void setBasicTransformationUniforms();
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "SimulationRecorder.h"
+
+// It plays a recording of SimulationRecorder back without the solver.
+// A frame is found by the chunk index, and the decoded chunk is kept, so the sequential playback decodes
+// each chunk only once.
+class SimulationPlayer final
+{
+public:
+   SimulationPlayer(const SimulationPlayer&) = delete;
+   SimulationPlayer(const SimulationPlayer&&) = delete;
+   SimulationPlayer& operator=(const SimulationPlayer&) = delete;
+   SimulationPlayer& operator=(const SimulationPlayer&&) = delete;
+
+   SimulationPlayer();
+   ~SimulationPlayer() = default;
+
+   [[nodiscard]] bool open(const std::string& file_path);
+   void close();
+   [[nodiscard]] int getPointNum() const { return isOpen() ? static_cast<int>(getHeader().PointNum) : 0; }
+   [[nodiscard]] int getFrameNum() const { return isOpen() ? static_cast<int>(getHeader().FrameNum) : 0; }
+   [[nodiscard]] bool isOpen() const { return File.isOpen(); }
+   // It returns the point_num positions of the frame, which are valid until the next call.
+   [[nodiscard]] const glm::vec3* getFrame(int frame_index);
+
+private:
+   int DecodedChunkIndex;
+   std::vector<glm::vec3> DecodedPositions;
+   MappedFile File;
+
+   [[nodiscard]] const SimulationRecorder::Header& getHeader() const
+   {
+      return *reinterpret_cast<const SimulationRecorder::Header*>(File.getData());
+   }
+   [[nodiscard]] const SimulationRecorder::ChunkEntry& getChunkEntry(int chunk_index) const
+   {
+      return reinterpret_cast<const SimulationRecorder::ChunkEntry*>(File.getData() + getHeader().IndexOffset)[chunk_index];
+   }
+};
\ No newline at end of file
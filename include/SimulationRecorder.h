@@ -0,0 +1,68 @@
+#pragma once
+
+#include "PointCodec.h"
+#include "ZoneProfiler.h"
+
+// It records the cloth positions of every step into a chunked file, where the chunks are encoded by PointCodec
+// and written in a background thread, so the render thread only copies the positions.
+// The file has the header, the chunks, and the index of the chunks at the end, which makes it seekable by chunk.
+class SimulationRecorder final
+{
+public:
+   struct Header
+   {
+      std::array<char, 4> Magic;
+      uint32_t Version;
+      uint32_t PointNum;
+      uint32_t FramesPerChunk;
+      uint32_t FrameNum;
+      uint32_t ChunkNum;
+      uint64_t IndexOffset; // 0 if the recording has not been finished
+   };
+
+   struct ChunkEntry
+   {
+      uint64_t Offset;
+      uint32_t Size;
+      uint32_t FrameNum;
+   };
+
+   inline static constexpr std::array<char, 4> Magic = { 'C', 'R', 'E', 'C' };
+   inline static constexpr uint32_t Version = 1;
+   inline static constexpr int FramesPerChunk = 32;
+
+   SimulationRecorder(const SimulationRecorder&) = delete;
+   SimulationRecorder(const SimulationRecorder&&) = delete;
+   SimulationRecorder& operator=(const SimulationRecorder&) = delete;
+   SimulationRecorder& operator=(const SimulationRecorder&&) = delete;
+
+   SimulationRecorder();
+   ~SimulationRecorder();
+
+   [[nodiscard]] bool start(const std::string& file_path, int point_num);
+   // The positions are the first three floats of each point, and the points are stride floats apart.
+   void addFrame(const float* points, int stride);
+   // It waits for the writer to encode the remaining frames, and then writes the index.
+   void stop();
+   // The writer thread owns the file while it records, so the render thread asks the flag instead.
+   [[nodiscard]] bool isRecording() const { return Recording; }
+   [[nodiscard]] int getFrameNum() const { return FrameNum; }
+   // It is the size of the last finished recording.
+   [[nodiscard]] uint64_t getFileSize() const { return FileSize; }
+
+private:
+   int PointNum;
+   int FrameNum;
+   uint64_t FileSize;
+   bool Stop;
+   std::atomic<bool> Recording;
+   std::ofstream File;
+   std::thread Writer;
+   std::mutex Mutex;
+   std::condition_variable Condition;
+   std::vector<glm::vec3> Chunk;
+   std::deque<std::vector<glm::vec3>> PendingChunks;
+   std::vector<ChunkEntry> Index;
+
+   void write();
+};
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "AtomicFile.h"
+
+// The base of the caches of what is derived from a source file. A cache is named by the hash of the normalized
+// source path, and the path follows the header in the file to tell apart the paths of the same hash. It is valid
+// only if it is written from the source file of the same size and modified time, which the header keeps.
+class SourceCache
+{
+public:
+   SourceCache(const SourceCache&) = delete;
+   SourceCache(const SourceCache&&) = delete;
+   SourceCache& operator=(const SourceCache&) = delete;
+   SourceCache& operator=(const SourceCache&&) = delete;
+
+protected:
+   std::string SourcePath;
+   std::string CachePath;
+   MappedFile File;
+
+   // The cache is in the directory under the cache of the build, and its file name is the hash and the suffix.
+   SourceCache(const std::string& source_file_path, const std::string& directory, const std::string& suffix);
+   ~SourceCache() = default;
+
+   [[nodiscard]] static uint64_t align(uint64_t offset, uint64_t alignment);
+   [[nodiscard]] bool getSourceStatus(int64_t& modified_time, uint64_t& size) const;
+   // It maps the cache if the source exists and the file can hold the header, whose fields are left to be checked.
+   [[nodiscard]] bool open(size_t header_size, int64_t& modified_time, uint64_t& source_size);
+   // The source path of the given length should follow the header of the given size.
+   [[nodiscard]] bool hasSourcePath(size_t header_size, uint32_t source_path_length) const;
+};
\ No newline at end of file
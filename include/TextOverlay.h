@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Shader.h"
+#include "GPUMemory.h"
+
+// It draws lines of text at the top-left corner of the frame with a 5x7 bitmap font, which is enough for the
+// statistics without any font file. The glyphs are of ASCII 32 to 95, so lowercase letters are drawn in uppercase,
+// and each character is a quad of its cell, whose empty texels darken the frame behind the text.
+class TextOverlayGL final
+{
+public:
+   TextOverlayGL(const TextOverlayGL&) = delete;
+   TextOverlayGL(const TextOverlayGL&&) = delete;
+   TextOverlayGL& operator=(const TextOverlayGL&) = delete;
+   TextOverlayGL& operator=(const TextOverlayGL&&) = delete;
+
+   TextOverlayGL();
+   ~TextOverlayGL();
+
+   // It draws over the frame without the depth test, and restores the states it changes.
+   void draw(const std::vector<std::string>& lines, int frame_width, int frame_height);
+
+private:
+   inline static constexpr int GlyphWidth = 5;
+   inline static constexpr int GlyphHeight = 7;
+   inline static constexpr int CellWidth = 6; // a column and a row of padding
+   inline static constexpr int CellHeight = 8;
+   inline static constexpr int GlyphNum = 64;
+   inline static constexpr char FirstGlyph = ' ';
+   inline static constexpr int Scale = 2;
+   inline static constexpr int Margin = 8; // in pixels
+   // Each glyph is 7 rows from the top, and the lowest 5 bits of a row are its pixels from the left.
+   inline static constexpr std::array<uint8_t, GlyphNum * GlyphHeight> Glyphs = {
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // space
+      0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, // !
+      0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, // "
+      0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A, // #
+      0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04, // $
+      0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03, // %
+      0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D, // &
+      0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, // '
+      0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, // (
+      0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, // )
+      0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00, // *
+      0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, // +
+      0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08, // ,
+      0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, // -
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, // .
+      0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, // /
+      0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E, // 0
+      0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E, // 1
+      0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F, // 2
+      0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E, // 3
+      0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02, // 4
+      0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E, // 5
+      0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E, // 6
+      0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08, // 7
+      0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E, // 8
+      0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C, // 9
+      0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00, // :
+      0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08, // ;
+      0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, // <
+      0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, // =
+      0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08, // >
+      0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04, // ?
+      0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E, // @
+      0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, // A
+      0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E, // B
+      0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E, // C
+      0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C, // D
+      0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F, // E
+      0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10, // F
+      0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F, // G
+      0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, // H
+      0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, // I
+      0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C, // J
+      0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11, // K
+      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F, // L
+      0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11, // M
+      0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11, // N
+      0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, // O
+      0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10, // P
+      0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D, // Q
+      0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11, // R
+      0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E, // S
+      0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, // T
+      0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, // U
+      0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04, // V
+      0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A, // W
+      0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11, // X
+      0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, // Y
+      0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F, // Z
+      0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E, // [
+      0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, // backslash
+      0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E, // ]
+      0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00, // ^
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, // _
+   };
+
+   GLuint FontTexture;
+   GLuint VAO;
+   GLuint VBO;
+   int VertexCapacity;
+   std::vector<glm::vec4> Vertices; // the position in pixels from the top-left corner, and the texel of the font
+   std::unique_ptr<ShaderGL> Shader;
+
+   void prepare();
+   void reserveVertices(int vertex_num);
+   void addCharacter(char character, const glm::vec2& position);
+};
\ No newline at end of file
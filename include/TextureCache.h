@@ -0,0 +1,55 @@
+#pragma once
+
+#include "SourceCache.h"
+
+// The block-compressed mip chain of an image, which is laid out like KTX2: a header with the level index,
+// and the levels which can be uploaded directly from the mapped file.
+class TextureCache final : public SourceCache
+{
+public:
+   struct Level
+   {
+      uint64_t Offset; // aligned to LevelAlignment from the beginning of the file
+      uint64_t Size;
+   };
+
+   inline static constexpr int MaxLevelNum = 16;
+
+   struct Header
+   {
+      std::array<char, 4> Magic;
+      uint32_t Version;
+      int64_t SourceModifiedTime;
+      uint64_t SourceSize;
+      uint32_t InternalFormat;
+      uint32_t Width;
+      uint32_t Height;
+      uint32_t LevelNum;
+      std::array<Level, MaxLevelNum> Levels;
+      uint32_t SourcePathLength; // the source path follows the header to tell apart the paths of the same hash
+      uint32_t Reserved;
+   };
+
+   TextureCache(const std::string& source_file_path, GLenum internal_format);
+   ~TextureCache() = default;
+
+   // The cache is valid only if it is also written in the same internal format.
+   [[nodiscard]] bool load();
+   // The magic, version, source information, and level offsets of the header are filled here.
+   [[nodiscard]] bool write(Header header, const std::vector<std::vector<uint8_t>>& levels) const;
+   [[nodiscard]] const Header& getHeader() const { return *reinterpret_cast<const Header*>(File.getData()); }
+   [[nodiscard]] const uint8_t* getLevelData(int level) const
+   {
+      return reinterpret_cast<const uint8_t*>(File.getData() + getHeader().Levels[level].Offset);
+   }
+
+private:
+   inline static constexpr std::array<char, 4> Magic = { 'C', 'T', 'E', 'X' };
+   inline static constexpr uint32_t Version = 1;
+   inline static constexpr uint64_t LevelAlignment = 16;
+
+   GLenum InternalFormat;
+
+   // The caches of the same image in the different formats are told apart by the suffix.
+   [[nodiscard]] static std::string getFileSuffix(GLenum internal_format);
+};
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "_Common.h"
+
+// Encoders of the block-compressed formats in the core profile, BC7 (BPTC) for the color and BC4 (RGTC1)
+// for the grayscale, and the box filter to build the mip chain before encoding.
+class TextureCompressor final
+{
+public:
+   TextureCompressor() = default;
+   ~TextureCompressor() = default;
+
+   // The blocks at the right and bottom edges are padded by repeating the last column and row.
+   [[nodiscard]] static size_t getCompressedSize(int width, int height, bool is_grayscale);
+   [[nodiscard]] static int getMipmapLevelNum(int width, int height);
+   // Only the mode 6 of BC7 is used, which has a single subset of RGBA endpoints with 4-bit indices.
+   static void compressBC7(std::vector<uint8_t>& blocks, const uint8_t* rgba, int width, int height);
+   static void compressBC4(std::vector<uint8_t>& blocks, const uint8_t* red, int width, int height);
+   // The next level is averaged from the 2x2 texels, where the last texel is reused for the odd size.
+   static void halve(
+      std::vector<uint8_t>& halved,
+      const std::vector<uint8_t>& image,
+      int width,
+      int height,
+      int channel_num
+   );
+
+private:
+   inline static constexpr int BlockSize = 4;
+   inline static constexpr int BC7BlockBytes = 16;
+   inline static constexpr int BC4BlockBytes = 8;
+   inline static constexpr std::array<int, 16> BC7Weights = {
+      0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+   };
+
+   struct BC7Encoding
+   {
+      std::array<std::array<int, 4>, 2> Endpoints; // 7-bit
+      std::array<int, 2> PBits;
+      std::array<int, 16> Indices;
+      float Error;
+   };
+
+   using BlockFunction = void (*)(uint8_t*, const uint8_t*, int, int, int, int);
+
+   static void compressBlocks(
+      std::vector<uint8_t>& blocks,
+      const uint8_t* image,
+      int width,
+      int height,
+      int block_bytes,
+      BlockFunction compress_block
+   );
+   static void writeBits(uint8_t* block, int& position, uint32_t value, int bit_num);
+   static void compressBC7Block(uint8_t* block, const uint8_t* rgba, int width, int height, int x, int y);
+   static void compressBC4Block(uint8_t* block, const uint8_t* red, int width, int height, int x, int y);
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "VertexLayout.h"
+#include "OffscreenContext.h"
+
+// It measures the ways of building and uploading the interleaved vertices of ObjectGL, and compares each variant
+// with the baseline of its group, which is the push_back loop ObjectGL used before VertexLayout. The upload groups
+// run only if OffscreenContextGL creates an OpenGL 4.6 context, through EGL first on Linux and then through a hidden
+// window.
+class VertexBenchmark final
+{
+public:
+   VertexBenchmark(const VertexBenchmark&) = delete;
+   VertexBenchmark(const VertexBenchmark&&) = delete;
+   VertexBenchmark& operator=(const VertexBenchmark&) = delete;
+   VertexBenchmark& operator=(const VertexBenchmark&&) = delete;
+
+   VertexBenchmark(std::vector<int> vertex_nums, int repetition_num);
+   ~VertexBenchmark() = default;
+
+   void run();
+   void printResults() const;
+
+private:
+   struct Vertices
+   {
+      std::vector<glm::vec3> Positions;
+      std::vector<glm::vec3> Normals;
+      std::vector<glm::vec2> Textures;
+   };
+
+   struct Result
+   {
+      std::string Group;
+      std::string Variant;
+      int VertexNum;
+      double NanosecondsPerVertex; // the median of the repetitions
+      double Speedup;
+   };
+
+   inline static constexpr int WarmupNum = 3;
+   inline static constexpr int Stride = 8; // the floats of a vertex with the positions, normals and textures
+
+   std::vector<int> VertexNums;
+   int RepetitionNum;
+   OffscreenContextGL Context;
+   std::vector<Result> Results;
+   volatile float Sink; // the buffers are read into it, so the compiler cannot drop the work
+
+   [[nodiscard]] static Vertices getVertices(int vertex_num);
+   static void interleaveWithPushBack(std::vector<GLfloat>& data, const Vertices& vertices, bool reserve);
+   static void replaceWithIndices(std::vector<GLfloat>& data, const std::vector<glm::vec3>& positions);
+   void runInterleaving(const Vertices& vertices, int vertex_num);
+   void runReplacing(const Vertices& vertices, int vertex_num);
+   void runUploading(const Vertices& vertices, int vertex_num);
+   void addResult(const std::string& group, const std::string& variant, int vertex_num, double nanoseconds);
+
+   template<typename Function>
+   [[nodiscard]] double measure(Function function, int vertex_num) const
+   {
+      for (int i = 0; i < WarmupNum; ++i) function();
+      std::vector<double> times;
+      for (int i = 0; i < RepetitionNum; ++i) {
+         const auto start_time = std::chrono::steady_clock::now();
+         function();
+         times.emplace_back(
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_time).count()
+         );
+      }
+      std::sort( times.begin(), times.end() );
+      return times[times.size() / 2] / static_cast<double>(vertex_num);
+   }
+};
\ No newline at end of file
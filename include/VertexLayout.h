@@ -0,0 +1,44 @@
+#pragma once
+
+#include "_Common.h"
+
+// It writes the float attributes of the vertices next to each other in the order of the template arguments.
+// Each attribute is a span of glm vectors given by its first element, so the callers need not copy them into
+// vectors first, and the buffer is sized once instead of growing one float at a time.
+class VertexLayout final
+{
+public:
+   VertexLayout() = delete;
+
+   template<typename... Attributes>
+   [[nodiscard]] static constexpr int getFloatNum()
+   {
+      return static_cast<int>((sizeof( Attributes ) + ...) / sizeof( GLfloat ));
+   }
+
+   template<typename... Attributes>
+   static void interleave(std::vector<GLfloat>& data, size_t vertex_num, const Attributes*... attributes)
+   {
+      data.resize( vertex_num * getFloatNum<Attributes...>() );
+      write( data.data(), vertex_num, attributes... );
+   }
+
+   template<typename... Attributes>
+   static void write(GLfloat* data, size_t vertex_num, const Attributes*... attributes)
+   {
+      for (size_t i = 0; i < vertex_num; ++i) {
+         ((std::memcpy( data, &attributes[i], sizeof( Attributes ) ), data += sizeof( Attributes ) / sizeof( GLfloat )), ...);
+      }
+   }
+
+   // It overwrites the first components of each vertex after the offset, and the other attributes are kept.
+   // The source is the tightly packed components, so it can be a span of glm vectors as well as of floats.
+   template<int ComponentNum>
+   static void scatter(GLfloat* data, int stride, int offset, size_t vertex_num, const GLfloat* components)
+   {
+      data += offset;
+      for (size_t i = 0; i < vertex_num; ++i, data += stride, components += ComponentNum) {
+         std::memcpy( data, components, sizeof( GLfloat ) * ComponentNum );
+      }
+   }
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "_Common.h"
+
+// It records the CPU time of the scoped zones on every thread, and writes them into a trace that
+// chrome://tracing and Perfetto open. Each thread appends to its own list of blocks, which is published with
+// an atomic count, so recording never takes a lock except when a thread records its first zone.
+class ZoneProfiler final
+{
+public:
+   // The name must outlive the profiler, so it is meant to be a string literal.
+   class Zone final
+   {
+   public:
+      Zone(const Zone&) = delete;
+      Zone(const Zone&&) = delete;
+      Zone& operator=(const Zone&) = delete;
+      Zone& operator=(const Zone&&) = delete;
+
+      explicit Zone(const char* name) : Name( Enabled ? name : nullptr ), BeginTime( Name != nullptr ? getTime() : 0 ) {}
+      ~Zone() { if (Name != nullptr) record( Name, BeginTime, getTime() ); }
+
+   private:
+      const char* Name;
+      int64_t BeginTime;
+   };
+
+   ZoneProfiler() = delete;
+
+   // The zones before it are not recorded, so it should be called before anything worth seeing.
+   static void start();
+   // It can be called on any thread, and the name shows up as the track of the thread.
+   static void setThreadName(const char* name);
+   // The threads should not record zones while it writes, so it should be called at the end.
+   [[nodiscard]] static bool writeTrace(const std::string& file_path);
+   [[nodiscard]] static bool isEnabled() { return Enabled; }
+
+private:
+   inline static constexpr int BlockSize = 4096;
+
+   struct Event
+   {
+      const char* Name;
+      int64_t BeginTime;
+      int64_t EndTime;
+   };
+
+   struct EventBlock
+   {
+      std::array<Event, BlockSize> Events;
+      std::atomic<int> Count;
+      std::atomic<EventBlock*> Next;
+
+      EventBlock() : Events{}, Count( 0 ), Next( nullptr ) {}
+   };
+
+   struct ThreadEvents
+   {
+      int ThreadID;
+      std::atomic<const char*> ThreadName;
+      EventBlock Head;
+      EventBlock* Tail;
+
+      explicit ThreadEvents(int thread_id) : ThreadID( thread_id ), ThreadName( nullptr ), Tail( &Head ) {}
+      ~ThreadEvents()
+      {
+         EventBlock* block = Head.Next.load();
+         while (block != nullptr) {
+            EventBlock* next = block->Next.load();
+            delete block;
+            block = next;
+         }
+      }
+   };
+
+   inline static std::atomic<bool> Enabled = false;
+   inline static std::chrono::steady_clock::time_point StartTime;
+   inline static std::mutex Mutex;
+   inline static std::vector<std::shared_ptr<ThreadEvents>> Threads;
+
+   [[nodiscard]] static int64_t getTime();
+   [[nodiscard]] static ThreadEvents& getThreadEvents();
+   static void record(const char* name, int64_t begin_time, int64_t end_time);
+   static void writeString(std::ofstream& file, const char* text);
+};
\ No newline at end of file
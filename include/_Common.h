@@ -7,20 +7,35 @@
 #include <gtc/type_ptr.hpp>
 #include <gtc/matrix_transform.hpp>
 #include <gtc/quaternion.hpp>
+#include <gtc/packing.hpp>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <gtx/quaternion.hpp>
+#include <gtx/hash.hpp>
 
 #include <FreeImage.h>
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <string>
+#include <cstring>
 #include <map>
 #include <unordered_map>
 #include <sstream>
 #include <fstream>
 #include <chrono>
+#include <charconv>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <filesystem>
 
 #include "ProjectPath.h"
 
@@ -29,4 +44,15 @@ using uint = unsigned int;
 
 constexpr uint OPENGL_COLOR_BUFFER_BIT = 0x00004000u;
 constexpr uint OPENGL_DEPTH_BUFFER_BIT = 0x00000100u;
-constexpr uint OPENGL_STENCIL_BUFFER_BIT = 0x00000400u;
\ No newline at end of file
+constexpr uint OPENGL_STENCIL_BUFFER_BIT = 0x00000400u;
+
+// FNV-1a, which is enough to name the cache files, but not for anything adversarial.
+inline uint64_t getFNV1aHash(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+   const auto* bytes = static_cast<const uint8_t*>(data);
+   for (size_t i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+   }
+   return hash;
+}
\ No newline at end of file
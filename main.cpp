@@ -1,8 +1,114 @@
 #include "Renderer.h"
 
-int main()
+int main(int argc, char* argv[])
 {
-   RendererGL renderer;
-   renderer.play();
-   return 0;
+   // The profiler starts before the renderer, so the trace also shows the startup.
+   std::string trace_path;
+   for (int i = 1; i + 1 < argc; ++i) {
+      if (std::string(argv[i]) == "--trace") trace_path = argv[i + 1];
+   }
+   if (!trace_path.empty()) ZoneProfiler::start();
+
+   // The context of the renderer is created with it, so these options are known before any other.
+   int headless_frame_num = 0, frame_width = 1920, frame_height = 1080;
+   for (int i = 1; i + 1 < argc; ++i) {
+      const std::string option(argv[i]);
+      if (option == "--headless") headless_frame_num = std::atoi( argv[i + 1] );
+      else if (option == "--size") {
+         std::istringstream size(argv[i + 1]);
+         char separator = 0;
+         if (!(size >> frame_width >> separator >> frame_height) || separator != 'x') frame_width = frame_height = 0;
+      }
+   }
+
+   const bool headless = headless_frame_num > 0;
+   bool succeeded = false;
+   {
+      RendererGL renderer(headless, std::max( frame_width, 1 ), std::max( frame_height, 1 ));
+      if (!renderer.isInitialized()) return 1;
+      if (headless) renderer.setFrameLimit( headless_frame_num );
+
+      int frame_num = 0;
+      bool use_tessellation = false;
+      float tessellation_edge_length = 0.0f;
+      bool usage_error = false;
+      std::string point_cache_path;
+      for (int i = 1; i < argc; ++i) {
+         const std::string option(argv[i]);
+         if (option == "--checkpoint" && i + 1 < argc) renderer.setWarmStart( argv[++i] );
+         else if (option == "--scene" && i + 1 < argc) {
+            SceneDescription scene;
+            if (!SceneFile::read( argv[++i], scene )) return 1;
+            renderer.setSceneDescription( scene );
+         }
+         else if (option == "--trace" && i + 1 < argc) ++i;
+         else if (option == "--headless" && i + 1 < argc && headless_frame_num > 0) ++i;
+         else if (option == "--size" && i + 1 < argc && frame_width > 0 && frame_height > 0) ++i;
+         else if (option == "--capture") renderer.setCaptureOnStart( true );
+         else if (option == "--tessellation") {
+            const bool has_length = i + 1 < argc && std::string(argv[i + 1]).rfind( "--", 0 ) != 0;
+            use_tessellation = true;
+            if (has_length) {
+               tessellation_edge_length = static_cast<float>(std::atof( argv[++i] ));
+               if (tessellation_edge_length <= 0.0f) usage_error = true;
+            }
+         }
+         else if (option == "--gpu-memory") {
+            const bool has_budget = i + 1 < argc && std::string(argv[i + 1]).rfind( "--", 0 ) != 0;
+            const double budget = has_budget ? std::atof( argv[++i] ) : 0.0;
+            renderer.setGPUMemoryReport( static_cast<int64_t>(budget * 1024.0 * 1024.0) );
+         }
+         else if (option == "--gpu-profile") {
+            const bool has_path = i + 1 < argc && std::string(argv[i + 1]).rfind( "--", 0 ) != 0;
+            renderer.setGPUProfile( has_path ? argv[++i] : "" );
+         }
+         else if (option == "--stats") {
+            const bool has_path = i + 1 < argc && std::string(argv[i + 1]).rfind( "--", 0 ) != 0;
+            renderer.setStatistics( has_path ? argv[++i] : "" );
+         }
+         else if (option == "--pacing" && i + 1 < argc) {
+            const std::string pacing(argv[++i]);
+            if (pacing == "vsync") renderer.setFramePacing( FramePacerGL::PacingMode::VSync );
+            else if (pacing == "uncapped") renderer.setFramePacing( FramePacerGL::PacingMode::Uncapped );
+            else if (std::atof( pacing.c_str() ) > 0.0) {
+               renderer.setFramePacing( FramePacerGL::PacingMode::Fixed, std::atof( pacing.c_str() ) );
+            }
+            else usage_error = true;
+         }
+         else if (option == "--frames-in-flight" && i + 1 < argc && std::atoi( argv[i + 1] ) > 0) {
+            renderer.setFramesInFlight( std::atoi( argv[++i] ) );
+         }
+         else if (option == "--capture-format" && i + 1 < argc) {
+            const std::string format(argv[++i]);
+            if (format == "raw") renderer.setCaptureFormat( FrameCaptureGL::CaptureFormat::Raw );
+            else if (format == "png") renderer.setCaptureFormat( FrameCaptureGL::CaptureFormat::PNG );
+            else if (format == "y4m") renderer.setCaptureFormat( FrameCaptureGL::CaptureFormat::Y4M );
+            else usage_error = true;
+         }
+         else if (option == "--bake" && i + 2 < argc && std::atoi( argv[i + 1] ) > 0) {
+            frame_num = std::atoi( argv[++i] );
+            point_cache_path = argv[++i];
+         }
+         else usage_error = true;
+
+         if (usage_error) {
+            std::cerr << "Usage: " << argv[0]
+               << " [--scene <file>] [--tessellation [edge length in pixels]] [--checkpoint <file>] [--capture]"
+               << " [--capture-format raw|png|y4m] [--gpu-profile [output.csv]]"
+               << " [--gpu-memory [budget in MiB]] [--stats [output.csv]]"
+               << " [--pacing vsync|uncapped|<frames/s>] [--frames-in-flight <number>]"
+               << " [--trace <output.json>] [--headless <frame number>] [--size <width>x<height>]"
+               << " [--bake <frame number> <output.pc2>]\n";
+            return 1;
+         }
+      }
+
+      // It is applied after the scene file, so the option wins over the scene whatever their order.
+      if (use_tessellation) renderer.setTessellation( tessellation_edge_length );
+      succeeded = frame_num > 0 ? renderer.bake( frame_num, point_cache_path ) : renderer.play();
+   }
+   // All the GL objects are deleted with the renderer, so the ones still recorded are leaked.
+   GPUMemoryGL::reportLeaks();
+   if (!trace_path.empty() && ZoneProfiler::writeTrace( trace_path )) std::cout << "Trace is written into " << trace_path << "\n";
+   return succeeded ? 0 : 1;
 }
\ No newline at end of file
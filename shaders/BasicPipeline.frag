@@ -1,6 +1,8 @@
 #version 460
 
+#ifndef MAX_LIGHTS
 #define MAX_LIGHTS 32
+#endif
 
 struct LightInfo
 {
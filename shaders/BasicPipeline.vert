@@ -5,6 +5,11 @@ uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
 uniform mat4 ModelViewProjectionMatrix;
 
+// The packed vertex formats of ObjectGL are decoded with these.
+uniform vec3 PositionScale;
+uniform vec3 PositionOffset;
+uniform int OctahedralNormal;
+
 layout (location = 0) in vec3 v_position;
 layout (location = 1) in vec3 v_normal;
 layout (location = 2) in vec2 v_tex_coord;
@@ -13,14 +18,26 @@ out vec3 position_in_ec;
 out vec3 normal_in_ec;
 out vec2 tex_coord;
 
+vec3 decodeOctahedralNormal(in vec2 encoded)
+{
+   vec3 normal = vec3(encoded, 1.0f - abs( encoded.x ) - abs( encoded.y ));
+   float t = max( -normal.z, 0.0f );
+   normal.x += normal.x >= 0.0f ? -t : t;
+   normal.y += normal.y >= 0.0f ? -t : t;
+   return normal;
+}
+
 void main()
 {   
-   vec4 e_position = ViewMatrix * WorldMatrix * vec4(v_position, 1.0f);
-   vec4 e_normal = transpose( inverse( ViewMatrix * WorldMatrix ) ) * vec4(v_normal, 1.0f);
+   vec3 position = v_position * PositionScale + PositionOffset;
+   vec3 normal = OctahedralNormal != 0 ? decodeOctahedralNormal( v_normal.xy ) : v_normal;
+
+   vec4 e_position = ViewMatrix * WorldMatrix * vec4(position, 1.0f);
+   vec4 e_normal = transpose( inverse( ViewMatrix * WorldMatrix ) ) * vec4(normal, 1.0f);
    position_in_ec = e_position.xyz;
    normal_in_ec = normalize( e_normal.xyz );
 
    tex_coord = v_tex_coord;  
 
-   gl_Position = ModelViewProjectionMatrix * vec4(v_position, 1.0f);
+   gl_Position = ModelViewProjectionMatrix * vec4(position, 1.0f);
 }
\ No newline at end of file
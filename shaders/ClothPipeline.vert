@@ -0,0 +1,54 @@
+#version 460
+
+uniform mat4 WorldMatrix;
+uniform mat4 ViewMatrix;
+uniform mat4 ModelViewProjectionMatrix;
+uniform int ClothPointNumX;
+
+#include "ClothPoint.glsl"
+
+// The newest step of the simulation, which is pulled by gl_VertexID instead of the vertex attributes.
+layout (binding = 5, std430) readonly buffer ClothPoints {
+   Attributes Points[];
+};
+
+out vec3 position_in_ec;
+out vec3 normal_in_ec;
+out vec2 tex_coord;
+
+const float zero = 0.0f;
+const float one = 1.0f;
+
+vec3 getPosition(in int index)
+{
+   return vec3(Points[index].x, Points[index].y, Points[index].z);
+}
+
+vec3 getNormal(in int index)
+{
+   // The solver does not update the normals, so they are made from the neighbors of the newest positions.
+   int rows = Points.length() / ClothPointNumX;
+   int x = index % ClothPointNumX;
+   int y = index / ClothPointNumX;
+   int left = y * ClothPointNumX + max( x - 1, 0 );
+   int right = y * ClothPointNumX + min( x + 1, ClothPointNumX - 1 );
+   int top = max( y - 1, 0 ) * ClothPointNumX + x;
+   int bottom = min( y + 1, rows - 1 ) * ClothPointNumX + x;
+   vec3 normal = cross( getPosition( bottom ) - getPosition( top ), getPosition( right ) - getPosition( left ) );
+   return length( normal ) > zero ? normalize( normal ) : vec3(zero, one, zero);
+}
+
+void main()
+{
+   vec3 position = getPosition( gl_VertexID );
+   vec3 normal = getNormal( gl_VertexID );
+
+   vec4 e_position = ViewMatrix * WorldMatrix * vec4(position, one);
+   vec4 e_normal = transpose( inverse( ViewMatrix * WorldMatrix ) ) * vec4(normal, zero);
+   position_in_ec = e_position.xyz;
+   normal_in_ec = normalize( e_normal.xyz );
+
+   tex_coord = vec2(Points[gl_VertexID].s, Points[gl_VertexID].t);
+
+   gl_Position = ModelViewProjectionMatrix * vec4(position, one);
+}
\ No newline at end of file
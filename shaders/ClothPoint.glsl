@@ -0,0 +1,5 @@
+// It is the vertex layout of the cloth, which is shared by the simulation and the rendering.
+struct Attributes
+{
+   float x, y, z, nx, ny, nz, s, t;
+};
\ No newline at end of file
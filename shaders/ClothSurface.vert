@@ -0,0 +1,17 @@
+#version 460
+
+#include "ClothPoint.glsl"
+
+// The newest step of the simulation, which is pulled by gl_VertexID instead of the vertex attributes.
+layout (binding = 5, std430) readonly buffer ClothPoints {
+   Attributes Points[];
+};
+
+out vec3 tc_position;
+out vec2 tc_tex_coord;
+
+void main()
+{
+   tc_position = vec3(Points[gl_VertexID].x, Points[gl_VertexID].y, Points[gl_VertexID].z);
+   tc_tex_coord = vec2(Points[gl_VertexID].s, Points[gl_VertexID].t);
+}
\ No newline at end of file
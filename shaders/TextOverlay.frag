@@ -0,0 +1,14 @@
+#version 460
+
+layout (binding = 0) uniform sampler2D Font;
+
+in vec2 texel;
+
+layout (location = 0) out vec4 final_color;
+
+void main()
+{
+   // The empty texels of a cell darken the frame, so the text stays readable over the bright cloth.
+   float glyph = texelFetch( Font, ivec2(texel), 0 ).r;
+   final_color = mix( vec4(0.0f, 0.0f, 0.0f, 0.6f), vec4(1.0f, 1.0f, 1.0f, 1.0f), glyph );
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#version 460
+
+uniform vec2 FrameSize;
+
+// The position is in pixels from the top-left corner of the frame, and the texel is of the font.
+layout (location = 0) in vec4 v_vertex;
+
+out vec2 texel;
+
+void main()
+{
+   texel = v_vertex.zw;
+   vec2 position = v_vertex.xy / FrameSize * 2.0f - 1.0f;
+   gl_Position = vec4(position.x, -position.y, 0.0f, 1.0f);
+}
\ No newline at end of file
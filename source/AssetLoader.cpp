@@ -0,0 +1,248 @@
+#include "AssetLoader.h"
+
+AssetLoaderGL::AssetLoaderGL(int thread_num) :
+   Stop( false ), RequestNum( 0 ), StagingBuffer( 0 ), StagingData( nullptr ), StagingSlot( 0 ), StagingFences{}
+{
+   thread_num = std::max( thread_num, 1 );
+   for (int i = 0; i < thread_num; ++i) Workers.emplace_back( &AssetLoaderGL::work, this );
+}
+
+AssetLoaderGL::~AssetLoaderGL()
+{
+   {
+      std::lock_guard<std::mutex> lock( Mutex );
+      Stop = true;
+   }
+   Condition.notify_all();
+   for (auto& worker : Workers) worker.join();
+
+   // The textures still uploading are not given to their objects yet, so they are deleted here.
+   for (const auto& asset : UploadingAssets) {
+      if (asset->TextureID != 0) {
+         GPUMemoryGL::removeTextures( 1, &asset->TextureID );
+         glDeleteTextures( 1, &asset->TextureID );
+      }
+   }
+   for (auto& fence : StagingFences) {
+      if (fence != nullptr) glDeleteSync( fence );
+   }
+   if (StagingBuffer != 0) {
+      glUnmapNamedBuffer( StagingBuffer );
+      GPUMemoryGL::removeBuffers( 1, &StagingBuffer );
+      glDeleteBuffers( 1, &StagingBuffer );
+   }
+}
+
+void AssetLoaderGL::work()
+{
+   ZoneProfiler::setThreadName( "AssetLoader" );
+   while (true) {
+      std::unique_ptr<Asset> asset;
+      {
+         std::unique_lock<std::mutex> lock( Mutex );
+         Condition.wait( lock, [this]() { return Stop || !PendingAssets.empty(); } );
+         if (Stop) return;
+         asset = std::move( PendingAssets.front() );
+         PendingAssets.pop_front();
+      }
+
+      load( *asset );
+
+      std::lock_guard<std::mutex> lock( Mutex );
+      LoadedAssets.emplace_back( std::move( asset ) );
+   }
+}
+
+void AssetLoaderGL::load(Asset& asset)
+{
+   const ZoneProfiler::Zone zone( "loadAsset" );
+   if (asset.Mesh) asset.Loaded = asset.Object->loadMesh( *asset.Mesh, asset.FilePath );
+   else asset.Loaded = ObjectGL::loadTexture( *asset.Texture, asset.FilePath, asset.IsGrayscale );
+}
+
+void AssetLoaderGL::enqueue(std::unique_ptr<Asset> asset)
+{
+   RequestNum++;
+   {
+      std::lock_guard<std::mutex> lock( Mutex );
+      PendingAssets.emplace_back( std::move( asset ) );
+   }
+   Condition.notify_one();
+}
+
+void AssetLoaderGL::requestObject(
+   ObjectGL* object,
+   GLenum draw_mode,
+   const std::string& obj_file_path,
+   std::function<void()> on_ready
+)
+{
+   auto asset = std::make_unique<Asset>();
+   asset->Object = object;
+   asset->DrawMode = draw_mode;
+   asset->FilePath = obj_file_path;
+   asset->OnReady = std::move( on_ready );
+   asset->Mesh = std::make_unique<ObjectGL::MeshData>();
+   enqueue( std::move( asset ) );
+}
+
+int AssetLoaderGL::requestTexture(
+   ObjectGL* object,
+   const std::string& texture_file_path,
+   bool is_grayscale,
+   std::function<void()> on_ready
+)
+{
+   constexpr std::array<uint8_t, 4> white = { 255, 255, 255, 255 };
+   auto asset = std::make_unique<Asset>();
+   asset->Object = object;
+   asset->TextureIndex = object->addTexture( white.data(), 1, 1, is_grayscale );
+   asset->IsGrayscale = is_grayscale;
+   asset->FilePath = texture_file_path;
+   asset->OnReady = std::move( on_ready );
+   asset->Texture = std::make_unique<ObjectGL::TextureData>();
+   const int texture_index = asset->TextureIndex;
+   enqueue( std::move( asset ) );
+   return texture_index;
+}
+
+void AssetLoaderGL::prepareUpload(Asset& asset) const
+{
+   if (asset.Mesh) {
+      const ObjectGL::MeshData& mesh = *asset.Mesh;
+      asset.Object->setObject( asset.DrawMode, mesh, false );
+      asset.Transfers.emplace_back(
+         static_cast<const uint8_t*>(mesh.getVertexData()),
+         mesh.getVertexDataSize(),
+         asset.Object->getVBO()
+      );
+      asset.Transfers.emplace_back(
+         reinterpret_cast<const uint8_t*>(mesh.getIndexData()),
+         sizeof( GLuint ) * mesh.Header.IndexNum,
+         asset.Object->getIBO()
+      );
+   }
+   else {
+      const ObjectGL::TextureData& texture = *asset.Texture;
+      asset.TextureID = ObjectGL::createTexture( texture, false );
+      for (size_t level = 0; level < texture.LevelData.size(); ++level) {
+         asset.Transfers.emplace_back(
+            texture.LevelData[level].first,
+            texture.LevelData[level].second,
+            asset.TextureID,
+            static_cast<GLint>(level),
+            std::max( texture.Width >> level, 1 ),
+            std::max( texture.Height >> level, 1 ),
+            texture.InternalFormat
+         );
+      }
+   }
+}
+
+size_t AssetLoaderGL::copy(Transfer& transfer, size_t staging_offset, size_t budget) const
+{
+   size_t size = std::min( transfer.Size - transfer.CopiedSize, budget );
+   if (!transfer.IsTexture) {
+      std::memcpy( StagingData + staging_offset, transfer.Data + transfer.CopiedSize, size );
+      glCopyNamedBufferSubData(
+         StagingBuffer,
+         transfer.Target,
+         static_cast<GLintptr>(staging_offset),
+         static_cast<GLintptr>(transfer.CopiedSize),
+         static_cast<GLsizeiptr>(size)
+      );
+   }
+   else {
+      // The compressed image can be split only at the rows of blocks.
+      const size_t row_num = (transfer.Height + CompressedBlockSize - 1) / CompressedBlockSize;
+      const size_t row_size = transfer.Size / row_num;
+      const size_t copied_row_num = transfer.CopiedSize / row_size;
+      const size_t row_num_to_copy = size / row_size;
+      if (row_num_to_copy == 0) return 0;
+
+      size = row_num_to_copy * row_size;
+      std::memcpy( StagingData + staging_offset, transfer.Data + transfer.CopiedSize, size );
+      const auto y = static_cast<GLint>(copied_row_num * CompressedBlockSize);
+      glBindBuffer( GL_PIXEL_UNPACK_BUFFER, StagingBuffer );
+      glCompressedTextureSubImage2D(
+         transfer.Target,
+         transfer.Level,
+         0,
+         y,
+         transfer.Width,
+         std::min( static_cast<GLsizei>(row_num_to_copy * CompressedBlockSize), transfer.Height - y ),
+         transfer.InternalFormat,
+         static_cast<GLsizei>(size),
+         reinterpret_cast<const GLvoid*>(staging_offset)
+      );
+      glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+   }
+   transfer.CopiedSize += size;
+   return size;
+}
+
+void AssetLoaderGL::finish(Asset& asset)
+{
+   if (asset.Texture) asset.Object->setTexture( asset.TextureIndex, asset.TextureID );
+   if (asset.OnReady) asset.OnReady();
+}
+
+void AssetLoaderGL::update()
+{
+   if (RequestNum == 0) return;
+
+   const ZoneProfiler::Zone zone( "uploadAssets" );
+   if (StagingBuffer == 0) {
+      const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+      glCreateBuffers( 1, &StagingBuffer );
+      glNamedBufferStorage( StagingBuffer, UploadBudget * FramesInFlight, nullptr, flags );
+      GPUMemoryGL::addBuffer(
+         StagingBuffer, GPUMemoryGL::Category::Transfer, UploadBudget * FramesInFlight, "AssetLoader", "staging"
+      );
+      StagingData = static_cast<uint8_t*>(glMapNamedBufferRange( StagingBuffer, 0, UploadBudget * FramesInFlight, flags ));
+   }
+
+   std::deque<std::unique_ptr<Asset>> loaded;
+   {
+      std::lock_guard<std::mutex> lock( Mutex );
+      loaded.swap( LoadedAssets );
+   }
+   for (auto& asset : loaded) {
+      if (!asset->Loaded) {
+         std::cerr << "Could not load " << asset->FilePath << "\n";
+         RequestNum--;
+         continue;
+      }
+      prepareUpload( *asset );
+      UploadingAssets.emplace_back( std::move( asset ) );
+   }
+   if (UploadingAssets.empty()) return;
+
+   GLsync& fence = StagingFences[StagingSlot];
+   if (fence != nullptr) {
+      if (glClientWaitSync( fence, 0, 0 ) == GL_TIMEOUT_EXPIRED) return;
+      glDeleteSync( fence );
+      fence = nullptr;
+   }
+
+   const size_t slot_offset = static_cast<size_t>(StagingSlot) * UploadBudget;
+   size_t offset = slot_offset;
+   while (!UploadingAssets.empty()) {
+      Asset& asset = *UploadingAssets.front();
+      while (asset.NextTransfer < asset.Transfers.size()) {
+         Transfer& transfer = asset.Transfers[asset.NextTransfer];
+         const size_t copied_size = copy( transfer, offset, slot_offset + UploadBudget - offset );
+         if (copied_size == 0 && transfer.CopiedSize < transfer.Size) break;
+
+         offset = std::min( (offset + copied_size + 15) / 16 * 16, slot_offset + UploadBudget );
+         if (transfer.CopiedSize == transfer.Size) asset.NextTransfer++;
+      }
+      if (asset.NextTransfer < asset.Transfers.size()) break;
+
+      finish( asset );
+      RequestNum--;
+      UploadingAssets.pop_front();
+   }
+   if (offset != slot_offset) fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+   StagingSlot = (StagingSlot + 1) % FramesInFlight;
+}
\ No newline at end of file
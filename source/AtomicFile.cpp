@@ -0,0 +1,40 @@
+#include "AtomicFile.h"
+
+bool AtomicFile::write(
+   const std::string& file_path,
+   const std::string& description,
+   const std::function<void(std::ofstream&)>& write_contents
+)
+{
+   std::error_code error;
+   const std::filesystem::path path(file_path);
+   if (path.has_parent_path()) {
+      std::filesystem::create_directories( path.parent_path(), error );
+      if (error) {
+         std::cerr << "Cannot create the " << description << " directory: " << path.parent_path().string() << "\n";
+         return false;
+      }
+   }
+
+   const std::string temporary_path = file_path + ".tmp";
+   std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+   if (!file.is_open()) {
+      std::cerr << "Cannot write the " << description << ": " << temporary_path << "\n";
+      return false;
+   }
+   write_contents( file );
+   file.close();
+   if (!file) {
+      std::cerr << "Cannot write the " << description << ": " << temporary_path << "\n";
+      std::filesystem::remove( temporary_path, error );
+      return false;
+   }
+
+   std::filesystem::rename( temporary_path, path, error );
+   if (error) {
+      std::cerr << "Cannot replace the " << description << ": " << file_path << "\n";
+      std::filesystem::remove( temporary_path, error );
+      return false;
+   }
+   return true;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "BufferReadback.h"
+
+BufferReadbackGL::BufferReadbackGL(GLsizeiptr size, std::function<void(const uint8_t*)> on_read) :
+   Size( size ), Buffer( 0 ), Data( nullptr ), OldestSlot( 0 ), PendingNum( 0 ), DroppedNum( 0 ), Fences{},
+   OnRead( std::move( on_read ) )
+{
+   const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+   glCreateBuffers( 1, &Buffer );
+   glNamedBufferStorage( Buffer, Size * SlotNum, nullptr, flags | GL_CLIENT_STORAGE_BIT );
+   GPUMemoryGL::addBuffer( Buffer, GPUMemoryGL::Category::Transfer, Size * SlotNum, "BufferReadback", "slots" );
+   Data = static_cast<const uint8_t*>(glMapNamedBufferRange( Buffer, 0, Size * SlotNum, flags ));
+}
+
+BufferReadbackGL::~BufferReadbackGL()
+{
+   for (auto& fence : Fences) {
+      if (fence != nullptr) glDeleteSync( fence );
+   }
+   glUnmapNamedBuffer( Buffer );
+   GPUMemoryGL::removeBuffers( 1, &Buffer );
+   glDeleteBuffers( 1, &Buffer );
+}
+
+bool BufferReadbackGL::deliverOldest(GLuint64 timeout)
+{
+   GLsync& fence = Fences[OldestSlot];
+   const GLenum result = glClientWaitSync( fence, timeout > 0 ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout );
+   if (result == GL_TIMEOUT_EXPIRED) return false;
+
+   // The copy of a failed wait cannot be trusted, so it is dropped, and the slot is freed for the next request.
+   glDeleteSync( fence );
+   fence = nullptr;
+   if (result == GL_WAIT_FAILED) {
+      DroppedNum++;
+      std::cerr << "The readback failed to wait for GPU, so a copy is dropped (" << DroppedNum << " so far).\n";
+   }
+   else OnRead( Data + Size * OldestSlot );
+   OldestSlot = (OldestSlot + 1) % SlotNum;
+   PendingNum--;
+   return true;
+}
+
+void BufferReadbackGL::request(GLuint buffer)
+{
+   while (PendingNum == SlotNum) {
+      if (!deliverOldest( std::numeric_limits<GLuint64>::max() )) return;
+   }
+
+   // The buffer is written by the compute shader, so the copy should see the writes.
+   const int slot = (OldestSlot + PendingNum) % SlotNum;
+   glMemoryBarrier( GL_BUFFER_UPDATE_BARRIER_BIT );
+   glCopyNamedBufferSubData( buffer, Buffer, 0, Size * slot, Size );
+   Fences[slot] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+   PendingNum++;
+}
+
+void BufferReadbackGL::update()
+{
+   while (PendingNum > 0) {
+      if (!deliverOldest( 0 )) return;
+   }
+}
+
+void BufferReadbackGL::flush()
+{
+   while (PendingNum > 0) {
+      if (!deliverOldest( std::numeric_limits<GLuint64>::max() )) return;
+   }
+}
\ No newline at end of file
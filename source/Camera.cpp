@@ -124,4 +124,22 @@ void CameraGL::updateWindowSize(int width, int height)
    Height = height;
    AspectRatio = static_cast<float>(width) / static_cast<float>(height);
    ProjectionMatrix = glm::perspective( glm::radians( FOV ), AspectRatio, NearPlane, FarPlane );
+}
+
+void CameraGL::getFrustumPlanes(std::array<glm::vec4, 6>& planes) const
+{
+   // The planes are extracted from the rows of the view-projection matrix, so they are in the world coordinate.
+   // Each plane (a, b, c, d) is normalized to make a * x + b * y + c * z + d be the signed distance.
+   const glm::mat4 view_projection = ProjectionMatrix * ViewMatrix;
+   const glm::vec4 row0(view_projection[0][0], view_projection[1][0], view_projection[2][0], view_projection[3][0]);
+   const glm::vec4 row1(view_projection[0][1], view_projection[1][1], view_projection[2][1], view_projection[3][1]);
+   const glm::vec4 row2(view_projection[0][2], view_projection[1][2], view_projection[2][2], view_projection[3][2]);
+   const glm::vec4 row3(view_projection[0][3], view_projection[1][3], view_projection[2][3], view_projection[3][3]);
+   planes[0] = row3 + row0; // left
+   planes[1] = row3 - row0; // right
+   planes[2] = row3 + row1; // bottom
+   planes[3] = row3 - row1; // top
+   planes[4] = row3 + row2; // near
+   planes[5] = row3 - row2; // far
+   for (auto& plane : planes) plane /= glm::length( glm::vec3(plane) );
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "ClothBatch.h"
+
+ClothBatch::ClothBatch() : FrameNum( DefaultFrameNum )
+{
+}
+
+bool ClothBatch::readSweep(const std::string& arguments)
+{
+   std::istringstream stream(arguments);
+   Sweep sweep;
+   stream >> sweep.Keyword;
+   const auto repeated = std::find_if(
+      Sweeps.begin(), Sweeps.end(), [&sweep](const Sweep& other) { return other.Keyword == sweep.Keyword; }
+   );
+   if (repeated != Sweeps.end()) return false;
+
+   std::string value;
+   while (std::getline( stream, value, '|' )) {
+      const size_t first = value.find_first_not_of( " \t\r" );
+      if (first == std::string::npos) return false;
+      value = value.substr( first, value.find_last_not_of( " \t\r" ) - first + 1 );
+      // Each value is tried on a copy, so a broken one is found before any variant runs.
+      SceneDescription scene = BaseScene;
+      if (!SceneFile::set( scene, sweep.Keyword + " " + value )) return false;
+      sweep.Values.emplace_back( value );
+   }
+   if (sweep.Values.empty()) return false;
+   Sweeps.emplace_back( std::move( sweep ) );
+   return true;
+}
+
+bool ClothBatch::setVariants()
+{
+   size_t variant_num = 1;
+   for (const auto& sweep : Sweeps) variant_num *= sweep.Values.size();
+
+   Variants.clear();
+   const int digit_num = std::max( static_cast<int>(std::to_string( variant_num - 1 ).size()), 3 );
+   for (size_t i = 0; i < variant_num; ++i) {
+      // The last sweep changes the fastest, as the digits of a number do.
+      Variant variant;
+      std::ostringstream name;
+      name << "variant_" << std::setw( digit_num ) << std::setfill( '0' ) << i;
+      variant.Name = name.str();
+      variant.Scene = BaseScene;
+      variant.Values.resize( Sweeps.size() );
+      size_t index = i;
+      for (size_t s = Sweeps.size(); s > 0; --s) {
+         const Sweep& sweep = Sweeps[s - 1];
+         variant.Values[s - 1] = sweep.Values[index % sweep.Values.size()];
+         index /= sweep.Values.size();
+         if (!SceneFile::set( variant.Scene, sweep.Keyword + " " + variant.Values[s - 1] )) return false;
+      }
+
+      const std::string error = SceneFile::getError( variant.Scene );
+      if (!error.empty()) {
+         std::cerr << variant.Name << ": " << error << "\n";
+         return false;
+      }
+      Variants.emplace_back( std::move( variant ) );
+   }
+   return true;
+}
+
+bool ClothBatch::read(const std::string& file_path)
+{
+   std::ifstream file(file_path);
+   if (!file.is_open()) {
+      std::cerr << "Cannot read the batch: " << file_path << "\n";
+      return false;
+   }
+
+   std::string line;
+   for (int line_number = 1; std::getline( file, line ); ++line_number) {
+      line = line.substr( 0, line.find( '#' ) );
+      std::istringstream stream(line);
+      std::string keyword;
+      if (!(stream >> keyword)) continue;
+
+      std::string arguments;
+      std::getline( stream, arguments );
+      bool valid;
+      if (keyword == "scene") {
+         std::istringstream path_stream(arguments);
+         std::string scene_path;
+         path_stream >> scene_path;
+         valid = SceneFile::read( (std::filesystem::path(file_path).parent_path() / scene_path).string(), BaseScene );
+      }
+      else if (keyword == "checkpoint") {
+         std::istringstream path_stream(arguments);
+         std::string checkpoint_path;
+         valid = static_cast<bool>(path_stream >> checkpoint_path);
+         CheckpointPath = (std::filesystem::path(file_path).parent_path() / checkpoint_path).string();
+      }
+      else if (keyword == "frames") {
+         std::istringstream frame_stream(arguments);
+         valid = static_cast<bool>(frame_stream >> FrameNum) && FrameNum > 0;
+      }
+      else if (keyword == "sweep") valid = readSweep( arguments );
+      else valid = SceneFile::set( BaseScene, line );
+
+      if (!valid) {
+         std::cerr << file_path << ":" << line_number << ": the line is unknown or broken: " << line << "\n";
+         return false;
+      }
+   }
+   return setVariants();
+}
+
+ClothBatch::Result ClothBatch::simulate(const Variant& variant, const std::filesystem::path& directory_path) const
+{
+   Result result{ false, 0.0, ClothInvariants() };
+   std::error_code error;
+   std::filesystem::create_directories( directory_path, error );
+   if (error) {
+      std::cerr << "Cannot create the directory: " << directory_path.string() << "\n";
+      return result;
+   }
+   // The checkpoint is read before the clock starts, and the scene is written after it, so it has the placement of
+   // the checkpoint.
+   ClothSolver solver;
+   solver.setCloth( variant.Scene.Cloth );
+   ClothParameters checkpoint_physics;
+   if (!CheckpointPath.empty() && !solver.loadCheckpoint( CheckpointPath, checkpoint_physics )) return result;
+   SceneDescription scene = variant.Scene;
+   scene.Cloth = solver.getSetup();
+   if (!SceneFile::write( (directory_path / "scene").string(), scene )) return result;
+
+   const ClothSetup& setup = solver.getSetup();
+   PointCacheWriter point_cache;
+   if (!point_cache.open( (directory_path / "cloth.pc2").string(), setup.PointNum.x * setup.PointNum.y )) {
+      return result;
+   }
+
+   // The time includes writing the point cache, as it is the part of the batch the variants share.
+   const auto start_time = std::chrono::steady_clock::now();
+   std::vector<glm::vec3> previous_points;
+   for (int i = 0; i < FrameNum; ++i) {
+      if (i == FrameNum - 1) previous_points = solver.getPoints();
+      solver.step( variant.Scene.Physics );
+      point_cache.addFrame( &solver.getPoints()[0].x, 3 );
+   }
+   point_cache.close();
+   result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+   result.Invariants = ClothInvariants::get( setup, variant.Scene.Physics, previous_points, solver.getPoints() );
+   result.Done = true;
+   return result;
+}
+
+bool ClothBatch::run(const std::string& output_directory_path, int job_num)
+{
+   if (Variants.empty()) return false;
+
+   if (job_num <= 0) job_num = std::max( static_cast<int>(std::thread::hardware_concurrency()), 1 );
+   job_num = std::min( job_num, getVariantNum() );
+   std::cout << "Running " << getVariantNum() << " variants of " << FrameNum << " frames with " << job_num
+      << " jobs...\n";
+
+   // The variants differ in their sizes, so the workers take the next one when they finish instead of a fixed share.
+   Results.assign( Variants.size(), Result{ false, 0.0, ClothInvariants() } );
+   std::atomic<int> next_index(0);
+   std::mutex output_mutex;
+   const auto work = [&]() {
+      for (int i = next_index++; i < getVariantNum(); i = next_index++) {
+         Results[i] = simulate( Variants[i], std::filesystem::path(output_directory_path) / Variants[i].Name );
+         const std::lock_guard<std::mutex> lock(output_mutex);
+         if (Results[i].Done) std::cout << " - " << Variants[i].Name << ": " << Results[i].Seconds << " s\n";
+         else std::cout << " - " << Variants[i].Name << ": failed\n";
+      }
+   };
+   const auto start_time = std::chrono::steady_clock::now();
+   std::vector<std::thread> workers;
+   for (int j = 1; j < job_num; ++j) workers.emplace_back( work );
+   work();
+   for (auto& worker : workers) worker.join();
+   const double elapsed_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+   double total_seconds = 0.0;
+   for (const auto& result : Results) total_seconds += result.Seconds;
+   std::cout << "Ran the batch in " << elapsed_time << " s, which is " << total_seconds / std::max( elapsed_time, 1e-9 )
+      << " times faster than running the variants one after another.\n";
+   return std::all_of( Results.begin(), Results.end(), [](const Result& result) { return result.Done; } );
+}
+
+bool ClothBatch::writeSummary(const std::string& file_path) const
+{
+   std::ofstream file(file_path, std::ios::trunc);
+   if (!file.is_open()) {
+      std::cerr << "Cannot write the summary: " << file_path << "\n";
+      return false;
+   }
+
+   file << "variant";
+   for (const auto& sweep : Sweeps) file << "," << sweep.Keyword;
+   file << ",frames,seconds,steps_per_second,energy,max_strain,penetration,finite\n";
+   for (size_t i = 0; i < Variants.size() && i < Results.size(); ++i) {
+      const Result& result = Results[i];
+      file << Variants[i].Name;
+      for (const auto& value : Variants[i].Values) file << "," << value;
+      file << "," << FrameNum << "," << result.Seconds << ","
+         << (result.Done ? static_cast<double>(FrameNum) / std::max( result.Seconds, 1e-9 ) : 0.0) << ","
+         << result.Invariants.Energy << "," << result.Invariants.MaxStrain << "," << result.Invariants.Penetration << ","
+         << (result.Done && result.Invariants.Finite ? 1 : 0) << "\n";
+   }
+   return static_cast<bool>(file);
+}
\ No newline at end of file
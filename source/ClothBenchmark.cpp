@@ -0,0 +1,132 @@
+#include "ClothBenchmark.h"
+
+ClothBenchmark::ClothBenchmark(Options options) : Settings( std::move( options ) )
+{
+}
+
+void ClothBenchmark::run()
+{
+#ifndef NDEBUG
+   std::cerr << "The benchmark is not an optimized build, so configure it with -DCMAKE_BUILD_TYPE=Release.\n";
+#endif
+   ClothParameters parameters;
+   for (const auto& mode : Settings.Modes) {
+      const bool gpu = mode == "gpu";
+      if (gpu && !Context.create()) {
+         std::cerr << "No OpenGL 4.6 context is available, so the GPU mode is skipped.\n";
+         continue;
+      }
+
+      std::unique_ptr<ClothSolver> solver;
+      if (!gpu) {
+         solver = std::make_unique<ClothSolver>(
+            mode == "threaded" ? ClothSolver::SolverMode::Threaded : ClothSolver::SolverMode::Serial,
+            Settings.ThreadNum
+         );
+      }
+      for (const auto& grid_size : Settings.GridSizes) {
+         for (const auto& substep_num : Settings.SubstepNums) {
+            ClothSetup setup;
+            setup.PointNum = glm::ivec2(grid_size);
+            setup.UseSphereCollider = Settings.UseSphereCollider;
+            ClothParameters substep_parameters = parameters;
+            substep_parameters.TimeStep = parameters.TimeStep / static_cast<float>(substep_num);
+
+            Result result;
+            result.Mode = mode;
+            result.GridSize = grid_size;
+            result.SubstepNum = substep_num;
+            result.ThreadNum = gpu ? 0 : solver->getThreadNum();
+            result.PointNum = static_cast<int64_t>(grid_size) * grid_size;
+            result.SpringNum = setup.getSpringNum();
+            std::cerr << "Running " << mode << " with " << grid_size << "x" << grid_size << " points and "
+               << substep_num << " sub-steps...\n";
+            if (gpu) {
+               ClothSimulatorGL simulator;
+               if (!simulator.setCloth( setup )) {
+                  std::cerr << "The cloth kernel could not be built.\n";
+                  continue;
+               }
+               measure( result, [&]() { simulator.step( substep_parameters ); }, []() { glFinish(); } );
+            }
+            else {
+               solver->setCloth( setup );
+               measure( result, [&]() { solver->step( substep_parameters ); }, []() {} );
+            }
+            Results.emplace_back( result );
+         }
+      }
+   }
+}
+
+ClothBenchmark::Statistics ClothBenchmark::getStatistics(std::vector<double> samples)
+{
+   Statistics statistics{};
+   if (samples.empty()) return statistics;
+
+   std::sort( samples.begin(), samples.end() );
+   double sum = 0.0;
+   for (const auto& sample : samples) sum += sample;
+   statistics.Mean = sum / static_cast<double>(samples.size());
+   const size_t half = samples.size() / 2;
+   statistics.Median = samples.size() % 2 == 1 ? samples[half] : 0.5 * (samples[half - 1] + samples[half]);
+   double squared_sum = 0.0;
+   for (const auto& sample : samples) squared_sum += (sample - statistics.Mean) * (sample - statistics.Mean);
+   statistics.StandardDeviation = samples.size() > 1 ? std::sqrt( squared_sum / static_cast<double>(samples.size() - 1) ) : 0.0;
+   statistics.Min = samples.front();
+   statistics.Max = samples.back();
+   return statistics;
+}
+
+bool ClothBenchmark::writeJSON(const std::string& file_path) const
+{
+   std::ofstream file;
+   if (!file_path.empty()) {
+      file.open( file_path, std::ios::trunc );
+      if (!file.is_open()) {
+         std::cerr << "Cannot write the benchmark results: " << file_path << "\n";
+         return false;
+      }
+   }
+   std::ostream& out = file_path.empty() ? std::cout : file;
+
+   // The derived rates are of the median, which is less sensitive to the outliers than the mean.
+   out << "{\n";
+   out << "  \"gpu_renderer\": ";
+   if (!Context.isCreated()) out << "null,\n";
+   else out << std::quoted( Context.getRenderer() ) << ",\n";
+#ifdef NDEBUG
+   out << "  \"optimized_build\": true,\n";
+#else
+   out << "  \"optimized_build\": false,\n";
+#endif
+   out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+   out << "  \"sphere_collider\": " << (Settings.UseSphereCollider ? "true" : "false") << ",\n";
+   out << "  \"warmup_frames\": " << Settings.WarmupFrameNum << ",\n";
+   out << "  \"frames\": " << Settings.FrameNum << ",\n";
+   out << "  \"repetitions\": " << Settings.RepetitionNum << ",\n";
+   out << "  \"results\": [";
+   for (size_t i = 0; i < Results.size(); ++i) {
+      const Result& result = Results[i];
+      const Statistics statistics = getStatistics( result.StepsPerSecond );
+      out << (i == 0 ? "\n" : ",\n") << "    {\n";
+      out << "      \"mode\": \"" << result.Mode << "\",\n";
+      out << "      \"grid_size\": " << result.GridSize << ",\n";
+      out << "      \"points\": " << result.PointNum << ",\n";
+      out << "      \"springs\": " << result.SpringNum << ",\n";
+      out << "      \"substeps\": " << result.SubstepNum << ",\n";
+      out << "      \"threads\": " << result.ThreadNum << ",\n";
+      out << "      \"steps_per_second\": { \"mean\": " << statistics.Mean << ", \"median\": " << statistics.Median
+         << ", \"stddev\": " << statistics.StandardDeviation << ", \"min\": " << statistics.Min
+         << ", \"max\": " << statistics.Max << " },\n";
+      out << "      \"steps_per_second_samples\": [";
+      for (size_t r = 0; r < result.StepsPerSecond.size(); ++r) out << (r == 0 ? "" : ", ") << result.StepsPerSecond[r];
+      out << "],\n";
+      out << "      \"particle_steps_per_second\": " << statistics.Median * static_cast<double>(result.PointNum) << ",\n";
+      out << "      \"ns_per_spring\": "
+         << (statistics.Median > 0.0 ? 1e9 / (statistics.Median * static_cast<double>(result.SpringNum)) : 0.0) << "\n";
+      out << "    }";
+   }
+   out << "\n  ]\n}\n";
+   return static_cast<bool>(out);
+}
\ No newline at end of file
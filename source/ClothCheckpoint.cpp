@@ -0,0 +1,66 @@
+#include "ClothCheckpoint.h"
+
+bool ClothCheckpoint::write(const std::string& file_path, Header header, const Ring& buffers, int stride)
+{
+   header.Magic = Magic;
+   header.Version = Version;
+   header.PointNum = static_cast<uint32_t>(buffers[0].size() / stride);
+
+   std::vector<GLfloat> values;
+   values.reserve( static_cast<size_t>(header.PointNum) * (3 * RingSize + 2) );
+   for (const auto& buffer : buffers) {
+      for (uint32_t i = 0; i < header.PointNum; ++i) {
+         const GLfloat* point = &buffer[static_cast<size_t>(i) * stride];
+         values.insert( values.end(), point, point + 3 );
+      }
+   }
+   for (uint32_t i = 0; i < header.PointNum; ++i) {
+      const GLfloat* point = &buffers[0][static_cast<size_t>(i) * stride];
+      values.insert( values.end(), point + stride - 2, point + stride );
+   }
+
+   return AtomicFile::write(
+      file_path, "checkpoint", [&header, &values](std::ofstream& file) {
+         file.write( reinterpret_cast<const char*>(&header), sizeof( Header ) );
+         file.write(
+            reinterpret_cast<const char*>(values.data()),
+            static_cast<std::streamsize>(sizeof( GLfloat ) * values.size())
+         );
+      }
+   );
+}
+
+bool ClothCheckpoint::read(const std::string& file_path, Header& header, Ring& buffers, int stride)
+{
+   std::ifstream file(file_path, std::ios::binary);
+   if (!file.is_open()) {
+      std::cerr << "Cannot open the checkpoint: " << file_path << "\n";
+      return false;
+   }
+
+   Header loaded{};
+   file.read( reinterpret_cast<char*>(&loaded), sizeof( Header ) );
+   const size_t point_num = buffers[0].size() / stride;
+   if (!file || loaded.Magic != Magic || loaded.Version != Version || loaded.PointNum != point_num ||
+       loaded.TargetIndex >= RingSize) {
+      std::cerr << "The checkpoint does not fit the cloth: " << file_path << "\n";
+      return false;
+   }
+
+   std::vector<GLfloat> values(point_num * (3 * RingSize + 2));
+   file.read( reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(sizeof( GLfloat ) * values.size()) );
+   if (!file) {
+      std::cerr << "The checkpoint is broken: " << file_path << "\n";
+      return false;
+   }
+
+   const GLfloat* value = values.data();
+   for (auto& buffer : buffers) {
+      for (size_t i = 0; i < point_num; ++i, value += 3) std::copy( value, value + 3, &buffer[i * stride] );
+   }
+   for (size_t i = 0; i < point_num; ++i, value += 2) {
+      for (auto& buffer : buffers) std::copy( value, value + 2, &buffer[i * stride + stride - 2] );
+   }
+   header = loaded;
+   return true;
+}
\ No newline at end of file
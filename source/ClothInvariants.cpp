@@ -0,0 +1,66 @@
+#include "ClothInvariants.h"
+
+ClothInvariants ClothInvariants::get(
+   const ClothSetup& setup,
+   const ClothParameters& parameters,
+   const std::vector<glm::vec3>& previous_points,
+   const std::vector<glm::vec3>& points
+)
+{
+   // The springs are taken once from the point on their left or top, with the rest lengths of the kernel.
+   struct Spring
+   {
+      glm::ivec2 Offset;
+      float Stiffness;
+      float RestLength;
+   };
+
+   const float rest_length = setup.getSpringRestLength();
+   const std::array<Spring, 6> springs = {
+      Spring{ { 1, 0 }, parameters.SpringStiffness, rest_length },
+      Spring{ { 0, 1 }, parameters.SpringStiffness, rest_length },
+      Spring{ { 1, 1 }, parameters.ShearStiffness, rest_length },
+      Spring{ { -1, 1 }, parameters.ShearStiffness, rest_length },
+      Spring{ { 2, 0 }, parameters.FlexionStiffness, 2.0f * rest_length },
+      Spring{ { 0, 2 }, parameters.FlexionStiffness, 2.0f * rest_length }
+   };
+   const glm::vec3 sphere_center = glm::vec3(setup.SphereWorldMatrix * glm::vec4(setup.SpherePosition, 1.0f));
+   const int cols = setup.PointNum.x;
+   const int rows = setup.PointNum.y;
+
+   // The solvers work in the local space of the cloth, which the world matrix only moves, and the height of the
+   // gravitational energy is measured from the floor.
+   ClothInvariants invariants;
+   for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < cols; ++x) {
+         const int index = y * cols + x;
+         const glm::vec3& point = points[index];
+         if (!std::isfinite( point.x ) || !std::isfinite( point.y ) || !std::isfinite( point.z )) {
+            invariants.Finite = false;
+            continue;
+         }
+
+         const glm::vec3 point_in_wc = glm::vec3(setup.ClothWorldMatrix * glm::vec4(point, 1.0f));
+         const glm::vec3 velocity = (point - previous_points[index]) / parameters.TimeStep;
+         invariants.Energy += 0.5 * parameters.Mass * glm::dot( velocity, velocity );
+         invariants.Energy -= parameters.Mass * parameters.GravityConstant * point_in_wc.y;
+         for (size_t s = 0; s < springs.size(); ++s) {
+            const int nx = x + springs[s].Offset.x;
+            const int ny = y + springs[s].Offset.y;
+            if (nx < 0 || nx >= cols || ny >= rows) continue;
+
+            const float length = glm::length( point - points[ny * cols + nx] );
+            const float stretch = length - springs[s].RestLength;
+            invariants.Energy += 0.5 * springs[s].Stiffness * stretch * stretch;
+            if (s < 2) invariants.MaxStrain = std::max( invariants.MaxStrain, stretch / springs[s].RestLength );
+         }
+
+         invariants.Penetration = std::max( invariants.Penetration, -point_in_wc.y );
+         if (setup.UseSphereCollider) {
+            const float depth = setup.SphereRadius - glm::length( point_in_wc - sphere_center );
+            invariants.Penetration = std::max( invariants.Penetration, depth );
+         }
+      }
+   }
+   return invariants;
+}
\ No newline at end of file
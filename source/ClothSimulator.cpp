@@ -0,0 +1,127 @@
+#include "ClothSimulator.h"
+
+ClothSimulatorGL::ClothSimulatorGL() : TargetIndex( 0 ), Buffers{}, Shader( std::make_unique<ShaderGL>() )
+{
+}
+
+ClothSimulatorGL::~ClothSimulatorGL()
+{
+   deleteBuffers();
+}
+
+void ClothSimulatorGL::deleteBuffers()
+{
+   if (Buffers[0] != 0) {
+      GPUMemoryGL::removeBuffers( 3, Buffers.data() );
+      glDeleteBuffers( 3, Buffers.data() );
+   }
+   Buffers.fill( 0 );
+}
+
+bool ClothSimulatorGL::setCloth(const ClothSetup& setup)
+{
+   Setup = setup;
+   TargetIndex = 0;
+
+   const std::string shader_directory_path = std::string(CMAKE_SOURCE_DIR) + "/shaders";
+   const ShaderGL::DefineSet defines = {
+      { "WORKGROUP_SIZE_X", std::to_string( WorkGroupSize ) },
+      { "WORKGROUP_SIZE_Y", std::to_string( WorkGroupSize ) },
+      { "CLOTH_POINT_NUM_X", std::to_string( Setup.PointNum.x ) },
+      { "CLOTH_POINT_NUM_Y", std::to_string( Setup.PointNum.y ) },
+      { "USE_SPHERE_COLLIDER", Setup.UseSphereCollider ? "1" : "0" }
+   };
+   Shader->setComputeShaders( { std::string(shader_directory_path + "/ClothSimulator.comp").c_str() }, { defines } );
+   if (Shader->getComputeShaderProgram( 0 ) == 0) return false;
+
+   for (const auto& name : {
+      "SpringRestLength", "SpringStiffness", "SpringDamping", "ShearRestLength", "ShearStiffness", "ShearDamping",
+      "FlexionRestLength", "FlexionStiffness", "FlexionDamping", "GravityConstant", "GravityDamping", "dt", "Mass",
+      "ClothWorldMatrix", "SpherePosition", "SphereRadius", "SphereWorldMatrix"
+   }) Shader->addUniformLocationToComputeShader( name, 0 );
+
+   std::vector<glm::vec3> points;
+   std::vector<glm::vec2> texture_coordinates;
+   Setup.buildPoints( points, texture_coordinates );
+   std::vector<GLfloat> data;
+   data.reserve( points.size() * PointStride );
+   for (size_t i = 0; i < points.size(); ++i) {
+      const glm::vec3& p = points[i];
+      const glm::vec2& t = texture_coordinates[i];
+      data.insert( data.end(), { p.x, p.y, p.z, 0.0f, 1.0f, 0.0f, t.x, t.y } );
+   }
+
+   deleteBuffers();
+   const auto size = static_cast<GLsizeiptr>(sizeof( GLfloat ) * data.size());
+   if (!GPUMemoryGL::fits( 3 * size )) {
+      std::cerr << "The cloth of " << Setup.PointNum.x << "x" << Setup.PointNum.y
+         << " points exceeds the GPU memory budget.\n";
+      return false;
+   }
+   glCreateBuffers( 3, Buffers.data() );
+   for (int i = 0; i < 3; ++i) {
+      glNamedBufferStorage( Buffers[i], size, data.data(), GL_DYNAMIC_STORAGE_BIT );
+      const std::string label = "points " + std::to_string( i );
+      GPUMemoryGL::addBuffer( Buffers[i], GPUMemoryGL::Category::Storage, size, "ClothSimulator", label );
+   }
+   return true;
+}
+
+void ClothSimulatorGL::step(const ClothParameters& parameters)
+{
+   const float rest_length = Setup.getSpringRestLength();
+   glUseProgram( Shader->getComputeShaderProgram( 0 ) );
+   glUniform1f( Shader->getLocation( "SpringRestLength" ), rest_length );
+   glUniform1f( Shader->getLocation( "SpringStiffness" ), parameters.SpringStiffness );
+   glUniform1f( Shader->getLocation( "SpringDamping" ), parameters.SpringDamping );
+   glUniform1f( Shader->getLocation( "ShearRestLength" ), 1.5f * rest_length );
+   glUniform1f( Shader->getLocation( "ShearStiffness" ), parameters.ShearStiffness );
+   glUniform1f( Shader->getLocation( "ShearDamping" ), parameters.ShearDamping );
+   glUniform1f( Shader->getLocation( "FlexionRestLength" ), 2.0f * rest_length );
+   glUniform1f( Shader->getLocation( "FlexionStiffness" ), parameters.FlexionStiffness );
+   glUniform1f( Shader->getLocation( "FlexionDamping" ), parameters.FlexionDamping );
+   glUniform1f( Shader->getLocation( "GravityConstant" ), parameters.GravityConstant );
+   glUniform1f( Shader->getLocation( "GravityDamping" ), parameters.GravityDamping );
+   glUniform1f( Shader->getLocation( "dt" ), parameters.TimeStep );
+   glUniform1f( Shader->getLocation( "Mass" ), parameters.Mass );
+   glUniformMatrix4fv( Shader->getLocation( "ClothWorldMatrix" ), 1, GL_FALSE, &Setup.ClothWorldMatrix[0][0] );
+   glUniform3fv( Shader->getLocation( "SpherePosition" ), 1, &Setup.SpherePosition[0] );
+   glUniform1f( Shader->getLocation( "SphereRadius" ), Setup.SphereRadius );
+   glUniformMatrix4fv( Shader->getLocation( "SphereWorldMatrix" ), 1, GL_FALSE, &Setup.SphereWorldMatrix[0][0] );
+
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 0, Buffers[TargetIndex] );
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 1, Buffers[(TargetIndex + 1) % 3] );
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 2, Buffers[(TargetIndex + 2) % 3] );
+   glDispatchCompute(
+      (Setup.PointNum.x + WorkGroupSize - 1) / WorkGroupSize,
+      (Setup.PointNum.y + WorkGroupSize - 1) / WorkGroupSize,
+      1
+   );
+   glMemoryBarrier( GL_SHADER_STORAGE_BARRIER_BIT );
+   TargetIndex = (TargetIndex + 1) % 3;
+}
+
+void ClothSimulatorGL::getPoints(std::vector<glm::vec3>& points) const
+{
+   std::vector<GLfloat> data(static_cast<size_t>(getPointNum()) * PointStride);
+   glMemoryBarrier( GL_BUFFER_UPDATE_BARRIER_BIT );
+   glGetNamedBufferSubData( Buffers[(TargetIndex + 1) % 3], 0, sizeof( GLfloat ) * data.size(), data.data() );
+
+   points.resize( getPointNum() );
+   for (size_t i = 0; i < points.size(); ++i) points[i] = glm::make_vec3( &data[i * PointStride] );
+}
+
+void ClothSimulatorGL::setPoints(const std::vector<glm::vec3>& previous_points, const std::vector<glm::vec3>& points)
+{
+   assert( previous_points.size() == points.size() && points.size() == static_cast<size_t>(getPointNum()) );
+
+   // The normals and the texture coordinates are kept, so only the positions are scattered into the buffers.
+   std::vector<GLfloat> data(static_cast<size_t>(getPointNum()) * PointStride);
+   const auto size = static_cast<GLsizeiptr>(sizeof( GLfloat ) * data.size());
+   glMemoryBarrier( GL_BUFFER_UPDATE_BARRIER_BIT );
+   glGetNamedBufferSubData( Buffers[(TargetIndex + 1) % 3], 0, size, data.data() );
+   VertexLayout::scatter<3>( data.data(), PointStride, 0, points.size(), glm::value_ptr( previous_points[0] ) );
+   glNamedBufferSubData( Buffers[TargetIndex], 0, size, data.data() );
+   VertexLayout::scatter<3>( data.data(), PointStride, 0, points.size(), glm::value_ptr( points[0] ) );
+   glNamedBufferSubData( Buffers[(TargetIndex + 1) % 3], 0, size, data.data() );
+}
\ No newline at end of file
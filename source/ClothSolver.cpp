@@ -0,0 +1,225 @@
+#include "ClothSolver.h"
+
+ClothSolver::ClothSolver(SolverMode mode, int thread_num) :
+   Mode( mode ), TargetIndex( 0 ), Constants{}, Generation( 0 ), RunningWorkerNum( 0 ), Stop( false )
+{
+   if (Mode == SolverMode::Threaded) {
+      if (thread_num <= 0) thread_num = std::max( static_cast<int>(std::thread::hardware_concurrency()), 1 );
+      // The calling thread takes the first rows, so it needs one worker less.
+      for (int i = 1; i < thread_num; ++i) Workers.emplace_back( &ClothSolver::work, this, i );
+   }
+}
+
+ClothSolver::~ClothSolver()
+{
+   {
+      std::lock_guard<std::mutex> lock( Mutex );
+      Stop = true;
+   }
+   Condition.notify_all();
+   for (auto& worker : Workers) worker.join();
+}
+
+void ClothSolver::setCloth(const ClothSetup& setup)
+{
+   Setup = setup;
+   TargetIndex = 0;
+
+   std::vector<glm::vec3> points;
+   Setup.buildPoints( points, TextureCoordinates );
+   Points.fill( points );
+}
+
+void ClothSolver::setPoints(const std::vector<glm::vec3>& previous_points, const std::vector<glm::vec3>& points)
+{
+   assert( previous_points.size() == points.size() && points.size() == static_cast<size_t>(getPointNum()) );
+   Points[TargetIndex] = previous_points;
+   Points[(TargetIndex + 1) % 3] = points;
+}
+
+bool ClothSolver::saveCheckpoint(const std::string& file_path, const ClothParameters& parameters) const
+{
+   ClothCheckpoint::Ring buffers;
+   for (int i = 0; i < ClothCheckpoint::RingSize; ++i) {
+      buffers[i].reserve( static_cast<size_t>(CheckpointPointStride) * getPointNum() );
+      for (int j = 0; j < getPointNum(); ++j) {
+         const glm::vec3& point = Points[i][j];
+         const glm::vec2& texture_coordinate = TextureCoordinates[j];
+         buffers[i].insert(
+            buffers[i].end(), { point.x, point.y, point.z, texture_coordinate.x, texture_coordinate.y }
+         );
+      }
+   }
+
+   ClothCheckpoint::Header header{};
+   header.TargetIndex = TargetIndex;
+   header.Parameters = parameters;
+   header.ClothWorldMatrix = Setup.ClothWorldMatrix;
+   header.SphereWorldMatrix = Setup.SphereWorldMatrix;
+   header.SpherePosition = Setup.SpherePosition;
+   header.SphereRadius = Setup.SphereRadius;
+   return ClothCheckpoint::write( file_path, header, buffers, CheckpointPointStride );
+}
+
+bool ClothSolver::loadCheckpoint(const std::string& file_path, ClothParameters& parameters)
+{
+   ClothCheckpoint::Ring buffers;
+   for (auto& buffer : buffers) buffer.resize( static_cast<size_t>(CheckpointPointStride) * getPointNum() );
+   ClothCheckpoint::Header header{};
+   if (!ClothCheckpoint::read( file_path, header, buffers, CheckpointPointStride )) return false;
+
+   for (int i = 0; i < ClothCheckpoint::RingSize; ++i) {
+      for (int j = 0; j < getPointNum(); ++j) {
+         const GLfloat* point = &buffers[i][static_cast<size_t>(j) * CheckpointPointStride];
+         Points[i][j] = glm::vec3(point[0], point[1], point[2]);
+         TextureCoordinates[j] = glm::vec2(point[3], point[4]);
+      }
+   }
+   TargetIndex = header.TargetIndex;
+   Setup.ClothWorldMatrix = header.ClothWorldMatrix;
+   Setup.SphereWorldMatrix = header.SphereWorldMatrix;
+   Setup.SpherePosition = header.SpherePosition;
+   Setup.SphereRadius = header.SphereRadius;
+   parameters = header.Parameters;
+   return true;
+}
+
+glm::ivec2 ClothSolver::getRows(int worker_index) const
+{
+   const int thread_num = getThreadNum();
+   const int rows = Setup.PointNum.y;
+   return { rows * worker_index / thread_num, rows * (worker_index + 1) / thread_num };
+}
+
+glm::vec3 ClothSolver::solvePoint(int x, int y) const
+{
+   const std::vector<glm::vec3>& prev_points = Points[TargetIndex];
+   const std::vector<glm::vec3>& curr_points = Points[(TargetIndex + 1) % 3];
+   const int cols = Setup.PointNum.x;
+   const int rows = Setup.PointNum.y;
+   const int index = y * cols + x;
+   const float dt = Constants.TimeStep;
+
+   const glm::vec3 p_curr = curr_points[index];
+   const glm::vec3 velocity = (p_curr - prev_points[index]) / dt;
+
+   glm::vec3 force(0.0f);
+   for (const auto& neighbor : Neighbors) {
+      const int nx = x + neighbor.Offset.x;
+      const int ny = y + neighbor.Offset.y;
+      if (nx < 0 || nx >= cols || ny < 0 || ny >= rows) continue;
+
+      const int n = ny * cols + nx;
+      const auto type = static_cast<int>(neighbor.Type);
+      const glm::vec3 neighbor_velocity = (curr_points[n] - prev_points[n]) / dt;
+      const glm::vec3 dl = p_curr - curr_points[n];
+      const glm::vec3 dv = velocity - neighbor_velocity;
+      const float l = glm::length( dl );
+      const float spring_force = Constants.Stiffness[type] * (Constants.RestLength[type] - l);
+      const float damping_force = Constants.Damping[type] * glm::dot( dl, dv ) / l;
+      force += (spring_force + damping_force) * glm::normalize( dl );
+   }
+   force += Constants.Mass * Constants.Gravity + velocity * Constants.GravityDamping;
+
+   bool to_be_moved = true;
+   if (Setup.UseSphereCollider) {
+      constexpr float epsilon = 0.0005f;
+      const glm::vec3 d = glm::vec3(Constants.ClothToWorld * glm::vec4(p_curr, 1.0f)) - Constants.SphereCenter;
+      if (glm::length( d ) < Constants.SphereRadius + epsilon) {
+         const glm::vec3 normal = glm::normalize( d );
+         const glm::vec3 tangent = glm::normalize( glm::cross( glm::cross( normal, force ), normal ) );
+         const float normal_force = std::max( glm::dot( force, -normal ), 0.0f );
+         const float horizontal_force = std::max( glm::dot( force, tangent ), 0.0f );
+         if (normal_force > 0.0f) {
+            const float friction = 0.5f * normal_force;
+            force = std::max( horizontal_force - friction, 0.0f ) * tangent;
+            to_be_moved = glm::length( force ) > 0.0f;
+         }
+      }
+   }
+
+   const glm::vec3 acceleration = force / Constants.Mass;
+   glm::vec3 updated = p_curr + velocity * dt + acceleration * dt * dt;
+
+   bool collided = false;
+   if (Setup.UseSphereCollider) {
+      constexpr float epsilon = 0.05f;
+      glm::vec4 updated_in_wc = Constants.ClothToWorld * glm::vec4(updated, 1.0f);
+      const glm::vec3 d = glm::vec3(updated_in_wc) - Constants.SphereCenter;
+      const float distance = glm::length( d );
+      if (distance < Constants.SphereRadius + epsilon) {
+         updated_in_wc += glm::vec4((Constants.SphereRadius - distance) * glm::normalize( d ), 0.0f);
+         updated = glm::vec3(Constants.WorldToCloth * updated_in_wc);
+         collided = true;
+      }
+   }
+   if (!collided && !to_be_moved) updated = p_curr;
+   if ((Constants.ClothToWorld * glm::vec4(updated, 1.0f)).y < 0.0f) updated.y = p_curr.y;
+   return updated;
+}
+
+void ClothSolver::solveRows(int begin_row, int end_row)
+{
+   std::vector<glm::vec3>& next_points = Points[(TargetIndex + 2) % 3];
+   for (int j = begin_row; j < end_row; ++j) {
+      for (int i = 0; i < Setup.PointNum.x; ++i) {
+         next_points[static_cast<size_t>(j) * Setup.PointNum.x + i] = solvePoint( i, j );
+      }
+   }
+}
+
+void ClothSolver::work(int worker_index)
+{
+   ZoneProfiler::setThreadName( "ClothSolver" );
+   uint64_t solved_generation = 0;
+   while (true) {
+      {
+         std::unique_lock<std::mutex> lock( Mutex );
+         Condition.wait( lock, [this, solved_generation]() { return Stop || Generation != solved_generation; } );
+         if (Stop) return;
+         solved_generation = Generation;
+      }
+
+      const glm::ivec2 rows = getRows( worker_index );
+      solveRows( rows.x, rows.y );
+
+      std::lock_guard<std::mutex> lock( Mutex );
+      if (--RunningWorkerNum == 0) Condition.notify_all();
+   }
+}
+
+void ClothSolver::step(const ClothParameters& parameters)
+{
+   const ZoneProfiler::Zone zone( "stepCloth" );
+
+   // The shear springs take the structural rest length as the kernel does.
+   const float rest_length = Setup.getSpringRestLength();
+   Constants.Stiffness = { parameters.SpringStiffness, parameters.ShearStiffness, parameters.FlexionStiffness };
+   Constants.RestLength = { rest_length, rest_length, 2.0f * rest_length };
+   Constants.Damping = { parameters.SpringDamping, parameters.ShearDamping, parameters.FlexionDamping };
+   Constants.Gravity = glm::vec3(0.0f, parameters.GravityConstant, 0.0f);
+   Constants.GravityDamping = parameters.GravityDamping;
+   Constants.TimeStep = parameters.TimeStep;
+   Constants.Mass = parameters.Mass;
+   Constants.ClothToWorld = Setup.ClothWorldMatrix;
+   Constants.WorldToCloth = glm::inverse( Setup.ClothWorldMatrix );
+   Constants.SphereCenter = glm::vec3(Setup.SphereWorldMatrix * glm::vec4(Setup.SpherePosition, 1.0f));
+   Constants.SphereRadius = Setup.SphereRadius;
+
+   if (Workers.empty()) solveRows( 0, Setup.PointNum.y );
+   else {
+      {
+         std::lock_guard<std::mutex> lock( Mutex );
+         RunningWorkerNum = static_cast<int>(Workers.size());
+         Generation++;
+      }
+      Condition.notify_all();
+
+      const glm::ivec2 rows = getRows( 0 );
+      solveRows( rows.x, rows.y );
+
+      std::unique_lock<std::mutex> lock( Mutex );
+      Condition.wait( lock, [this]() { return RunningWorkerNum == 0; } );
+   }
+   TargetIndex = (TargetIndex + 1) % 3;
+}
\ No newline at end of file
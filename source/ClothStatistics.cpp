@@ -0,0 +1,84 @@
+#include "ClothStatistics.h"
+
+ClothStatisticsGL::ClothStatisticsGL() : PointNum( 0 ), TileNum( 0 ), CounterBuffer( 0 ), Latest{}
+{
+}
+
+ClothStatisticsGL::~ClothStatisticsGL()
+{
+   Readback.reset();
+   if (CounterBuffer != 0) {
+      GPUMemoryGL::removeBuffers( 1, &CounterBuffer );
+      glDeleteBuffers( 1, &CounterBuffer );
+   }
+}
+
+void ClothStatisticsGL::prepare(int point_num, int tile_num)
+{
+   PointNum = point_num;
+   TileNum = tile_num;
+   Latest = {};
+   Steps.clear();
+   if (CounterBuffer != 0) return;
+
+   const Counters zero{};
+   glCreateBuffers( 1, &CounterBuffer );
+   glNamedBufferStorage( CounterBuffer, sizeof( Counters ), &zero, GL_DYNAMIC_STORAGE_BIT );
+   GPUMemoryGL::addBuffer( CounterBuffer, GPUMemoryGL::Category::Storage, sizeof( Counters ), "ClothStatistics", "counters" );
+   Readback = std::make_unique<BufferReadbackGL>(
+      static_cast<GLsizeiptr>(sizeof( Counters )),
+      [this](const uint8_t* data) {
+         std::memcpy( &Latest, data, sizeof( Counters ) );
+         Steps.emplace_back( Latest );
+      }
+   );
+}
+
+void ClothStatisticsGL::bind() const
+{
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, CounterBinding, CounterBuffer );
+}
+
+void ClothStatisticsGL::request()
+{
+   // The counters are copied before they are cleared for the next step, as the commands run in order.
+   Readback->request( CounterBuffer );
+   glClearNamedBufferData( CounterBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr );
+}
+
+std::array<uint32_t, 5> ClothStatisticsGL::toArray(const Counters& counters)
+{
+   return {
+      counters.MovedPoints, counters.EvaluatedSprings, counters.CollisionTests, counters.Contacts, counters.AwakeTiles
+   };
+}
+
+std::array<double, 5> ClothStatisticsGL::getRollingAverage() const
+{
+   std::array<double, 5> average{};
+   const size_t step_num = std::min( Steps.size(), static_cast<size_t>(RollingStepNum) );
+   if (step_num == 0) return average;
+
+   for (size_t i = Steps.size() - step_num; i < Steps.size(); ++i) {
+      const std::array<uint32_t, 5> counters = toArray( Steps[i] );
+      for (size_t c = 0; c < counters.size(); ++c) average[c] += counters[c];
+   }
+   for (auto& value : average) value /= static_cast<double>(step_num);
+   return average;
+}
+
+bool ClothStatisticsGL::writeCSV(const std::string& file_path) const
+{
+   std::ofstream file(file_path, std::ios::trunc);
+   if (!file.is_open()) {
+      std::cerr << "Cannot write the statistics: " << file_path << "\n";
+      return false;
+   }
+
+   file << "step,points,moved_points,evaluated_springs,collision_tests,contacts,tiles,awake_tiles\n";
+   for (size_t i = 0; i < Steps.size(); ++i) {
+      file << i << "," << PointNum << "," << Steps[i].MovedPoints << "," << Steps[i].EvaluatedSprings << ","
+         << Steps[i].CollisionTests << "," << Steps[i].Contacts << "," << TileNum << "," << Steps[i].AwakeTiles << "\n";
+   }
+   return static_cast<bool>(file);
+}
\ No newline at end of file
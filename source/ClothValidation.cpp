@@ -0,0 +1,321 @@
+#include "ClothValidation.h"
+
+ClothValidation::ClothValidation(Options options) : Settings( std::move( options ) )
+{
+}
+
+ClothSetup ClothValidation::getSetup(int grid_size, bool use_sphere_collider)
+{
+   ClothSetup setup;
+   setup.PointNum = glm::ivec2(grid_size);
+   setup.UseSphereCollider = use_sphere_collider;
+   return setup;
+}
+
+ClothValidation::Result ClothValidation::getEmptyResult(const std::string& solver, int grid_size)
+{
+   return { solver, grid_size, 0.0f, 0.0f, 0.0, 0.0f, 0.0f, -1, "" };
+}
+
+void ClothValidation::fail(Result& result, int step, const std::string& failure)
+{
+   if (result.FailedStep >= 0) return;
+   result.FailedStep = step;
+   result.Failure = failure;
+}
+
+void ClothValidation::checkInvariants(
+   Result& result,
+   int step,
+   const ClothInvariants& invariants,
+   double initial_energy,
+   float rest_length
+) const
+{
+   // The springs and the gravity are damped, so the energy must not grow beyond the initial one.
+   if (!invariants.Finite) fail( result, step, "the points are not finite" );
+   else if (invariants.MaxStrain > Settings.MaxStrain) {
+      fail( result, step, "the strain " + std::to_string( invariants.MaxStrain ) + " is too large" );
+   }
+   else if (invariants.Penetration > Settings.MaxPenetration * rest_length) {
+      fail( result, step, "the penetration " + std::to_string( invariants.Penetration ) + " is too deep" );
+   }
+   else if (invariants.Energy > initial_energy + Settings.MaxEnergyGain * std::abs( initial_energy )) {
+      fail( result, step, "the energy grows to " + std::to_string( invariants.Energy ) );
+   }
+}
+
+void ClothValidation::compareInvariants(
+   Result& result,
+   int step,
+   const ClothInvariants& invariants,
+   const ClothInvariants& reference,
+   double initial_energy,
+   float rest_length
+) const
+{
+   const double energy_error = std::abs( invariants.Energy - reference.Energy ) / std::abs( initial_energy );
+   const float strain_error = std::abs( invariants.MaxStrain - reference.MaxStrain );
+   const float penetration_error = std::abs( invariants.Penetration - reference.Penetration ) / rest_length;
+   result.MaxEnergyError = std::max( result.MaxEnergyError, energy_error );
+   result.MaxStrainError = std::max( result.MaxStrainError, strain_error );
+   result.MaxPenetrationError = std::max( result.MaxPenetrationError, penetration_error );
+   if (energy_error > Settings.EnergyTolerance) {
+      fail( result, step, "the energy differs by " + std::to_string( energy_error ) );
+   }
+   else if (strain_error > Settings.StrainTolerance) {
+      fail( result, step, "the strain differs by " + std::to_string( strain_error ) );
+   }
+   else if (penetration_error > Settings.PenetrationTolerance) {
+      fail( result, step, "the penetration differs by " + std::to_string( penetration_error ) );
+   }
+}
+
+void ClothValidation::comparePoints(Result& result, int step, const Run& run, const Run& reference, float rest_length) const
+{
+   float max_deviation = 0.0f;
+   double squared_sum = 0.0;
+   for (size_t i = 0; i < reference.Points.size(); ++i) {
+      const float deviation = glm::length( run.Points[i] - reference.Points[i] ) / rest_length;
+      max_deviation = std::max( max_deviation, deviation );
+      squared_sum += static_cast<double>(deviation) * deviation;
+   }
+   // A NaN deviation is not larger than any tolerance, so it is caught by the invariants instead.
+   if (max_deviation > result.MaxDeviation) {
+      result.MaxDeviation = max_deviation;
+      result.RMSDeviation = static_cast<float>(std::sqrt( squared_sum / static_cast<double>(reference.Points.size()) ));
+   }
+   if (max_deviation > Settings.PositionTolerance) {
+      fail( result, step, "a point deviates by " + std::to_string( max_deviation ) );
+   }
+}
+
+bool ClothValidation::createRun(Run& run, const std::string& solver, const ClothSetup& setup) const
+{
+   if (solver == "gpu") {
+      run.GPU = std::make_unique<ClothSimulatorGL>();
+      if (!run.GPU->setCloth( setup )) return false;
+   }
+   else {
+      run.CPU = std::make_unique<ClothSolver>(
+         solver == "threaded" ? ClothSolver::SolverMode::Threaded : ClothSolver::SolverMode::Serial,
+         Settings.ThreadNum
+      );
+      run.CPU->setCloth( setup );
+   }
+   return true;
+}
+
+void ClothValidation::step(Run& run) const
+{
+   std::swap( run.PreviousPoints, run.Points );
+   if (run.CPU != nullptr) {
+      run.CPU->step( Parameters );
+      run.Points = run.CPU->getPoints();
+   }
+   else {
+      run.GPU->step( Parameters );
+      run.GPU->getPoints( run.Points );
+   }
+}
+
+void ClothValidation::validate(int grid_size)
+{
+   const ClothSetup setup = getSetup( grid_size, Settings.UseSphereCollider );
+   const float rest_length = setup.getSpringRestLength();
+
+   Run reference;
+   Result reference_result = getEmptyResult( "serial", grid_size );
+   if (!createRun( reference, "serial", setup )) return;
+   // The previous points of the first step are the initial ones, as the solvers start at rest.
+   reference.Points = reference.CPU->getPoints();
+   reference.PreviousPoints = reference.Points;
+
+   std::vector<std::string> solvers = { "threaded" };
+   if (Context.isCreated()) solvers.emplace_back( "gpu" );
+   std::vector<Candidate> candidates;
+   std::vector<Result> results;
+   for (const auto& solver : solvers) {
+      Candidate candidate;
+      candidate.Solver = solver;
+      if (!createRun( candidate.Free, solver, setup ) || !createRun( candidate.Synced, solver, setup )) {
+         Results.emplace_back( getEmptyResult( solver, grid_size ) );
+         fail( Results.back(), 0, "the solver could not be created" );
+         continue;
+      }
+      candidate.Free.Points = reference.Points;
+      candidate.Synced.Points = reference.Points;
+      candidates.emplace_back( std::move( candidate ) );
+      results.emplace_back( getEmptyResult( solver, grid_size ) );
+   }
+   const auto baseline = BaselineInvariants.find( grid_size );
+   Result baseline_result = getEmptyResult( "baseline", grid_size );
+
+   std::vector<ClothInvariants>& reference_invariants = ReferenceInvariants[grid_size];
+   reference_invariants.clear();
+   reference_invariants.emplace_back( ClothInvariants::get( setup, Parameters, reference.Points, reference.Points ) );
+   const double initial_energy = reference_invariants[0].Energy;
+   for (int s = 1; s <= Settings.StepNum; ++s) {
+      for (auto& candidate : candidates) {
+         if (candidate.Synced.CPU != nullptr) candidate.Synced.CPU->setPoints( reference.PreviousPoints, reference.Points );
+         else candidate.Synced.GPU->setPoints( reference.PreviousPoints, reference.Points );
+         candidate.Synced.Points = reference.Points;
+         step( candidate.Synced );
+         step( candidate.Free );
+      }
+      step( reference );
+
+      reference_invariants.emplace_back( ClothInvariants::get( setup, Parameters, reference.PreviousPoints, reference.Points ) );
+      checkInvariants( reference_result, s, reference_invariants[s], initial_energy, rest_length );
+      for (size_t i = 0; i < candidates.size(); ++i) {
+         const Run& run = candidates[i].Free;
+         const ClothInvariants invariants = ClothInvariants::get( setup, Parameters, run.PreviousPoints, run.Points );
+         checkInvariants( results[i], s, invariants, initial_energy, rest_length );
+         compareInvariants( results[i], s, invariants, reference_invariants[s], initial_energy, rest_length );
+         comparePoints( results[i], s, candidates[i].Synced, reference, rest_length );
+      }
+
+      if (baseline != BaselineInvariants.end()) {
+         if (s < static_cast<int>(baseline->second.size())) {
+            compareInvariants(
+               baseline_result, s, reference_invariants[s], baseline->second[s], baseline->second[0].Energy, rest_length
+            );
+         }
+         else fail( baseline_result, s, "the baseline has no more steps" );
+      }
+   }
+
+   Results.emplace_back( reference_result );
+   Results.insert( Results.end(), results.begin(), results.end() );
+   if (baseline != BaselineInvariants.end()) Results.emplace_back( baseline_result );
+}
+
+void ClothValidation::validateCheckpoint(int grid_size)
+{
+   const ClothSetup setup = getSetup( grid_size, Settings.UseSphereCollider );
+   Result result = getEmptyResult( "checkpoint", grid_size );
+   const std::filesystem::path checkpoint_path =
+      std::filesystem::temp_directory_path() / ("ClothValidation_" + std::to_string( grid_size ) + ".checkpoint");
+
+   // It is saved halfway, so the cloth is already moving, and a step later if the ring is in the order of the start.
+   int saved_step = Settings.StepNum / 2;
+   if (saved_step % 3 == 0) saved_step++;
+   ClothSolver saved;
+   saved.setCloth( setup );
+   for (int s = 1; s <= saved_step; ++s) saved.step( Parameters );
+
+   ClothSolver restored;
+   restored.setCloth( setup );
+   ClothParameters restored_parameters;
+   if (!saved.saveCheckpoint( checkpoint_path.string(), Parameters )) {
+      fail( result, saved_step, "the checkpoint is not saved" );
+   }
+   else if (!restored.loadCheckpoint( checkpoint_path.string(), restored_parameters )) {
+      fail( result, saved_step, "the checkpoint is not restored" );
+   }
+   else if (std::memcmp( &restored_parameters, &Parameters, sizeof( ClothParameters ) ) != 0) {
+      fail( result, saved_step, "the parameters are not restored" );
+   }
+   std::error_code error;
+   std::filesystem::remove( checkpoint_path, error );
+
+   const float rest_length = setup.getSpringRestLength();
+   for (int s = saved_step + 1; s <= Settings.StepNum && result.FailedStep < 0; ++s) {
+      saved.step( Parameters );
+      restored.step( restored_parameters );
+      const std::vector<glm::vec3>& points = restored.getPoints();
+      const std::vector<glm::vec3>& reference = saved.getPoints();
+      for (size_t i = 0; i < reference.size(); ++i) {
+         result.MaxDeviation = std::max( result.MaxDeviation, glm::length( points[i] - reference[i] ) / rest_length );
+      }
+      if (std::memcmp( points.data(), reference.data(), sizeof( glm::vec3 ) * reference.size() ) != 0) {
+         fail( result, s, "the restored solver differs from the saved one" );
+      }
+   }
+   Results.emplace_back( result );
+}
+
+bool ClothValidation::run()
+{
+   if (!Context.create()) {
+      std::cerr << "No OpenGL 4.6 context is available, so the GPU solver is not validated.\n";
+      if (Settings.RequireGPU) return false;
+   }
+
+   for (const auto& grid_size : Settings.GridSizes) {
+      std::cerr << "Validating " << grid_size << "x" << grid_size << " points over " << Settings.StepNum << " steps...\n";
+      validate( grid_size );
+      validateCheckpoint( grid_size );
+   }
+   return std::all_of( Results.begin(), Results.end(), [](const Result& result) { return result.FailedStep < 0; } );
+}
+
+bool ClothValidation::readBaseline(const std::string& file_path)
+{
+   std::ifstream file(file_path);
+   if (!file.is_open()) {
+      std::cerr << "Cannot read the baseline: " << file_path << "\n";
+      return false;
+   }
+
+   std::string line;
+   std::getline( file, line );
+   if (line != "grid_size,step,energy,max_strain,penetration") {
+      std::cerr << "The baseline has an unknown format: " << file_path << "\n";
+      return false;
+   }
+   BaselineInvariants.clear();
+   while (std::getline( file, line )) {
+      std::istringstream stream(line);
+      int grid_size, step;
+      ClothInvariants invariants;
+      char comma;
+      stream >> grid_size >> comma >> step >> comma >> invariants.Energy >> comma >> invariants.MaxStrain >> comma
+         >> invariants.Penetration;
+      std::vector<ClothInvariants>& steps = BaselineInvariants[grid_size];
+      if (!stream || step != static_cast<int>(steps.size())) {
+         std::cerr << "The baseline is broken at: " << line << "\n";
+         return false;
+      }
+      steps.emplace_back( invariants );
+   }
+   return true;
+}
+
+bool ClothValidation::writeBaseline(const std::string& file_path) const
+{
+   std::ofstream file(file_path, std::ios::trunc);
+   if (!file.is_open()) {
+      std::cerr << "Cannot write the baseline: " << file_path << "\n";
+      return false;
+   }
+
+   file << "grid_size,step,energy,max_strain,penetration\n";
+   file << std::setprecision( std::numeric_limits<double>::max_digits10 );
+   for (const auto& [grid_size, steps] : ReferenceInvariants) {
+      for (size_t step = 0; step < steps.size(); ++step) {
+         file << grid_size << "," << step << "," << steps[step].Energy << "," << steps[step].MaxStrain << ","
+            << steps[step].Penetration << "\n";
+      }
+   }
+   return static_cast<bool>(file);
+}
+
+void ClothValidation::printResults() const
+{
+   if (Context.isCreated()) std::cout << "GPU: " << Context.getRenderer() << "\n";
+   std::cout << "The deviations are in the rest length of a spring, and the energy error is in the initial energy.\n";
+   std::cout << std::left << std::setw( 10 ) << "Solver" << std::right << std::setw( 6 ) << "Grid"
+      << std::setw( 15 ) << "Max deviation" << std::setw( 15 ) << "RMS deviation" << std::setw( 14 ) << "Energy error"
+      << std::setw( 14 ) << "Strain error" << std::setw( 19 ) << "Penetration error" << "  Result\n";
+   for (const auto& result : Results) {
+      std::cout << std::left << std::setw( 10 ) << result.Solver << std::right << std::setw( 6 ) << result.GridSize
+         << std::scientific << std::setprecision( 3 ) << std::setw( 15 ) << result.MaxDeviation
+         << std::setw( 15 ) << result.RMSDeviation << std::setw( 14 ) << result.MaxEnergyError
+         << std::setw( 14 ) << result.MaxStrainError << std::setw( 19 ) << result.MaxPenetrationError;
+      std::cout.unsetf( std::ios::floatfield );
+      if (result.FailedStep < 0) std::cout << "  pass\n";
+      else std::cout << "  FAIL at step " << result.FailedStep << ": " << result.Failure << "\n";
+   }
+   std::cout << std::setprecision( 6 );
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "FrameCapture.h"
+
+FrameCaptureGL::FrameCaptureGL() :
+   Format( CaptureFormat::Y4M ), Width( 0 ), Height( 0 ), FrameNum( 0 ), WrittenFrameNum( 0 ), DroppedFrameNum( 0 ),
+   Stop( false ), PackBuffer( 0 ), SlotSize( 0 ), Data( nullptr ), OldestSlot( 0 ), PendingSlotNum( 0 ), Fences{}
+{
+}
+
+FrameCaptureGL::~FrameCaptureGL()
+{
+   stop();
+}
+
+bool FrameCaptureGL::start(const std::string& directory_path, CaptureFormat format, int width, int height, int fps)
+{
+   stop();
+
+   std::error_code error;
+   std::filesystem::create_directories( directory_path, error );
+   if (error) {
+      std::cerr << "Cannot create the capture directory: " << directory_path << "\n";
+      return false;
+   }
+
+   DirectoryPath = directory_path;
+   Format = format;
+   Width = width;
+   Height = height;
+   if (Format != CaptureFormat::PNG) {
+      const std::string file_path = DirectoryPath + (Format == CaptureFormat::Raw ? "/capture.rgb" : "/capture.y4m");
+      File.open( file_path, std::ios::binary | std::ios::trunc );
+      if (!File.is_open()) {
+         std::cerr << "Cannot write the capture: " << file_path << "\n";
+         return false;
+      }
+      if (Format == CaptureFormat::Y4M) {
+         File << "YUV4MPEG2 W" << Width << " H" << Height << " F" << fps << ":1 Ip A1:1 C420jpeg\n";
+      }
+   }
+
+   // RGBA keeps the rows aligned to 4 bytes, so the pack alignment does not have to be changed.
+   const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+   SlotSize = static_cast<GLsizeiptr>(4) * Width * Height;
+   glCreateBuffers( 1, &PackBuffer );
+   glNamedBufferStorage( PackBuffer, SlotSize * SlotNum, nullptr, flags | GL_CLIENT_STORAGE_BIT );
+   GPUMemoryGL::addBuffer( PackBuffer, GPUMemoryGL::Category::Transfer, SlotSize * SlotNum, "FrameCapture", "pack slots" );
+   Data = static_cast<const uint8_t*>(glMapNamedBufferRange( PackBuffer, 0, SlotSize * SlotNum, flags ));
+
+   FrameNum = 0;
+   WrittenFrameNum = 0;
+   DroppedFrameNum = 0;
+   Stop = false;
+   OldestSlot = 0;
+   PendingSlotNum = 0;
+   Writer = std::thread( &FrameCaptureGL::write, this );
+   return true;
+}
+
+bool FrameCaptureGL::deliverOldest(GLuint64 timeout)
+{
+   GLsync& fence = Fences[OldestSlot];
+   const GLenum result = glClientWaitSync( fence, timeout > 0 ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout );
+   if (result == GL_TIMEOUT_EXPIRED) return false;
+
+   // The pixels of a failed wait cannot be trusted, so the frame is dropped, and the slot is freed for the next one.
+   glDeleteSync( fence );
+   fence = nullptr;
+   if (result == GL_WAIT_FAILED) {
+      DroppedFrameNum++;
+      std::cerr << "The capture failed to wait for GPU, so a frame is dropped (" << DroppedFrameNum << " so far).\n";
+   }
+   else {
+      const uint8_t* pixels = Data + SlotSize * OldestSlot;
+      {
+         std::unique_lock<std::mutex> lock( Mutex );
+         Condition.wait( lock, [this]() { return static_cast<int>(PendingFrames.size()) < MaxPendingFrameNum; } );
+         PendingFrames.emplace_back( pixels, pixels + SlotSize );
+      }
+      Condition.notify_all();
+   }
+   OldestSlot = (OldestSlot + 1) % SlotNum;
+   PendingSlotNum--;
+   return true;
+}
+
+void FrameCaptureGL::capture()
+{
+   if (!isCapturing()) return;
+
+   const ZoneProfiler::Zone zone( "capture" );
+   while (PendingSlotNum > 0) {
+      if (!deliverOldest( 0 )) break;
+   }
+   // Only a timeout keeps a slot pending, which the longest wait never gives.
+   while (PendingSlotNum == SlotNum) {
+      if (!deliverOldest( std::numeric_limits<GLuint64>::max() )) return;
+   }
+
+   const int slot = (OldestSlot + PendingSlotNum) % SlotNum;
+   glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffer );
+   glReadPixels( 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<GLvoid*>(SlotSize * slot) );
+   glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+   Fences[slot] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+   PendingSlotNum++;
+   FrameNum++;
+}
+
+void FrameCaptureGL::stop()
+{
+   if (!isCapturing()) return;
+
+   while (PendingSlotNum > 0) {
+      if (!deliverOldest( std::numeric_limits<GLuint64>::max() )) break;
+   }
+   {
+      std::lock_guard<std::mutex> lock( Mutex );
+      Stop = true;
+   }
+   Condition.notify_all();
+   Writer.join();
+   if (File.is_open()) File.close();
+
+   for (auto& fence : Fences) {
+      if (fence != nullptr) glDeleteSync( fence );
+      fence = nullptr;
+   }
+   glUnmapNamedBuffer( PackBuffer );
+   GPUMemoryGL::removeBuffers( 1, &PackBuffer );
+   glDeleteBuffers( 1, &PackBuffer );
+   PackBuffer = 0;
+   Data = nullptr;
+}
+
+void FrameCaptureGL::write()
+{
+   ZoneProfiler::setThreadName( "FrameCapture" );
+   while (true) {
+      std::vector<uint8_t> rgba;
+      {
+         std::unique_lock<std::mutex> lock( Mutex );
+         Condition.wait( lock, [this]() { return Stop || !PendingFrames.empty(); } );
+         if (PendingFrames.empty()) return;
+         rgba = std::move( PendingFrames.front() );
+         PendingFrames.pop_front();
+      }
+      Condition.notify_all();
+      writeFrame( rgba, WrittenFrameNum++ );
+   }
+}
+
+void FrameCaptureGL::writeFrame(const std::vector<uint8_t>& rgba, int frame_index)
+{
+   const ZoneProfiler::Zone zone( "writeFrame" );
+   switch (Format) {
+      case CaptureFormat::Raw:
+         writeRaw( rgba );
+         break;
+      case CaptureFormat::PNG:
+         writePNG( rgba, frame_index );
+         break;
+      case CaptureFormat::Y4M:
+         writeY4M( rgba );
+         break;
+   }
+}
+
+void FrameCaptureGL::writeRaw(const std::vector<uint8_t>& rgba)
+{
+   // The rows of OpenGL start from the bottom, so they are flipped.
+   std::vector<uint8_t> rgb(static_cast<size_t>(3) * Width * Height);
+   for (int j = 0; j < Height; ++j) {
+      const uint8_t* source = rgba.data() + static_cast<size_t>(4) * Width * (Height - 1 - j);
+      uint8_t* target = rgb.data() + static_cast<size_t>(3) * Width * j;
+      for (int i = 0; i < Width; ++i) std::memcpy( target + 3 * i, source + 4 * i, 3 );
+   }
+   File.write( reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()) );
+}
+
+void FrameCaptureGL::writePNG(const std::vector<uint8_t>& rgba, int frame_index) const
+{
+   // FreeImage also stores the rows from the bottom, so they are not flipped.
+   FIBITMAP* image = FreeImage_Allocate( Width, Height, 24 );
+   for (int j = 0; j < Height; ++j) {
+      const uint8_t* source = rgba.data() + static_cast<size_t>(4) * Width * j;
+      uint8_t* target = FreeImage_GetScanLine( image, j );
+      for (int i = 0; i < Width; ++i) {
+         target[3 * i + FI_RGBA_RED] = source[4 * i];
+         target[3 * i + FI_RGBA_GREEN] = source[4 * i + 1];
+         target[3 * i + FI_RGBA_BLUE] = source[4 * i + 2];
+      }
+   }
+
+   std::ostringstream file_name;
+   file_name << "/frame" << std::setw( 6 ) << std::setfill( '0' ) << frame_index << ".png";
+   if (!FreeImage_Save( FIF_PNG, image, std::string(DirectoryPath + file_name.str()).c_str() )) {
+      std::cerr << "Could not write the frame " << frame_index << "\n";
+   }
+   FreeImage_Unload( image );
+}
+
+void FrameCaptureGL::writeY4M(const std::vector<uint8_t>& rgba)
+{
+   // The full-range BT.601 of JPEG, and each chroma is the average of 2x2 pixels.
+   const int chroma_width = (Width + 1) / 2;
+   const int chroma_height = (Height + 1) / 2;
+   std::vector<uint8_t> planes(static_cast<size_t>(Width) * Height + static_cast<size_t>(2) * chroma_width * chroma_height);
+   uint8_t* y_plane = planes.data();
+   uint8_t* u_plane = y_plane + static_cast<size_t>(Width) * Height;
+   uint8_t* v_plane = u_plane + static_cast<size_t>(chroma_width) * chroma_height;
+   const auto get_pixel = [&](int x, int y) {
+      const uint8_t* pixel = rgba.data() + 4 * (static_cast<size_t>(Height - 1 - y) * Width + x);
+      return glm::vec3(pixel[0], pixel[1], pixel[2]);
+   };
+   const auto to_byte = [](float value) { return static_cast<uint8_t>(std::clamp( std::lround( value ), 0l, 255l )); };
+
+   for (int j = 0; j < Height; ++j) {
+      for (int i = 0; i < Width; ++i) {
+         const glm::vec3 pixel = get_pixel( i, j );
+         y_plane[static_cast<size_t>(j) * Width + i] = to_byte( 0.299f * pixel.r + 0.587f * pixel.g + 0.114f * pixel.b );
+      }
+   }
+   for (int j = 0; j < chroma_height; ++j) {
+      for (int i = 0; i < chroma_width; ++i) {
+         const int x0 = 2 * i, x1 = std::min( 2 * i + 1, Width - 1 );
+         const int y0 = 2 * j, y1 = std::min( 2 * j + 1, Height - 1 );
+         const glm::vec3 pixel = 0.25f * (get_pixel( x0, y0 ) + get_pixel( x1, y0 ) + get_pixel( x0, y1 ) + get_pixel( x1, y1 ));
+         const size_t index = static_cast<size_t>(j) * chroma_width + i;
+         u_plane[index] = to_byte( 128.0f - 0.168736f * pixel.r - 0.331264f * pixel.g + 0.5f * pixel.b );
+         v_plane[index] = to_byte( 128.0f + 0.5f * pixel.r - 0.418688f * pixel.g - 0.081312f * pixel.b );
+      }
+   }
+   File << "FRAME\n";
+   File.write( reinterpret_cast<const char*>(planes.data()), static_cast<std::streamsize>(planes.size()) );
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "FramePacer.h"
+
+FramePacerGL::FramePacerGL() :
+   Mode( PacingMode::VSync ), FramesInFlight( 2 ), TargetInterval( 0 ), HasPendingInput( false ), OldestSlot( 0 ),
+   PendingNum( 0 ), BlockedFrameNum( 0 ), Frames{}
+{
+}
+
+FramePacerGL::~FramePacerGL()
+{
+   for (auto& frame : Frames) {
+      if (frame.Fence != nullptr) glDeleteSync( frame.Fence );
+      if (frame.Query != 0) glDeleteQueries( 1, &frame.Query );
+   }
+}
+
+void FramePacerGL::setMode(PacingMode mode, double target_rate)
+{
+   Mode = mode;
+   TargetInterval = Mode == PacingMode::Fixed && target_rate > 0.0 ?
+      std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / target_rate)) :
+      Clock::duration::zero();
+}
+
+void FramePacerGL::markInput()
+{
+   if (HasPendingInput) return;
+
+   HasPendingInput = true;
+   PendingCallbackTime = Clock::now();
+   PendingPollTime = LastPollTime == Clock::time_point() ? PendingCallbackTime : LastPollTime;
+}
+
+FramePacerGL::Clock::time_point FramePacerGL::getPresentTime(GLuint query)
+{
+   // The fence after the query has signaled, so the result is available without waiting.
+   GLuint64 present_timestamp = 0;
+   glGetQueryObjectui64v( query, GL_QUERY_RESULT, &present_timestamp );
+   GLint64 gpu_now = 0;
+   glGetInteger64v( GL_TIMESTAMP, &gpu_now );
+   const Clock::time_point cpu_now = Clock::now();
+   return cpu_now - std::chrono::nanoseconds(gpu_now - static_cast<GLint64>(present_timestamp));
+}
+
+bool FramePacerGL::retireOldest(GLuint64 timeout)
+{
+   FrameInFlight& frame = Frames[OldestSlot];
+   const GLenum result = glClientWaitSync( frame.Fence, timeout > 0 ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout );
+   if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) return false;
+
+   if (frame.HasInput) {
+      const Clock::time_point present_time = getPresentTime( frame.Query );
+      PollLatencies.emplace_back( std::chrono::duration<double, std::milli>(present_time - frame.PollTime).count() );
+      CallbackLatencies.emplace_back(
+         std::chrono::duration<double, std::milli>(present_time - frame.CallbackTime).count()
+      );
+   }
+   glDeleteSync( frame.Fence );
+   frame.Fence = nullptr;
+   frame.HasInput = false;
+   OldestSlot = (OldestSlot + 1) % MaxFramesInFlight;
+   PendingNum--;
+   return true;
+}
+
+void FramePacerGL::waitForDeadline()
+{
+   const Clock::time_point now = Clock::now();
+   if (Deadline == Clock::time_point() || now - Deadline > TargetInterval) {
+      // It starts over from now after the first frame or a stall, rather than rushing the missed frames.
+      Deadline = now;
+   }
+   else if (now < Deadline) {
+      if (Deadline - now > SpinMargin) std::this_thread::sleep_for( Deadline - now - SpinMargin );
+      while (Clock::now() < Deadline) std::this_thread::yield();
+   }
+   Deadline += TargetInterval;
+}
+
+void FramePacerGL::beginFrame()
+{
+   while (PendingNum > 0) {
+      if (!retireOldest( 0 )) break;
+   }
+   if (PendingNum >= FramesInFlight) {
+      BlockedFrameNum++;
+      while (PendingNum >= FramesInFlight) {
+         if (!retireOldest( std::numeric_limits<GLuint64>::max() )) break;
+      }
+   }
+   if (Mode == PacingMode::Fixed && TargetInterval > Clock::duration::zero()) waitForDeadline();
+
+   const Clock::time_point now = Clock::now();
+   if (LastFrameTime != Clock::time_point()) {
+      FrameIntervals.emplace_back( std::chrono::duration<double, std::milli>(now - LastFrameTime).count() );
+   }
+   LastFrameTime = now;
+}
+
+void FramePacerGL::endFrame()
+{
+   // The slots are as many as the limit allows, so a slot is always free after beginFrame.
+   if (PendingNum == MaxFramesInFlight && !retireOldest( std::numeric_limits<GLuint64>::max() )) return;
+
+   FrameInFlight& frame = Frames[(OldestSlot + PendingNum) % MaxFramesInFlight];
+   frame.HasInput = HasPendingInput;
+   if (frame.HasInput) {
+      if (frame.Query == 0) glCreateQueries( GL_TIMESTAMP, 1, &frame.Query );
+      glQueryCounter( frame.Query, GL_TIMESTAMP );
+      frame.PollTime = PendingPollTime;
+      frame.CallbackTime = PendingCallbackTime;
+   }
+   frame.Fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+   HasPendingInput = false;
+   PendingNum++;
+}
+
+void FramePacerGL::finish()
+{
+   while (PendingNum > 0) {
+      if (!retireOldest( std::numeric_limits<GLuint64>::max() )) break;
+   }
+   for (auto& frame : Frames) {
+      if (frame.Query != 0) glDeleteQueries( 1, &frame.Query );
+      frame.Query = 0;
+   }
+}
+
+const char* FramePacerGL::getModeName(PacingMode mode)
+{
+   switch (mode) {
+      case PacingMode::VSync: return "vsync";
+      case PacingMode::Uncapped: return "uncapped";
+      case PacingMode::Fixed: return "fixed";
+      default: return "";
+   }
+}
+
+double FramePacerGL::getPercentile(const std::vector<double>& sorted_times, double percentile)
+{
+   const auto index = static_cast<size_t>(percentile * static_cast<double>(sorted_times.size() - 1) + 0.5);
+   return sorted_times[std::min( index, sorted_times.size() - 1 )];
+}
+
+void FramePacerGL::printTimes(const std::string& name, std::vector<double> times)
+{
+   if (times.empty()) return;
+
+   double sum = 0.0;
+   for (const auto& time : times) sum += time;
+   std::sort( times.begin(), times.end() );
+   std::cout << "  " << std::left << std::setw( 20 ) << name << std::right << std::fixed << std::setprecision( 3 )
+      << std::setw( 9 ) << sum / static_cast<double>(times.size())
+      << std::setw( 9 ) << getPercentile( times, 0.5 )
+      << std::setw( 9 ) << getPercentile( times, 0.95 )
+      << std::setw( 9 ) << getPercentile( times, 0.99 )
+      << std::setw( 9 ) << times.back()
+      << std::setw( 10 ) << times.size() << "\n";
+   std::cout.unsetf( std::ios::floatfield );
+   std::cout << std::setprecision( 6 );
+}
+
+void FramePacerGL::printSummary() const
+{
+   std::cout << "Frame Pacing: " << getModeName( Mode );
+   if (Mode == PacingMode::Fixed && TargetInterval > Clock::duration::zero()) {
+      std::cout << " at " << 1.0 / std::chrono::duration<double>(TargetInterval).count() << " frames/s";
+   }
+   std::cout << ", " << FramesInFlight << " frames in flight, " << BlockedFrameNum << " frames waited for GPU\n";
+   if (FrameIntervals.empty()) return;
+
+   std::cout << "Frame Pacing (ms)        mean      p50      p95      p99      max   samples\n";
+   printTimes( "frame interval", FrameIntervals );
+   printTimes( "input to present", PollLatencies );
+   printTimes( "handled to present", CallbackLatencies );
+   if (!PollLatencies.empty()) {
+      std::cout << "  (an input is timed from the previous poll, as GLFW gives no time of an event, and from its callback;"
+         << " the true latency lies between the two, and the scan-out adds at most a refresh interval)\n";
+   }
+}
\ No newline at end of file
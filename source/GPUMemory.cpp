@@ -0,0 +1,122 @@
+#include "GPUMemory.h"
+
+void GPUMemoryGL::add(
+   GLenum identifier,
+   GLuint name,
+   Category category,
+   GLsizeiptr size,
+   const std::string& owner,
+   const std::string& label
+)
+{
+   if (name == 0) return;
+
+   // The name can only be reused after it is deleted, so a recorded one was deleted without being removed.
+   remove( identifier, 1, &name );
+   const std::string object_label = owner + " " + label;
+   glObjectLabel( identifier, name, -1, object_label.c_str() );
+   Resources[{ identifier, name }] = { category, static_cast<int64_t>(size), owner, label };
+
+   const bool was_over_budget = isOverBudget();
+   Usage& usage = Usages[static_cast<int>(category)];
+   usage.Count++;
+   usage.Size += size;
+   usage.PeakSize = std::max( usage.PeakSize, usage.Size );
+   TotalSize += size;
+   PeakTotalSize = std::max( PeakTotalSize, TotalSize );
+   if (!was_over_budget && isOverBudget()) {
+      std::cerr << "The GPU memory exceeds the budget of " << toMiB( Budget ) << " MiB with " << object_label
+         << " of " << toMiB( size ) << " MiB.\n";
+   }
+}
+
+void GPUMemoryGL::remove(GLenum identifier, GLsizei n, const GLuint* names)
+{
+   for (GLsizei i = 0; i < n; ++i) {
+      const auto it = Resources.find( { identifier, names[i] } );
+      if (it == Resources.end()) continue;
+
+      Usage& usage = Usages[static_cast<int>(it->second.Type)];
+      usage.Count--;
+      usage.Size -= it->second.Size;
+      TotalSize -= it->second.Size;
+      Resources.erase( it );
+   }
+}
+
+void GPUMemoryGL::addBuffer(
+   GLuint buffer,
+   Category category,
+   GLsizeiptr size,
+   const std::string& owner,
+   const std::string& label
+)
+{
+   add( GL_BUFFER, buffer, category, size, owner, label );
+}
+
+void GPUMemoryGL::addTexture(GLuint texture, GLsizeiptr size, const std::string& owner, const std::string& label)
+{
+   add( GL_TEXTURE, texture, Category::Texture, size, owner, label );
+}
+
+void GPUMemoryGL::addRenderbuffer(GLuint renderbuffer, GLsizeiptr size, const std::string& owner, const std::string& label)
+{
+   add( GL_RENDERBUFFER, renderbuffer, Category::Renderbuffer, size, owner, label );
+}
+
+void GPUMemoryGL::setTextureOwner(GLuint texture, const std::string& owner, const std::string& label)
+{
+   const auto it = Resources.find( { GL_TEXTURE, texture } );
+   if (it == Resources.end()) return;
+
+   it->second.Owner = owner;
+   it->second.Label = label;
+   const std::string object_label = owner + " " + label;
+   glObjectLabel( GL_TEXTURE, texture, -1, object_label.c_str() );
+}
+
+void GPUMemoryGL::removeBuffers(GLsizei n, const GLuint* buffers)
+{
+   remove( GL_BUFFER, n, buffers );
+}
+
+void GPUMemoryGL::removeTextures(GLsizei n, const GLuint* textures)
+{
+   remove( GL_TEXTURE, n, textures );
+}
+
+void GPUMemoryGL::removeRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+   remove( GL_RENDERBUFFER, n, renderbuffers );
+}
+
+void GPUMemoryGL::printReport()
+{
+   std::cout << "GPU memory (MiB):\n";
+   std::cout << std::left << std::setw( 14 ) << "Category" << std::right << std::setw( 8 ) << "Objects"
+      << std::setw( 12 ) << "Current" << std::setw( 12 ) << "Peak" << "\n";
+   std::cout << std::fixed << std::setprecision( 3 );
+   for (int i = 0; i < CategoryNum; ++i) {
+      if (Usages[i].PeakSize == 0) continue;
+      std::cout << std::left << std::setw( 14 ) << CategoryNames[i] << std::right << std::setw( 8 ) << Usages[i].Count
+         << std::setw( 12 ) << toMiB( Usages[i].Size ) << std::setw( 12 ) << toMiB( Usages[i].PeakSize ) << "\n";
+   }
+   std::cout << std::left << std::setw( 14 ) << "total" << std::right << std::setw( 8 ) << Resources.size()
+      << std::setw( 12 ) << toMiB( TotalSize ) << std::setw( 12 ) << toMiB( PeakTotalSize ) << "\n";
+   if (Budget > 0) std::cout << "Budget: " << toMiB( Budget ) << " MiB\n";
+   std::cout.unsetf( std::ios::floatfield );
+   std::cout << std::setprecision( 6 );
+}
+
+int GPUMemoryGL::reportLeaks()
+{
+   if (Resources.empty()) return 0;
+
+   std::cerr << Resources.size() << " GPU objects of " << toMiB( TotalSize ) << " MiB are not deleted:\n";
+   for (const auto& [key, resource] : Resources) {
+      std::cerr << " - " << CategoryNames[static_cast<int>(resource.Type)] << " " << key.second << ": "
+         << resource.Owner << " " << resource.Label << " (" << resource.Size << " bytes)\n";
+   }
+   return static_cast<int>(Resources.size());
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "GPUProfiler.h"
+
+GPUProfilerGL::GPUProfilerGL() : Enabled( false ), FrameIndex( -1 ), DroppedFrameNum( 0 )
+{
+}
+
+GPUProfilerGL::~GPUProfilerGL()
+{
+   for (auto& frame : Frames) {
+      if (!frame.Queries.empty()) glDeleteQueries( static_cast<GLsizei>(frame.Queries.size()), frame.Queries.data() );
+   }
+}
+
+GLuint GPUProfilerGL::getQuery(FrameQueries& frame)
+{
+   // The queries of a slot are reused when it comes back, so they are created only for the new scopes.
+   if (frame.UsedQueryNum == static_cast<int>(frame.Queries.size())) {
+      GLuint query;
+      glCreateQueries( GL_TIMESTAMP, 1, &query );
+      frame.Queries.emplace_back( query );
+   }
+   return frame.Queries[frame.UsedQueryNum++];
+}
+
+bool GPUProfilerGL::collect(FrameQueries& frame, bool wait)
+{
+   if (!frame.Pending) return true;
+
+   // The timestamps are written in order, so all of them are available if the last one is.
+   if (!wait && !frame.Scopes.empty()) {
+      GLuint available = GL_FALSE;
+      glGetQueryObjectuiv( frame.Queries[frame.UsedQueryNum - 1], GL_QUERY_RESULT_AVAILABLE, &available );
+      if (available == GL_FALSE) return false;
+   }
+
+   for (const auto& scope : frame.Scopes) {
+      GLuint64 begin_time = 0, end_time = 0;
+      glGetQueryObjectui64v( scope.BeginQuery, GL_QUERY_RESULT, &begin_time );
+      glGetQueryObjectui64v( scope.EndQuery, GL_QUERY_RESULT, &end_time );
+      Samples.emplace_back(
+         frame.FrameIndex,
+         scope.NameIndex,
+         scope.Depth,
+         static_cast<double>(end_time - begin_time) * 1e-6
+      );
+   }
+   while (!Samples.empty() && Samples.front().FrameIndex <= frame.FrameIndex - MaxSampleFrameNum) Samples.pop_front();
+   frame.Pending = false;
+   return true;
+}
+
+void GPUProfilerGL::beginFrame()
+{
+   if (!Enabled) return;
+
+   FrameIndex++;
+   FrameQueries& frame = getCurrentFrame();
+   if (!collect( frame, false )) DroppedFrameNum++;
+   frame.FrameIndex = FrameIndex;
+   frame.Pending = false;
+   frame.UsedQueryNum = 0;
+   frame.Scopes.clear();
+   OpenScopes.clear();
+   beginScope( "Frame" );
+}
+
+void GPUProfilerGL::endFrame()
+{
+   if (!Enabled || FrameIndex < 0) return;
+
+   while (!OpenScopes.empty()) endScope();
+   getCurrentFrame().Pending = true;
+}
+
+void GPUProfilerGL::beginScope(const std::string& name)
+{
+   if (!Enabled || FrameIndex < 0) return;
+
+   auto name_index = NameIndices.find( name );
+   if (name_index == NameIndices.end()) {
+      name_index = NameIndices.emplace( name, static_cast<int>(Names.size()) ).first;
+      Names.emplace_back( name );
+   }
+
+   FrameQueries& frame = getCurrentFrame();
+   const GLuint query = getQuery( frame );
+   glQueryCounter( query, GL_TIMESTAMP );
+   OpenScopes.emplace_back( static_cast<int>(frame.Scopes.size()) );
+   frame.Scopes.emplace_back( name_index->second, static_cast<int>(OpenScopes.size()) - 1, query, 0 );
+}
+
+void GPUProfilerGL::endScope()
+{
+   if (!Enabled || OpenScopes.empty()) return;
+
+   FrameQueries& frame = getCurrentFrame();
+   const GLuint query = getQuery( frame );
+   glQueryCounter( query, GL_TIMESTAMP );
+   frame.Scopes[OpenScopes.back()].EndQuery = query;
+   OpenScopes.pop_back();
+}
+
+void GPUProfilerGL::finish()
+{
+   if (!Enabled) return;
+
+   // The frames are collected in order, starting from the oldest one in the ring.
+   for (int i = 1; i <= FrameLatency; ++i) {
+      FrameQueries& frame = Frames[(FrameIndex + i) % FrameLatency];
+      static_cast<void>(collect( frame, true ));
+   }
+}
+
+double GPUProfilerGL::getPercentile(std::vector<double>& sorted_times, double percentile)
+{
+   const auto index = static_cast<size_t>(percentile * static_cast<double>(sorted_times.size() - 1) + 0.5);
+   return sorted_times[std::min( index, sorted_times.size() - 1 )];
+}
+
+void GPUProfilerGL::printSummary() const
+{
+   if (Samples.empty()) return;
+
+   std::cout << "GPU Time (ms)            mean      p50      p95      p99      max   rolling\n";
+   for (size_t n = 0; n < Names.size(); ++n) {
+      std::vector<double> times;
+      double rolling_sum = 0.0;
+      int rolling_num = 0;
+      for (const auto& sample : Samples) {
+         if (sample.NameIndex != static_cast<int>(n)) continue;
+
+         times.emplace_back( sample.Milliseconds );
+         if (sample.FrameIndex > FrameIndex - RollingFrameNum) {
+            rolling_sum += sample.Milliseconds;
+            rolling_num++;
+         }
+      }
+      if (times.empty()) continue;
+
+      double sum = 0.0;
+      for (const auto& time : times) sum += time;
+      std::sort( times.begin(), times.end() );
+      std::cout << "  " << std::left << std::setw( 20 ) << Names[n] << std::right << std::fixed << std::setprecision( 3 )
+         << std::setw( 9 ) << sum / static_cast<double>(times.size())
+         << std::setw( 9 ) << getPercentile( times, 0.5 )
+         << std::setw( 9 ) << getPercentile( times, 0.95 )
+         << std::setw( 9 ) << getPercentile( times, 0.99 )
+         << std::setw( 9 ) << times.back()
+         << std::setw( 10 ) << (rolling_num > 0 ? rolling_sum / rolling_num : 0.0) << "\n";
+   }
+   std::cout.unsetf( std::ios::floatfield );
+   std::cout << std::setprecision( 6 );
+   if (DroppedFrameNum > 0) std::cout << "  (" << DroppedFrameNum << " frames were not ready in time and dropped)\n";
+   if (FrameIndex >= MaxSampleFrameNum) std::cout << "  (only the last " << MaxSampleFrameNum << " frames are kept)\n";
+}
+
+bool GPUProfilerGL::writeCSV(const std::string& file_path) const
+{
+   std::ofstream file(file_path, std::ios::trunc);
+   if (!file.is_open()) {
+      std::cerr << "Cannot write the GPU profile: " << file_path << "\n";
+      return false;
+   }
+
+   file << "frame,scope,depth,milliseconds\n";
+   for (const auto& sample : Samples) {
+      file << sample.FrameIndex << "," << Names[sample.NameIndex] << "," << sample.Depth << "," << sample.Milliseconds << "\n";
+   }
+   return static_cast<bool>(file);
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "IndirectDraw.h"
+
+IndirectDrawGL::IndirectDrawGL() : CommandBuffer( 0 ), BoundingSphereBuffer( 0 )
+{
+}
+
+IndirectDrawGL::~IndirectDrawGL()
+{
+   deleteBuffers();
+}
+
+void IndirectDrawGL::deleteBuffers()
+{
+   if (CommandBuffer != 0) {
+      GPUMemoryGL::removeBuffers( 1, &CommandBuffer );
+      glDeleteBuffers( 1, &CommandBuffer );
+   }
+   if (BoundingSphereBuffer != 0) {
+      GPUMemoryGL::removeBuffers( 1, &BoundingSphereBuffer );
+      glDeleteBuffers( 1, &BoundingSphereBuffer );
+   }
+}
+
+int IndirectDrawGL::addObject(const std::vector<DrawElementsCommand>& commands)
+{
+   const auto object_index = static_cast<GLuint>(BoundingSpheres.size());
+   Ranges.emplace_back( static_cast<GLsizei>(Commands.size()), static_cast<GLsizei>(commands.size()) );
+   for (const auto& command : commands) {
+      Commands.emplace_back( command );
+      Commands.back().BaseInstance = object_index;
+   }
+   BoundingSpheres.emplace_back( 0.0f );
+   BoundingSpheresOnGPU.emplace_back( false );
+   return static_cast<int>(object_index);
+}
+
+void IndirectDrawGL::setCommands(int object_index, const std::vector<DrawElementsCommand>& commands)
+{
+   const CommandRange& range = Ranges[object_index];
+   assert( static_cast<GLsizei>(commands.size()) == range.Count );
+
+   for (GLsizei i = 0; i < range.Count; ++i) {
+      Commands[range.First + i] = commands[i];
+      Commands[range.First + i].BaseInstance = static_cast<GLuint>(object_index);
+   }
+   if (CommandBuffer != 0) {
+      glNamedBufferSubData(
+         CommandBuffer,
+         static_cast<GLintptr>(sizeof( DrawElementsCommand ) * range.First),
+         static_cast<GLsizeiptr>(sizeof( DrawElementsCommand ) * range.Count),
+         &Commands[range.First]
+      );
+   }
+}
+
+void IndirectDrawGL::setBoundingSphere(int object_index, const glm::vec4& sphere_in_wc)
+{
+   BoundingSpheres[object_index] = sphere_in_wc;
+}
+
+void IndirectDrawGL::bindBoundingSpheres() const
+{
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, BoundingSphereBinding, BoundingSphereBuffer );
+}
+
+void IndirectDrawGL::prepareBuffers()
+{
+   deleteBuffers();
+
+   const auto command_size = static_cast<GLsizeiptr>(sizeof( DrawElementsCommand ) * Commands.size());
+   glCreateBuffers( 1, &CommandBuffer );
+   glNamedBufferStorage( CommandBuffer, command_size, Commands.data(), GL_DYNAMIC_STORAGE_BIT );
+   GPUMemoryGL::addBuffer( CommandBuffer, GPUMemoryGL::Category::Indirect, command_size, "IndirectDraw", "commands" );
+   const auto sphere_size = static_cast<GLsizeiptr>(sizeof( glm::vec4 ) * BoundingSpheres.size());
+   glCreateBuffers( 1, &BoundingSphereBuffer );
+   glNamedBufferStorage( BoundingSphereBuffer, sphere_size, BoundingSpheres.data(), GL_DYNAMIC_STORAGE_BIT );
+   GPUMemoryGL::addBuffer(
+      BoundingSphereBuffer, GPUMemoryGL::Category::Storage, sphere_size, "IndirectDraw", "bounding spheres"
+   );
+}
+
+void IndirectDrawGL::cull() const
+{
+   // The culling program should be in use with the frustum planes set.
+   // Only the bounding spheres are uploaded per frame, so the cost does not depend on the number of commands,
+   // and the ones written on GPU are left as they are.
+   for (size_t i = 0; i < BoundingSpheres.size(); ++i) {
+      if (BoundingSpheresOnGPU[i]) continue;
+
+      glNamedBufferSubData(
+         BoundingSphereBuffer,
+         static_cast<GLintptr>(sizeof( glm::vec4 ) * i),
+         sizeof( glm::vec4 ),
+         &BoundingSpheres[i]
+      );
+   }
+   bindBoundingSpheres();
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, CommandBinding, CommandBuffer );
+
+   const auto command_num = static_cast<GLuint>(Commands.size());
+   glDispatchCompute( (command_num + CullingWorkGroupSize - 1) / CullingWorkGroupSize, 1, 1 );
+   glMemoryBarrier( GL_COMMAND_BARRIER_BIT );
+}
+
+void IndirectDrawGL::draw(int object_index, GLenum draw_mode) const
+{
+   const CommandRange& range = Ranges[object_index];
+   glBindBuffer( GL_DRAW_INDIRECT_BUFFER, CommandBuffer );
+   glMultiDrawElementsIndirect(
+      draw_mode,
+      GL_UNSIGNED_INT,
+      reinterpret_cast<GLvoid*>(range.First * sizeof( DrawElementsCommand )),
+      range.Count,
+      0
+   );
+   glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+}
\ No newline at end of file
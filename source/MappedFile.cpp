@@ -0,0 +1,97 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() :
+   IsOpen( false ), Data( nullptr ), Size( 0 ), FileHandle( INVALID_HANDLE_VALUE ), MappingHandle( nullptr )
+{
+}
+#else
+MappedFile::MappedFile() : IsOpen( false ), Data( nullptr ), Size( 0 ), FileDescriptor( -1 )
+{
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+   close();
+}
+
+bool MappedFile::open(const std::string& file_path)
+{
+   close();
+#ifdef _WIN32
+   FileHandle = CreateFileA(
+      file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+   );
+   if (FileHandle == INVALID_HANDLE_VALUE) return false;
+
+   LARGE_INTEGER file_size;
+   if (!GetFileSizeEx( FileHandle, &file_size )) {
+      close();
+      return false;
+   }
+   Size = static_cast<size_t>(file_size.QuadPart);
+   if (Size > 0) {
+      MappingHandle = CreateFileMappingA( FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+      if (MappingHandle == nullptr) {
+         close();
+         return false;
+      }
+      Data = static_cast<const char*>(MapViewOfFile( MappingHandle, FILE_MAP_READ, 0, 0, 0 ));
+      if (Data == nullptr) {
+         close();
+         return false;
+      }
+   }
+#else
+   FileDescriptor = ::open( file_path.c_str(), O_RDONLY );
+   if (FileDescriptor < 0) return false;
+
+   struct stat file_status{};
+   if (fstat( FileDescriptor, &file_status ) != 0) {
+      close();
+      return false;
+   }
+   Size = static_cast<size_t>(file_status.st_size);
+   if (Size > 0) {
+      void* data = mmap( nullptr, Size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0 );
+      if (data == MAP_FAILED) {
+         close();
+         return false;
+      }
+      madvise( data, Size, MADV_SEQUENTIAL );
+      Data = static_cast<const char*>(data);
+   }
+#endif
+   IsOpen = true;
+   return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+   if (Data != nullptr) UnmapViewOfFile( Data );
+   if (MappingHandle != nullptr) CloseHandle( MappingHandle );
+   if (FileHandle != INVALID_HANDLE_VALUE) CloseHandle( FileHandle );
+   MappingHandle = nullptr;
+   FileHandle = INVALID_HANDLE_VALUE;
+#else
+   if (Data != nullptr) munmap( const_cast<char*>(Data), Size );
+   if (FileDescriptor >= 0) ::close( FileDescriptor );
+   FileDescriptor = -1;
+#endif
+   IsOpen = false;
+   Data = nullptr;
+   Size = 0;
+}
\ No newline at end of file
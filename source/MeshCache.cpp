@@ -0,0 +1,62 @@
+#include "MeshCache.h"
+
+MeshCache::MeshCache(const std::string& source_file_path) : SourceCache( source_file_path, "meshes", ".mesh" )
+{
+}
+
+bool MeshCache::load(uint32_t position_format, uint32_t normal_format, uint32_t texture_format)
+{
+   int64_t modified_time;
+   uint64_t source_size;
+   if (!open( sizeof( Header ), modified_time, source_size )) return false;
+
+   const size_t file_size = File.getSize();
+   const Header& header = getHeader();
+   const uint64_t vertex_bytes = static_cast<uint64_t>(header.VertexNum) * header.BytesPerVertex;
+   const uint64_t index_bytes = static_cast<uint64_t>(header.IndexNum) * sizeof( GLuint );
+   const bool valid =
+      header.Magic == Magic &&
+      header.Version == Version &&
+      header.SourceModifiedTime == modified_time &&
+      header.SourceSize == source_size &&
+      header.PositionFormat == position_format &&
+      header.NormalFormat == normal_format &&
+      header.TextureFormat == texture_format &&
+      hasSourcePath( sizeof( Header ), header.SourcePathLength ) &&
+      header.VertexOffset % VertexAlignment == 0 &&
+      header.IndexOffset % IndexAlignment == 0 &&
+      header.VertexOffset >= sizeof( Header ) + header.SourcePathLength &&
+      header.VertexOffset + vertex_bytes <= header.IndexOffset &&
+      header.IndexOffset + index_bytes <= file_size;
+   if (!valid) {
+      File.close();
+      return false;
+   }
+   return true;
+}
+
+bool MeshCache::write(Header header, const void* vertex_data, const GLuint* index_data) const
+{
+   if (!getSourceStatus( header.SourceModifiedTime, header.SourceSize )) return false;
+
+   header.Magic = Magic;
+   header.Version = Version;
+   header.SourcePathLength = static_cast<uint32_t>(SourcePath.size());
+   header.Reserved = 0;
+   header.VertexOffset = align( sizeof( Header ) + SourcePath.size(), VertexAlignment );
+   const uint64_t vertex_bytes = static_cast<uint64_t>(header.VertexNum) * header.BytesPerVertex;
+   header.IndexOffset = align( header.VertexOffset + vertex_bytes, IndexAlignment );
+   const uint64_t index_bytes = static_cast<uint64_t>(header.IndexNum) * sizeof( GLuint );
+
+   return AtomicFile::write(
+      CachePath, "mesh cache", [&](std::ofstream& file) {
+         const std::vector<char> padding(VertexAlignment, 0);
+         file.write( reinterpret_cast<const char*>(&header), sizeof( Header ) );
+         file.write( SourcePath.data(), static_cast<std::streamsize>(SourcePath.size()) );
+         file.write( padding.data(), static_cast<std::streamsize>(header.VertexOffset - sizeof( Header ) - SourcePath.size()) );
+         file.write( static_cast<const char*>(vertex_data), static_cast<std::streamsize>(vertex_bytes) );
+         file.write( padding.data(), static_cast<std::streamsize>(header.IndexOffset - header.VertexOffset - vertex_bytes) );
+         file.write( reinterpret_cast<const char*>(index_data), static_cast<std::streamsize>(index_bytes) );
+      }
+   );
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "ObjReader.h"
+#include "MappedFile.h"
+
+bool ObjReader::isSpace(char c)
+{
+   return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* ObjReader::skipSpaces(const char* ptr, const char* end)
+{
+   while (ptr < end && isSpace( *ptr )) ++ptr;
+   return ptr;
+}
+
+const char* ObjReader::parseFloat(const char* ptr, const char* end, float& value)
+{
+   ptr = skipSpaces( ptr, end );
+   if (ptr < end && *ptr == '+') ++ptr;
+   const auto result = std::from_chars( ptr, end, value );
+   if (result.ec != std::errc()) value = 0.0f;
+   return result.ptr;
+}
+
+const char* ObjReader::parseIndex(const char* ptr, const char* end, int& value, bool& exists)
+{
+   const auto result = std::from_chars( ptr, end, value );
+   exists = result.ec == std::errc() && value != 0;
+   return result.ptr;
+}
+
+void ObjReader::parseChunk(const char* begin, const char* end, Chunk& chunk)
+{
+   std::vector<Corner> polygon;
+   std::vector<uint8_t> polygon_flags;
+   const char* ptr = begin;
+   while (ptr < end) {
+      ptr = skipSpaces( ptr, end );
+      const char* line_end = static_cast<const char*>(std::memchr( ptr, '\n', end - ptr ));
+      if (line_end == nullptr) line_end = end;
+
+      const size_t length = line_end - ptr;
+      if (length >= 2 && ptr[0] == 'v' && isSpace( ptr[1] )) {
+         glm::vec3 position;
+         const char* p = parseFloat( ptr + 2, line_end, position.x );
+         p = parseFloat( p, line_end, position.y );
+         parseFloat( p, line_end, position.z );
+         chunk.Positions.emplace_back( position );
+      }
+      else if (length >= 3 && ptr[0] == 'v' && ptr[1] == 't' && isSpace( ptr[2] )) {
+         glm::vec2 texture;
+         const char* p = parseFloat( ptr + 3, line_end, texture.x );
+         parseFloat( p, line_end, texture.y );
+         chunk.Textures.emplace_back( texture );
+      }
+      else if (length >= 3 && ptr[0] == 'v' && ptr[1] == 'n' && isSpace( ptr[2] )) {
+         glm::vec3 normal;
+         const char* p = parseFloat( ptr + 3, line_end, normal.x );
+         p = parseFloat( p, line_end, normal.y );
+         parseFloat( p, line_end, normal.z );
+         chunk.Normals.emplace_back( normal );
+      }
+      else if (length >= 2 && ptr[0] == 'f' && isSpace( ptr[1] )) {
+         polygon.clear();
+         polygon_flags.clear();
+         const char* p = skipSpaces( ptr + 2, line_end );
+         while (p < line_end) {
+            // Each corner is one of v, v/vt, v//vn, and v/vt/vn.
+            Corner corner;
+            uint8_t flags = 0;
+            int value = 0;
+            bool exists = false;
+            p = parseIndex( p, line_end, value, exists );
+            if (!exists) {
+               chunk.Valid = false;
+               break;
+            }
+            if (value < 0) {
+               corner.Position = static_cast<int>(chunk.Positions.size()) + value;
+               flags |= RelativePosition;
+            }
+            else corner.Position = value - 1;
+
+            if (p < line_end && *p == '/') {
+               p = parseIndex( p + 1, line_end, value, exists );
+               if (exists && value < 0) {
+                  corner.Texture = static_cast<int>(chunk.Textures.size()) + value;
+                  flags |= RelativeTexture;
+               }
+               else if (exists) corner.Texture = value - 1;
+
+               if (p < line_end && *p == '/') {
+                  p = parseIndex( p + 1, line_end, value, exists );
+                  if (exists && value < 0) {
+                     corner.Normal = static_cast<int>(chunk.Normals.size()) + value;
+                     flags |= RelativeNormal;
+                  }
+                  else if (exists) corner.Normal = value - 1;
+               }
+            }
+            polygon.emplace_back( corner );
+            polygon_flags.emplace_back( flags );
+            while (p < line_end && !isSpace( *p )) ++p;
+            p = skipSpaces( p, line_end );
+         }
+
+         for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+            for (const size_t k : { size_t(0), i, i + 1 }) {
+               if (polygon_flags[k] != 0) chunk.RelativeCorners.emplace_back( chunk.Corners.size(), polygon_flags[k] );
+               chunk.Corners.emplace_back( polygon[k] );
+            }
+         }
+      }
+      else if (length >= 2 && (ptr[0] == 'o' || ptr[0] == 'g') && isSpace( ptr[1] )) {
+         const char* name_begin = skipSpaces( ptr + 2, line_end );
+         const char* name_end = line_end;
+         while (name_end > name_begin && isSpace( *(name_end - 1) )) --name_end;
+         chunk.Groups.emplace_back( std::string(name_begin, name_end), chunk.Corners.size() );
+      }
+      ptr = line_end + 1;
+   }
+}
+
+bool ObjReader::mergeChunks(std::vector<Chunk>& chunks)
+{
+   size_t position_num = 0, texture_num = 0, normal_num = 0, corner_num = 0;
+   for (const auto& chunk : chunks) {
+      if (!chunk.Valid) return false;
+      position_num += chunk.Positions.size();
+      texture_num += chunk.Textures.size();
+      normal_num += chunk.Normals.size();
+      corner_num += chunk.Corners.size();
+   }
+   Positions.reserve( position_num );
+   Textures.reserve( texture_num );
+   Normals.reserve( normal_num );
+   Corners.reserve( corner_num );
+
+   for (auto& chunk : chunks) {
+      // The relative indices in a chunk count only the elements of the chunk, so the preceding ones are added.
+      const auto position_offset = static_cast<int>(Positions.size());
+      const auto texture_offset = static_cast<int>(Textures.size());
+      const auto normal_offset = static_cast<int>(Normals.size());
+      for (const auto& relative : chunk.RelativeCorners) {
+         Corner& corner = chunk.Corners[relative.first];
+         if (relative.second & RelativePosition) corner.Position += position_offset;
+         if (relative.second & RelativeTexture) corner.Texture += texture_offset;
+         if (relative.second & RelativeNormal) corner.Normal += normal_offset;
+      }
+      for (auto& group : chunk.Groups) {
+         group.FirstCorner += Corners.size();
+         Groups.emplace_back( std::move( group ) );
+      }
+      Positions.insert( Positions.end(), chunk.Positions.begin(), chunk.Positions.end() );
+      Textures.insert( Textures.end(), chunk.Textures.begin(), chunk.Textures.end() );
+      Normals.insert( Normals.end(), chunk.Normals.begin(), chunk.Normals.end() );
+      Corners.insert( Corners.end(), chunk.Corners.begin(), chunk.Corners.end() );
+      chunk = Chunk();
+   }
+
+   for (const auto& corner : Corners) {
+      if (corner.Position < 0 || corner.Position >= static_cast<int>(Positions.size()) ||
+          corner.Texture >= static_cast<int>(Textures.size()) || corner.Normal >= static_cast<int>(Normals.size()) ||
+          corner.Texture < -1 || corner.Normal < -1) return false;
+   }
+
+   if (Groups.empty() || Groups.front().FirstCorner > 0) Groups.emplace( Groups.begin(), "", 0 );
+   for (size_t i = 0; i < Groups.size(); ++i) {
+      const size_t next = i + 1 < Groups.size() ? Groups[i + 1].FirstCorner : Corners.size();
+      Groups[i].CornerNum = next - Groups[i].FirstCorner;
+   }
+   return true;
+}
+
+bool ObjReader::read(const std::string& file_path, int thread_num)
+{
+   Positions.clear();
+   Textures.clear();
+   Normals.clear();
+   Corners.clear();
+   Groups.clear();
+
+   MappedFile file;
+   if (!file.open( file_path )) {
+      std::cerr << "Could not open the object file " << file_path << "\n";
+      return false;
+   }
+
+   if (thread_num <= 0) thread_num = static_cast<int>(std::max( std::thread::hardware_concurrency(), 1u ));
+   const size_t size = file.getSize();
+   const size_t chunk_num = std::clamp<size_t>( size / MinChunkSize, 1, static_cast<size_t>(thread_num) );
+   const char* data = file.getData();
+   const char* end = data + size;
+
+   std::vector<const char*> boundaries = { data };
+   for (size_t i = 1; i < chunk_num; ++i) {
+      const char* boundary = std::max( data + size * i / chunk_num, boundaries.back() );
+      const void* line_end = boundary < end ? std::memchr( boundary, '\n', end - boundary ) : nullptr;
+      boundaries.emplace_back( line_end != nullptr ? static_cast<const char*>(line_end) + 1 : end );
+   }
+   boundaries.emplace_back( end );
+
+   std::vector<Chunk> chunks(chunk_num);
+   std::vector<std::thread> workers;
+   for (size_t i = 1; i < chunk_num; ++i) {
+      workers.emplace_back( parseChunk, boundaries[i], boundaries[i + 1], std::ref( chunks[i] ) );
+   }
+   parseChunk( boundaries[0], boundaries[1], chunks[0] );
+   for (auto& worker : workers) worker.join();
+
+   if (!mergeChunks( chunks )) {
+      std::cerr << "The object file is not correct: " << file_path << "\n";
+      return false;
+   }
+   return true;
+}
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include "Object.h"
+#include "ObjReader.h"
+#include "TextureCompressor.h"
 
 ObjectGL::ObjectGL() :
-   ImageBuffer( nullptr ), VAO( 0 ), VBO( 0 ), DrawMode( 0 ), VerticesCount( 0 ),
+   Name( "Object" ), ImageBuffer( nullptr ), VAO( 0 ), VBO( 0 ), IBO( 0 ), DrawMode( 0 ), VerticesCount( 0 ), IndicesCount( 0 ),
+   VertexPositionFormat( PositionFormat::Float32 ), VertexNormalFormat( NormalFormat::Float32 ),
+   VertexTextureFormat( TextureFormat::Float32 ), PositionScale( 1.0f ), PositionOffset( 0.0f ), BoundingSphere( 0.0f ),
    EmissionColor( 0.0f, 0.0f, 0.0f, 1.0f ),
    AmbientReflectionColor( 0.2f, 0.2f, 0.2f, 1.0f ),
    DiffuseReflectionColor( 0.8f, 0.8f, 0.8f, 1.0f ),
@@ -13,13 +17,27 @@ ObjectGL::~ObjectGL()
 {
    if (VAO != 0) {
       glDeleteVertexArrays( 1, &VAO );
+      GPUMemoryGL::removeBuffers( 1, &VBO );
       glDeleteBuffers( 1, &VBO );
    }
+   if (IBO != 0) {
+      GPUMemoryGL::removeBuffers( 1, &IBO );
+      glDeleteBuffers( 1, &IBO );
+   }
+   GPUMemoryGL::removeTextures( static_cast<GLsizei>(TextureID.size()), TextureID.data() );
    for (const auto& texture_id : TextureID) {
       if (texture_id != 0) glDeleteTextures( 1, &texture_id );
    }
    for (const auto& buffer : CustomBuffers) {
-      if (buffer.second != 0) glDeleteBuffers( 1, &buffer.second );
+      if (buffer.second != 0) {
+         GPUMemoryGL::removeBuffers( 1, &buffer.second );
+         glDeleteBuffers( 1, &buffer.second );
+      }
+   }
+   if (!ShaderStorageBufferObjects.empty()) {
+      const auto buffer_num = static_cast<GLsizei>(ShaderStorageBufferObjects.size());
+      GPUMemoryGL::removeBuffers( buffer_num, ShaderStorageBufferObjects.data() );
+      glDeleteBuffers( buffer_num, ShaderStorageBufferObjects.data() );
    }
    delete [] ImageBuffer;
 }
@@ -49,7 +67,62 @@ void ObjectGL::setSpecularReflectionExponent(const float& specular_reflection_ex
    SpecularReflectionExponent = specular_reflection_exponent;
 }
 
-bool ObjectGL::prepareTexture2DUsingFreeImage(const std::string& file_path, bool is_grayscale) const
+void ObjectGL::setVertexFormat(
+   PositionFormat position_format,
+   NormalFormat normal_format,
+   TextureFormat texture_format
+)
+{
+   VertexPositionFormat = position_format;
+   VertexNormalFormat = normal_format;
+   VertexTextureFormat = texture_format;
+}
+
+bool ObjectGL::isFloatVertexFormat() const
+{
+   return VertexPositionFormat == PositionFormat::Float32 &&
+      VertexNormalFormat == NormalFormat::Float32 &&
+      VertexTextureFormat == TextureFormat::Float32;
+}
+
+GPUMemoryGL::Category ObjectGL::getBufferCategory(GLenum target)
+{
+   switch (target) {
+      case GL_ELEMENT_ARRAY_BUFFER: return GPUMemoryGL::Category::Index;
+      case GL_SHADER_STORAGE_BUFFER: return GPUMemoryGL::Category::Storage;
+      case GL_DRAW_INDIRECT_BUFFER:
+      case GL_DISPATCH_INDIRECT_BUFFER: return GPUMemoryGL::Category::Indirect;
+      case GL_PIXEL_PACK_BUFFER:
+      case GL_PIXEL_UNPACK_BUFFER:
+      case GL_COPY_READ_BUFFER:
+      case GL_COPY_WRITE_BUFFER: return GPUMemoryGL::Category::Transfer;
+      default: return GPUMemoryGL::Category::Vertex;
+   }
+}
+
+int ObjectGL::getPositionSize(PositionFormat format)
+{
+   // Unorm16 positions take 8 bytes, not 6, to keep the vertex aligned to 4 bytes.
+   return format == PositionFormat::Unorm16 ? 4 * sizeof( GLushort ) : 3 * sizeof( GLfloat );
+}
+
+int ObjectGL::getNormalSize(NormalFormat format)
+{
+   return format == NormalFormat::Float32 ? 3 * sizeof( GLfloat ) : sizeof( GLuint );
+}
+
+int ObjectGL::getTextureSize(TextureFormat format)
+{
+   return format == TextureFormat::Float32 ? 2 * sizeof( GLfloat ) : sizeof( GLuint );
+}
+
+bool ObjectGL::readImageUsingFreeImage(
+   std::vector<uint8_t>& image,
+   int& width,
+   int& height,
+   const std::string& file_path,
+   bool is_grayscale
+)
 {
    const FREE_IMAGE_FORMAT format = FreeImage_GetFileType( file_path.c_str(), 0 );
    FIBITMAP* texture = FreeImage_Load( format, file_path.c_str() );
@@ -65,37 +138,132 @@ bool ObjectGL::prepareTexture2DUsingFreeImage(const std::string& file_path, bool
       texture_converted = n_bits_per_pixel == n_bits ? texture : FreeImage_ConvertTo32Bits( texture );
    }
 
-   const GLsizei width = FreeImage_GetWidth( texture_converted );
-   const GLsizei height = FreeImage_GetHeight( texture_converted );
-   GLvoid* data = FreeImage_GetBits( texture_converted );
-   glTextureStorage2D( TextureID.back(), 1, is_grayscale ? GL_R8 : GL_RGBA8, width, height );
-   glTextureSubImage2D( TextureID.back(), 0, 0, 0, width, height, is_grayscale ? GL_RED : GL_BGRA, GL_UNSIGNED_BYTE, data );
+   width = static_cast<int>(FreeImage_GetWidth( texture_converted ));
+   height = static_cast<int>(FreeImage_GetHeight( texture_converted ));
+   // The rows are padded to 4 bytes, so a grayscale row is not contiguous with the next unless the width is a
+   // multiple of 4, and each row is copied from its pitch.
+   const auto* data = static_cast<const uint8_t*>(FreeImage_GetBits( texture_converted ));
+   const size_t pitch = FreeImage_GetPitch( texture_converted );
+   const size_t channel_num = is_grayscale ? 1 : 4;
+   image.resize( static_cast<size_t>(width) * height * channel_num );
+   for (int y = 0; y < height; ++y) {
+      const uint8_t* row = data + pitch * y;
+      uint8_t* texels = image.data() + static_cast<size_t>(width) * y * channel_num;
+      if (is_grayscale) std::copy( row, row + width, texels );
+      else {
+         for (int x = 0; x < width; ++x, row += 4, texels += 4) {
+            texels[0] = row[FI_RGBA_RED];
+            texels[1] = row[FI_RGBA_GREEN];
+            texels[2] = row[FI_RGBA_BLUE];
+            texels[3] = row[FI_RGBA_ALPHA];
+         }
+      }
+   }
 
    FreeImage_Unload( texture_converted );
    if (n_bits_per_pixel != n_bits) FreeImage_Unload( texture );
    return true;
 }
 
-int ObjectGL::addTexture(const std::string& texture_file_path, bool is_grayscale)
+bool ObjectGL::loadTexture(TextureData& texture, const std::string& texture_file_path, bool is_grayscale)
+{
+   texture.InternalFormat = is_grayscale ? GL_COMPRESSED_RED_RGTC1 : GL_COMPRESSED_RGBA_BPTC_UNORM;
+   texture.Cache = std::make_unique<TextureCache>( texture_file_path, texture.InternalFormat );
+   texture.LevelData.clear();
+   if (texture.Cache->load()) {
+      const TextureCache::Header& header = texture.Cache->getHeader();
+      texture.Width = static_cast<int>(header.Width);
+      texture.Height = static_cast<int>(header.Height);
+      for (uint32_t level = 0; level < header.LevelNum; ++level) {
+         texture.LevelData.emplace_back( texture.Cache->getLevelData( static_cast<int>(level) ), header.Levels[level].Size );
+      }
+      return true;
+   }
+
+   int width, height;
+   std::vector<uint8_t> image;
+   if (!readImageUsingFreeImage( image, width, height, texture_file_path, is_grayscale )) return false;
+
+   texture.Width = width;
+   texture.Height = height;
+   const int level_num = std::min( TextureCompressor::getMipmapLevelNum( width, height ), TextureCache::MaxLevelNum );
+   texture.Levels.resize( level_num );
+   std::vector<uint8_t> halved;
+   for (int level = 0; level < level_num; ++level) {
+      if (is_grayscale) TextureCompressor::compressBC4( texture.Levels[level], image.data(), width, height );
+      else TextureCompressor::compressBC7( texture.Levels[level], image.data(), width, height );
+      if (level + 1 < level_num) {
+         TextureCompressor::halve( halved, image, width, height, is_grayscale ? 1 : 4 );
+         image.swap( halved );
+         width = std::max( width / 2, 1 );
+         height = std::max( height / 2, 1 );
+      }
+   }
+
+   TextureCache::Header header{};
+   header.Width = static_cast<uint32_t>(texture.Width);
+   header.Height = static_cast<uint32_t>(texture.Height);
+   if (!texture.Cache->write( header, texture.Levels )) {
+      std::cerr << "Could not cache the texture: " << texture_file_path << "\n";
+   }
+   texture.Cache.reset();
+   for (const auto& level : texture.Levels) texture.LevelData.emplace_back( level.data(), level.size() );
+   return true;
+}
+
+GLuint ObjectGL::createTexture(const TextureData& texture, bool upload_data)
 {
    GLuint texture_id = 0;
    glCreateTextures( GL_TEXTURE_2D, 1, &texture_id );
-   TextureID.emplace_back( texture_id );
-   if (!prepareTexture2DUsingFreeImage( texture_file_path, is_grayscale )) {
-      glDeleteTextures( 1, &texture_id );
-      TextureID.erase( TextureID.end() - 1 );
-      std::cerr << "Could not read image file " << texture_file_path.c_str() << "\n";
-      return -1;
+   const auto level_num = static_cast<GLsizei>(texture.LevelData.size());
+   glTextureStorage2D( texture_id, level_num, texture.InternalFormat, texture.Width, texture.Height );
+   // The object it is set to takes it over, as it is created before the object is known to the asset loader.
+   GLsizeiptr size = 0;
+   for (const auto& level : texture.LevelData) size += static_cast<GLsizeiptr>(level.second);
+   GPUMemoryGL::addTexture( texture_id, size, "Object", "texture" );
+   for (GLsizei level = 0; upload_data && level < level_num; ++level) {
+      glCompressedTextureSubImage2D(
+         texture_id,
+         level,
+         0,
+         0,
+         std::max( texture.Width >> level, 1 ),
+         std::max( texture.Height >> level, 1 ),
+         texture.InternalFormat,
+         static_cast<GLsizei>(texture.LevelData[level].second),
+         texture.LevelData[level].first
+      );
    }
-
    glTextureParameteri( texture_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
    glTextureParameteri( texture_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
    glTextureParameteri( texture_id, GL_TEXTURE_WRAP_S, GL_REPEAT );
    glTextureParameteri( texture_id, GL_TEXTURE_WRAP_T, GL_REPEAT );
-   glGenerateTextureMipmap( texture_id );
+   return texture_id;
+}
+
+int ObjectGL::addTexture(const std::string& texture_file_path, bool is_grayscale)
+{
+   TextureData texture;
+   if (!loadTexture( texture, texture_file_path, is_grayscale )) {
+      std::cerr << "Could not read image file " << texture_file_path.c_str() << "\n";
+      return -1;
+   }
+
+   TextureID.emplace_back( createTexture( texture ) );
+   GPUMemoryGL::setTextureOwner( TextureID.back(), Name, "texture " + std::to_string( TextureID.size() - 1 ) );
    return static_cast<int>(TextureID.size() - 1);
 }
 
+void ObjectGL::setTexture(int index, GLuint texture_id)
+{
+   if (TextureID[index] != 0) {
+      GPUMemoryGL::removeTextures( 1, &TextureID[index] );
+      glDeleteTextures( 1, &TextureID[index] );
+   }
+   TextureID[index] = texture_id;
+   GPUMemoryGL::setTextureOwner( texture_id, Name, "texture " + std::to_string( index ) );
+}
+
 void ObjectGL::addTexture(int width, int height, bool is_grayscale)
 {
    GLuint texture_id = 0;
@@ -107,6 +275,12 @@ void ObjectGL::addTexture(int width, int height, bool is_grayscale)
       width,
       height
    );
+   GPUMemoryGL::addTexture(
+      texture_id,
+      static_cast<GLsizeiptr>(width) * height * (is_grayscale ? 1 : 4),
+      Name,
+      "texture " + std::to_string( TextureID.size() )
+   );
    glTextureParameteri( texture_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
    glTextureParameteri( texture_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
    glTextureParameteri( texture_id, GL_TEXTURE_WRAP_S, GL_REPEAT );
@@ -134,27 +308,105 @@ int ObjectGL::addTexture(const uint8_t* image_buffer, int width, int height, boo
 
 void ObjectGL::prepareTexture(bool normals_exist) const
 {
-   const uint offset = normals_exist ? 6 : 3;
-   glVertexArrayAttribFormat( VAO, TextureLoc, 2, GL_FLOAT, GL_FALSE, offset * sizeof( GLfloat ) );
+   GLuint offset = getPositionSize( VertexPositionFormat );
+   if (normals_exist) offset += getNormalSize( VertexNormalFormat );
+   switch (VertexTextureFormat) {
+      case TextureFormat::Float32:
+         glVertexArrayAttribFormat( VAO, TextureLoc, 2, GL_FLOAT, GL_FALSE, offset );
+         break;
+      case TextureFormat::HalfFloat16:
+         glVertexArrayAttribFormat( VAO, TextureLoc, 2, GL_HALF_FLOAT, GL_FALSE, offset );
+         break;
+      case TextureFormat::Unorm16:
+         glVertexArrayAttribFormat( VAO, TextureLoc, 2, GL_UNSIGNED_SHORT, GL_TRUE, offset );
+         break;
+   }
    glEnableVertexArrayAttrib( VAO, TextureLoc );
    glVertexArrayAttribBinding( VAO, TextureLoc, 0 );
 }
 
 void ObjectGL::prepareNormal() const
 {
-   glVertexArrayAttribFormat( VAO, NormalLoc, 3, GL_FLOAT, GL_FALSE, 3 * sizeof( GLfloat ) );
+   const GLuint offset = getPositionSize( VertexPositionFormat );
+   switch (VertexNormalFormat) {
+      case NormalFormat::Float32:
+         glVertexArrayAttribFormat( VAO, NormalLoc, 3, GL_FLOAT, GL_FALSE, offset );
+         break;
+      case NormalFormat::Snorm10_10_10_2:
+         glVertexArrayAttribFormat( VAO, NormalLoc, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offset );
+         break;
+      case NormalFormat::Octahedral16:
+         glVertexArrayAttribFormat( VAO, NormalLoc, 2, GL_SHORT, GL_TRUE, offset );
+         break;
+   }
    glEnableVertexArrayAttrib( VAO, NormalLoc );
    glVertexArrayAttribBinding( VAO, NormalLoc, 0 );
 }
 
+glm::vec4 ObjectGL::calculateBoundingSphere(
+   const GLfloat* data,
+   size_t vertex_num,
+   int n_floats_per_vertex,
+   PositionFormat position_format,
+   const glm::vec3& position_scale,
+   const glm::vec3& position_offset
+)
+{
+   if (position_format == PositionFormat::Unorm16) {
+      return { position_offset + 0.5f * position_scale, 0.5f * glm::length( position_scale ) };
+   }
+   if (vertex_num == 0) return glm::vec4(0.0f);
+
+   glm::vec3 min_point(data[0], data[1], data[2]);
+   glm::vec3 max_point = min_point;
+   const size_t size = vertex_num * n_floats_per_vertex;
+   for (size_t i = 0; i < size; i += n_floats_per_vertex) {
+      const glm::vec3 vertex(data[i], data[i + 1], data[i + 2]);
+      min_point = glm::min( min_point, vertex );
+      max_point = glm::max( max_point, vertex );
+   }
+
+   const glm::vec3 center = 0.5f * (min_point + max_point);
+   float squared_radius = 0.0f;
+   for (size_t i = 0; i < size; i += n_floats_per_vertex) {
+      const glm::vec3 d = glm::vec3(data[i], data[i + 1], data[i + 2]) - center;
+      squared_radius = std::max( squared_radius, glm::dot( d, d ) );
+   }
+   return { center, std::sqrt( squared_radius ) };
+}
+
 void ObjectGL::prepareVertexBuffer(int n_bytes_per_vertex)
 {
+   const int n_floats_per_vertex = n_bytes_per_vertex / static_cast<int>(sizeof( GLfloat ));
+   BoundingSphere = calculateBoundingSphere(
+      DataBuffer.data(),
+      DataBuffer.size() / n_floats_per_vertex,
+      n_floats_per_vertex,
+      VertexPositionFormat,
+      PositionScale,
+      PositionOffset
+   );
+   prepareVertexBuffer( n_bytes_per_vertex, DataBuffer.data(), sizeof( GLfloat ) * DataBuffer.size() );
+}
+
+void ObjectGL::prepareVertexBuffer(int n_bytes_per_vertex, const void* data, size_t size)
+{
+   // The object can be set again, e.g. with the mesh after a placeholder, so the previous vertices are deleted.
+   if (VAO != 0) {
+      glDeleteVertexArrays( 1, &VAO );
+      GPUMemoryGL::removeBuffers( 1, &VBO );
+      glDeleteBuffers( 1, &VBO );
+   }
    glCreateBuffers( 1, &VBO );
-   glNamedBufferStorage( VBO, sizeof( GLfloat ) * DataBuffer.size(), DataBuffer.data(), GL_DYNAMIC_STORAGE_BIT );
+   glNamedBufferStorage( VBO, static_cast<GLsizeiptr>(size), data, GL_DYNAMIC_STORAGE_BIT );
+   GPUMemoryGL::addBuffer( VBO, GPUMemoryGL::Category::Vertex, static_cast<GLsizeiptr>(size), Name, "vertices" );
 
    glCreateVertexArrays( 1, &VAO );
    glVertexArrayVertexBuffer( VAO, 0, VBO, 0, n_bytes_per_vertex );
-   glVertexArrayAttribFormat( VAO, VertexLoc, 3, GL_FLOAT, GL_FALSE, 0 );
+   if (VertexPositionFormat == PositionFormat::Unorm16) {
+      glVertexArrayAttribFormat( VAO, VertexLoc, 3, GL_UNSIGNED_SHORT, GL_TRUE, 0 );
+   }
+   else glVertexArrayAttribFormat( VAO, VertexLoc, 3, GL_FLOAT, GL_FALSE, 0 );
    glEnableVertexArrayAttrib( VAO, VertexLoc );
    glVertexArrayAttribBinding( VAO, VertexLoc, 0 );
 }
@@ -194,18 +446,91 @@ void ObjectGL::getSquareObject(
    };
 }
 
+glm::vec2 ObjectGL::encodeOctahedralNormal(const glm::vec3& normal)
+{
+   // The unit sphere is projected onto the octahedron, and its lower half is folded over the upper half.
+   const glm::vec3 n = normal / (std::abs( normal.x ) + std::abs( normal.y ) + std::abs( normal.z ));
+   if (n.z >= 0.0f) return { n.x, n.y };
+
+   return {
+      (1.0f - std::abs( n.y )) * (n.x >= 0.0f ? 1.0f : -1.0f),
+      (1.0f - std::abs( n.x )) * (n.y >= 0.0f ? 1.0f : -1.0f)
+   };
+}
+
+void ObjectGL::pushComponents(std::vector<GLuint>& data, const GLfloat* components, int component_num)
+{
+   // The bits of the floats are copied into the words as they are, so no value passes through a float of the other type.
+   const size_t offset = data.size();
+   data.resize( offset + component_num );
+   std::memcpy( data.data() + offset, components, sizeof( GLfloat ) * component_num );
+}
+
+void ObjectGL::packDataBuffer(
+   std::vector<GLuint>& data,
+   glm::vec3& position_scale,
+   glm::vec3& position_offset,
+   const std::vector<glm::vec3>& vertices,
+   const std::vector<glm::vec3>& normals,
+   const std::vector<glm::vec2>& textures
+) const
+{
+   position_scale = glm::vec3(1.0f);
+   position_offset = glm::vec3(0.0f);
+   if (VertexPositionFormat == PositionFormat::Unorm16 && !vertices.empty()) {
+      glm::vec3 min_point = vertices[0], max_point = vertices[0];
+      for (const auto& vertex : vertices) {
+         min_point = glm::min( min_point, vertex );
+         max_point = glm::max( max_point, vertex );
+      }
+      position_offset = min_point;
+      position_scale = glm::max( max_point - min_point, glm::vec3(std::numeric_limits<float>::epsilon()) );
+   }
+
+   const int n_bytes_per_vertex =
+      getPositionSize( VertexPositionFormat ) + getNormalSize( VertexNormalFormat ) + getTextureSize( VertexTextureFormat );
+   data.reserve( vertices.size() * n_bytes_per_vertex / sizeof( GLuint ) );
+   for (size_t i = 0; i < vertices.size(); ++i) {
+      if (VertexPositionFormat == PositionFormat::Unorm16) {
+         const glm::vec3 normalized = (vertices[i] - position_offset) / position_scale;
+         data.push_back( glm::packUnorm2x16( glm::vec2(normalized.x, normalized.y) ) );
+         data.push_back( glm::packUnorm2x16( glm::vec2(normalized.z, 0.0f) ) );
+      }
+      else pushComponents( data, glm::value_ptr( vertices[i] ), 3 );
+
+      switch (VertexNormalFormat) {
+         case NormalFormat::Float32:
+            pushComponents( data, glm::value_ptr( normals[i] ), 3 );
+            break;
+         case NormalFormat::Snorm10_10_10_2:
+            data.push_back( glm::packSnorm3x10_1x2( glm::vec4(normals[i], 0.0f) ) );
+            break;
+         case NormalFormat::Octahedral16:
+            data.push_back( glm::packSnorm2x16( encodeOctahedralNormal( normals[i] ) ) );
+            break;
+      }
+
+      switch (VertexTextureFormat) {
+         case TextureFormat::Float32:
+            pushComponents( data, glm::value_ptr( textures[i] ), 2 );
+            break;
+         case TextureFormat::HalfFloat16:
+            data.push_back( glm::packHalf2x16( textures[i] ) );
+            break;
+         case TextureFormat::Unorm16:
+            data.push_back( glm::packUnorm2x16( textures[i] ) );
+            break;
+      }
+   }
+}
+
 void ObjectGL::setObject(GLenum draw_mode, const std::vector<glm::vec3>& vertices)
 {
+   setVertexFormat( PositionFormat::Float32, NormalFormat::Float32, TextureFormat::Float32 );
    DrawMode = draw_mode;
-   VerticesCount = 0;
-   DataBuffer.clear();
-   for (auto& vertex : vertices) {
-      DataBuffer.push_back( vertex.x );
-      DataBuffer.push_back( vertex.y );
-      DataBuffer.push_back( vertex.z );
-      VerticesCount++;
-   }
-   const int n_bytes_per_vertex = 3 * sizeof( GLfloat );
+   VerticesCount = static_cast<GLsizei>(vertices.size());
+   VertexLayout::interleave( DataBuffer, vertices.size(), vertices.data() );
+   const int n_bytes_per_vertex = VertexLayout::getFloatNum<glm::vec3>() * sizeof( GLfloat );
    prepareVertexBuffer( n_bytes_per_vertex );
 }
 
@@ -215,19 +540,11 @@ void ObjectGL::setObject(
    const std::vector<glm::vec3>& normals
 )
 {
+   setVertexFormat( PositionFormat::Float32, NormalFormat::Float32, TextureFormat::Float32 );
    DrawMode = draw_mode;
-   VerticesCount = 0;
-   DataBuffer.clear();
-   for (size_t i = 0; i < vertices.size(); ++i) {
-      DataBuffer.push_back( vertices[i].x );
-      DataBuffer.push_back( vertices[i].y );
-      DataBuffer.push_back( vertices[i].z );
-      DataBuffer.push_back( normals[i].x );
-      DataBuffer.push_back( normals[i].y );
-      DataBuffer.push_back( normals[i].z );
-      VerticesCount++;
-   }
-   const int n_bytes_per_vertex = 6 * sizeof( GLfloat );
+   VerticesCount = static_cast<GLsizei>(vertices.size());
+   VertexLayout::interleave( DataBuffer, vertices.size(), vertices.data(), normals.data() );
+   const int n_bytes_per_vertex = VertexLayout::getFloatNum<glm::vec3, glm::vec3>() * sizeof( GLfloat );
    prepareVertexBuffer( n_bytes_per_vertex );
    prepareNormal();
 }
@@ -240,18 +557,11 @@ void ObjectGL::setObject(
    bool is_grayscale
 )
 {
+   setVertexFormat( PositionFormat::Float32, NormalFormat::Float32, TextureFormat::Float32 );
    DrawMode = draw_mode;
-   VerticesCount = 0;
-   DataBuffer.clear();
-   for (size_t i = 0; i < vertices.size(); ++i) {
-      DataBuffer.push_back( vertices[i].x );
-      DataBuffer.push_back( vertices[i].y );
-      DataBuffer.push_back( vertices[i].z );
-      DataBuffer.push_back( textures[i].x );
-      DataBuffer.push_back( textures[i].y );
-      VerticesCount++;
-   }
-   const int n_bytes_per_vertex = 5 * sizeof( GLfloat );
+   VerticesCount = static_cast<GLsizei>(vertices.size());
+   VertexLayout::interleave( DataBuffer, vertices.size(), vertices.data(), textures.data() );
+   const int n_bytes_per_vertex = VertexLayout::getFloatNum<glm::vec3, glm::vec2>() * sizeof( GLfloat );
    prepareVertexBuffer( n_bytes_per_vertex );
    prepareTexture( false );
    addTexture( texture_file_path, is_grayscale );
@@ -265,21 +575,31 @@ void ObjectGL::setObject(
 )
 {
    DrawMode = draw_mode;
-   VerticesCount = 0;
-   DataBuffer.clear();
-   for (size_t i = 0; i < vertices.size(); ++i) {
-      DataBuffer.push_back( vertices[i].x );
-      DataBuffer.push_back( vertices[i].y );
-      DataBuffer.push_back( vertices[i].z );
-      DataBuffer.push_back( normals[i].x );
-      DataBuffer.push_back( normals[i].y );
-      DataBuffer.push_back( normals[i].z );
-      DataBuffer.push_back( textures[i].x );
-      DataBuffer.push_back( textures[i].y );
-      VerticesCount++;
-   }
-   const int n_bytes_per_vertex = 8 * sizeof( GLfloat );
-   prepareVertexBuffer( n_bytes_per_vertex );
+   VerticesCount = static_cast<GLsizei>(vertices.size());
+   if (isFloatVertexFormat()) {
+      PositionScale = glm::vec3(1.0f);
+      PositionOffset = glm::vec3(0.0f);
+      VertexLayout::interleave( DataBuffer, vertices.size(), vertices.data(), normals.data(), textures.data() );
+      const int n_bytes_per_vertex = VertexLayout::getFloatNum<glm::vec3, glm::vec3, glm::vec2>() * sizeof( GLfloat );
+      prepareVertexBuffer( n_bytes_per_vertex );
+   }
+   else {
+      // The packed words are only uploaded, as the float-only paths that update DataBuffer do not take them.
+      std::vector<GLuint> data;
+      packDataBuffer( data, PositionScale, PositionOffset, vertices, normals, textures );
+      DataBuffer.clear();
+      BoundingSphere = calculateBoundingSphere(
+         reinterpret_cast<const GLfloat*>(vertices.data()),
+         vertices.size(),
+         VertexLayout::getFloatNum<glm::vec3>(),
+         VertexPositionFormat,
+         PositionScale,
+         PositionOffset
+      );
+      const int n_bytes_per_vertex =
+         getPositionSize( VertexPositionFormat ) + getNormalSize( VertexNormalFormat ) + getTextureSize( VertexTextureFormat );
+      prepareVertexBuffer( n_bytes_per_vertex, data.data(), sizeof( GLuint ) * data.size() );
+   }
    prepareNormal();
    prepareTexture( true );
 }
@@ -297,90 +617,247 @@ void ObjectGL::setObject(
    addTexture( texture_file_path, is_grayscale );
 }
 
+void ObjectGL::optimizeVertexCache(std::vector<GLuint>& indices, size_t vertex_num)
+{
+   // Tipsify [Sander et al. 2007] reorders the triangles to fan around the vertices which are still in the
+   // post-transform cache, and jumps to a recently used vertex when it reaches a dead-end.
+   constexpr int cache_size = 16;
+   const size_t triangle_num = indices.size() / 3;
+   std::vector<int> live_triangle_num(vertex_num, 0);
+   for (const auto& index : indices) live_triangle_num[index]++;
+
+   std::vector<size_t> adjacency_offsets(vertex_num + 1, 0);
+   for (size_t v = 0; v < vertex_num; ++v) {
+      adjacency_offsets[v + 1] = adjacency_offsets[v] + live_triangle_num[v];
+   }
+   std::vector<size_t> adjacency(indices.size());
+   std::vector<size_t> adjacency_fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+   for (size_t t = 0; t < triangle_num; ++t) {
+      for (size_t k = 0; k < 3; ++k) adjacency[adjacency_fill[indices[t * 3 + k]]++] = t;
+   }
+
+   std::vector<GLuint> optimized;
+   optimized.reserve( indices.size() );
+   std::vector<bool> emitted(triangle_num, false);
+   std::vector<int> cache_time_stamps(vertex_num, 0);
+   std::vector<GLuint> dead_ends, candidates;
+   int time_stamp = cache_size + 1;
+   size_t cursor = 0;
+   auto fanning_vertex = static_cast<int64_t>(vertex_num > 0 ? 0 : -1);
+   while (fanning_vertex >= 0) {
+      candidates.clear();
+      for (size_t a = adjacency_offsets[fanning_vertex]; a < adjacency_offsets[fanning_vertex + 1]; ++a) {
+         const size_t t = adjacency[a];
+         if (emitted[t]) continue;
+
+         for (size_t k = 0; k < 3; ++k) {
+            const GLuint v = indices[t * 3 + k];
+            optimized.emplace_back( v );
+            dead_ends.emplace_back( v );
+            candidates.emplace_back( v );
+            live_triangle_num[v]--;
+            if (time_stamp - cache_time_stamps[v] > cache_size) cache_time_stamps[v] = time_stamp++;
+         }
+         emitted[t] = true;
+      }
+
+      // Prefer the candidate which will stay in the cache after emitting all of its remaining triangles.
+      fanning_vertex = -1;
+      int best_priority = -1;
+      for (const auto& v : candidates) {
+         if (live_triangle_num[v] <= 0) continue;
+
+         int priority = 0;
+         if (time_stamp - cache_time_stamps[v] + 2 * live_triangle_num[v] <= cache_size) {
+            priority = time_stamp - cache_time_stamps[v];
+         }
+         if (priority > best_priority) {
+            best_priority = priority;
+            fanning_vertex = v;
+         }
+      }
+      while (fanning_vertex < 0 && !dead_ends.empty()) {
+         const GLuint v = dead_ends.back();
+         dead_ends.pop_back();
+         if (live_triangle_num[v] > 0) fanning_vertex = v;
+      }
+      while (fanning_vertex < 0 && cursor < vertex_num) {
+         if (live_triangle_num[cursor] > 0) fanning_vertex = static_cast<int64_t>(cursor);
+         cursor++;
+      }
+   }
+   indices.swap( optimized );
+}
+
+void ObjectGL::reorderVertices(
+   std::vector<glm::vec3>& vertices,
+   std::vector<glm::vec3>& normals,
+   std::vector<glm::vec2>& textures,
+   std::vector<GLuint>& indices
+)
+{
+   // The vertices are sorted in the order of the first use, so the vertex fetch also walks the memory linearly.
+   constexpr auto unused = std::numeric_limits<GLuint>::max();
+   std::vector<GLuint> new_indices(vertices.size(), unused);
+   std::vector<glm::vec3> ordered_vertices, ordered_normals;
+   std::vector<glm::vec2> ordered_textures;
+   ordered_vertices.reserve( vertices.size() );
+   ordered_normals.reserve( normals.size() );
+   ordered_textures.reserve( textures.size() );
+   for (auto& index : indices) {
+      if (new_indices[index] == unused) {
+         new_indices[index] = static_cast<GLuint>(ordered_vertices.size());
+         ordered_vertices.emplace_back( vertices[index] );
+         ordered_normals.emplace_back( normals[index] );
+         ordered_textures.emplace_back( textures[index] );
+      }
+      index = new_indices[index];
+   }
+   vertices.swap( ordered_vertices );
+   normals.swap( ordered_normals );
+   textures.swap( ordered_textures );
+}
+
 bool ObjectGL::readObjectFile(
    std::vector<glm::vec3>& vertices,
    std::vector<glm::vec3>& normals, 
    std::vector<glm::vec2>& textures, 
+   std::vector<GLuint>& indices,
    const std::string& file_path
 ) const
 {
-   std::ifstream file(file_path);
-   if (!file.is_open()) {
-      std::cout << "The object file is not correct.\n";
-      return false;
-   }
-
-   std::vector<glm::vec3> vertex_buffer, normal_buffer;
-   std::vector<glm::vec2> texture_buffer;
-   std::vector<int> vertex_indices, normal_indices, texture_indices;
-   while (!file.eof()) {
-      std::string word;
-      file >> word;
-      
-      if (word == "v") {
-         glm::vec3 vertex;
-         file >> vertex.x >> vertex.y >> vertex.z;
-         vertex_buffer.emplace_back( vertex );
-      }
-      else if (word == "vt") {
-         glm::vec2 uv;
-         file >> uv.x >> uv.y;
-         texture_buffer.emplace_back( uv );
+   ObjReader reader;
+   if (!reader.read( file_path )) return false;
+
+   const std::vector<glm::vec3>& position_buffer = reader.getPositions();
+   const std::vector<glm::vec2>& texture_buffer = reader.getTextures();
+   const std::vector<glm::vec3>& normal_buffer = reader.getNormals();
+   const std::vector<ObjReader::Corner>& corners = reader.getCorners();
+
+   // The faces without normals get the area-weighted average of the adjacent face normals.
+   std::vector<glm::vec3> generated_normals;
+   const bool normals_missing = std::any_of(
+      corners.begin(), corners.end(), [](const ObjReader::Corner& corner) { return corner.Normal < 0; }
+   );
+   if (normals_missing) {
+      generated_normals.resize( position_buffer.size(), glm::vec3(0.0f) );
+      for (size_t i = 0; i + 2 < corners.size(); i += 3) {
+         const glm::vec3& p0 = position_buffer[corners[i].Position];
+         const glm::vec3& p1 = position_buffer[corners[i + 1].Position];
+         const glm::vec3& p2 = position_buffer[corners[i + 2].Position];
+         const glm::vec3 face_normal = glm::cross( p1 - p0, p2 - p0 );
+         for (size_t k = 0; k < 3; ++k) generated_normals[corners[i + k].Position] += face_normal;
       }
-      else if (word == "vn") {
-         glm::vec3 normal;
-         file >> normal.x >> normal.y >> normal.z;
-         normal_buffer.emplace_back( normal );
+      for (auto& normal : generated_normals) {
+         const float length = glm::length( normal );
+         normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
       }
-      else if (word == "f") {
-         char c;
-         vertex_indices.emplace_back(); file >> vertex_indices.back(); file >> c;
-         texture_indices.emplace_back(); file >> texture_indices.back(); file >> c;
-         normal_indices.emplace_back(); file >> normal_indices.back();
-         vertex_indices.emplace_back(); file >> vertex_indices.back(); file >> c;
-         texture_indices.emplace_back(); file >> texture_indices.back(); file >> c;
-         normal_indices.emplace_back(); file >> normal_indices.back();
-         vertex_indices.emplace_back(); file >> vertex_indices.back(); file >> c;
-         texture_indices.emplace_back(); file >> texture_indices.back(); file >> c;
-         normal_indices.emplace_back(); file >> normal_indices.back();
+   }
+
+   // The same (v, vt, vn) tuple is shared by the adjacent faces, so it is emitted only once.
+   std::unordered_map<glm::ivec3, GLuint> unique_vertices;
+   unique_vertices.reserve( corners.size() );
+   indices.reserve( corners.size() );
+   for (const auto& corner : corners) {
+      const glm::ivec3 key(corner.Position, corner.Texture, corner.Normal);
+      const auto it = unique_vertices.find( key );
+      if (it != unique_vertices.end()) {
+         indices.emplace_back( it->second );
+         continue;
       }
-      else std::getline( file, word );
+
+      const auto index = static_cast<GLuint>(vertices.size());
+      unique_vertices.emplace( key, index );
+      indices.emplace_back( index );
+      vertices.emplace_back( position_buffer[corner.Position] );
+      normals.emplace_back( corner.Normal >= 0 ? normal_buffer[corner.Normal] : generated_normals[corner.Position] );
+      textures.emplace_back( corner.Texture >= 0 ? texture_buffer[corner.Texture] : glm::vec2(0.0f) );
    }
 
-   for (uint i = 0; i < vertex_indices.size(); ++i) {
-      vertices.emplace_back( vertex_buffer[vertex_indices[i] - 1] );
-      normals.emplace_back( normal_buffer[normal_indices[i] - 1] );
-      textures.emplace_back( texture_buffer[texture_indices[i] - 1] );
+   optimizeVertexCache( indices, vertices.size() );
+   reorderVertices( vertices, normals, textures, indices );
+   return true;
+}
+
+bool ObjectGL::loadMesh(MeshData& mesh, const std::string& obj_file_path) const
+{
+   mesh.Cache = std::make_unique<MeshCache>( obj_file_path );
+   if (mesh.Cache->load(
+         static_cast<uint32_t>(VertexPositionFormat),
+         static_cast<uint32_t>(VertexNormalFormat),
+         static_cast<uint32_t>(VertexTextureFormat)
+      )) {
+      mesh.Header = mesh.Cache->getHeader();
+      return true;
+   }
+
+   std::vector<glm::vec3> vertices, normals;
+   std::vector<glm::vec2> textures;
+   if (!readObjectFile( vertices, normals, textures, mesh.Indices, obj_file_path )) return false;
+
+   MeshCache::Header& header = mesh.Header;
+   header = MeshCache::Header{};
+   mesh.Vertices.clear();
+   packDataBuffer( mesh.Vertices, header.PositionScale, header.PositionOffset, vertices, normals, textures );
+   header.VertexNum = static_cast<uint32_t>(vertices.size());
+   header.IndexNum = static_cast<uint32_t>(mesh.Indices.size());
+   header.BytesPerVertex =
+      getPositionSize( VertexPositionFormat ) + getNormalSize( VertexNormalFormat ) + getTextureSize( VertexTextureFormat );
+   header.PositionFormat = static_cast<uint32_t>(VertexPositionFormat);
+   header.NormalFormat = static_cast<uint32_t>(VertexNormalFormat);
+   header.TextureFormat = static_cast<uint32_t>(VertexTextureFormat);
+   header.BoundingSphere = calculateBoundingSphere(
+      reinterpret_cast<const GLfloat*>(vertices.data()),
+      vertices.size(),
+      VertexLayout::getFloatNum<glm::vec3>(),
+      VertexPositionFormat,
+      header.PositionScale,
+      header.PositionOffset
+   );
+   if (!mesh.Cache->write( header, mesh.Vertices.data(), mesh.Indices.data() )) {
+      std::cerr << "Could not cache the mesh: " << obj_file_path << "\n";
    }
+   mesh.Cache.reset();
    return true;
 }
 
+void ObjectGL::setObject(GLenum draw_mode, const MeshData& mesh, bool upload_data)
+{
+   const MeshCache::Header& header = mesh.Header;
+   setVertexFormat(
+      static_cast<PositionFormat>(header.PositionFormat),
+      static_cast<NormalFormat>(header.NormalFormat),
+      static_cast<TextureFormat>(header.TextureFormat)
+   );
+   DrawMode = draw_mode;
+   VerticesCount = static_cast<GLsizei>(header.VertexNum);
+   PositionScale = header.PositionScale;
+   PositionOffset = header.PositionOffset;
+   BoundingSphere = header.BoundingSphere;
+
+   // The vertices are uploaded directly from the mesh data, which may be mapped from the cache,
+   // so DataBuffer does not keep a copy of them.
+   DataBuffer.clear();
+   prepareVertexBuffer(
+      static_cast<int>(header.BytesPerVertex),
+      upload_data ? mesh.getVertexData() : nullptr,
+      mesh.getVertexDataSize()
+   );
+   prepareNormal();
+   prepareTexture( true );
+   setElementBuffer( upload_data ? mesh.getIndexData() : nullptr, static_cast<GLsizei>(header.IndexNum) );
+}
+
 void ObjectGL::setObject(
    GLenum draw_mode, 
    const std::string& obj_file_path, 
    const std::string& texture_file_name
 )
 {
-   DrawMode = draw_mode;
-   std::vector<glm::vec3> vertices, normals;
-   std::vector<glm::vec2> textures;
-   readObjectFile( vertices, normals, textures, obj_file_path );
-   
-   for (uint i = 0; i < vertices.size(); ++i) {
-      DataBuffer.push_back( vertices[i].x );
-      DataBuffer.push_back( vertices[i].y );
-      DataBuffer.push_back( vertices[i].z );
-      DataBuffer.push_back( normals[i].x );
-      DataBuffer.push_back( normals[i].y );
-      DataBuffer.push_back( normals[i].z );
-      DataBuffer.push_back( textures[i].x );
-      DataBuffer.push_back( textures[i].y );
-      VerticesCount++;
-   }
-   const int n_bytes_per_vertex = 8 * sizeof(GLfloat);
-   prepareVertexBuffer( n_bytes_per_vertex );
-   prepareNormal();
-   prepareTexture( true );
+   MeshData mesh;
+   if (!loadMesh( mesh, obj_file_path )) return;
+
+   setObject( draw_mode, mesh );
    addTexture( texture_file_name );
 }
 
@@ -405,12 +882,23 @@ void ObjectGL::setSquareObject(
    setObject( draw_mode, square_vertices, square_normals, square_textures, texture_file_path, is_grayscale );
 }
 
-void ObjectGL::setElementBuffer(std::vector<GLuint>& indices) const
+void ObjectGL::setElementBuffer(std::vector<GLuint>& indices)
+{
+   setElementBuffer( indices.data(), static_cast<GLsizei>(indices.size()) );
+}
+
+void ObjectGL::setElementBuffer(const GLuint* indices, GLsizei index_num)
 {
-   GLuint obj_ibo;
-   glCreateBuffers( 1, &obj_ibo );
-   glNamedBufferStorage( obj_ibo, sizeof( GLuint ) * indices.size(), indices.data(), GL_DYNAMIC_STORAGE_BIT );
-   glVertexArrayElementBuffer( VAO, obj_ibo );
+   if (IBO != 0) {
+      GPUMemoryGL::removeBuffers( 1, &IBO );
+      glDeleteBuffers( 1, &IBO );
+   }
+
+   IndicesCount = index_num;
+   glCreateBuffers( 1, &IBO );
+   glNamedBufferStorage( IBO, sizeof( GLuint ) * index_num, indices, GL_DYNAMIC_STORAGE_BIT );
+   GPUMemoryGL::addBuffer( IBO, GPUMemoryGL::Category::Index, sizeof( GLuint ) * index_num, Name, "indices" );
+   glVertexArrayElementBuffer( VAO, IBO );
 }
 
 void ObjectGL::transferUniformsToShader(const ShaderGL* shader)
@@ -420,23 +908,17 @@ void ObjectGL::transferUniformsToShader(const ShaderGL* shader)
    glUniform4fv( shader->getMaterialDiffuseLocation(), 1, &DiffuseReflectionColor[0] );
    glUniform4fv( shader->getMaterialSpecularLocation(), 1, &SpecularReflectionColor[0] );
    glUniform1f( shader->getMaterialSpecularExponentLocation(), SpecularReflectionExponent );
+   glUniform3fv( shader->getPositionScaleLocation(), 1, &PositionScale[0] );
+   glUniform3fv( shader->getPositionOffsetLocation(), 1, &PositionOffset[0] );
+   glUniform1i( shader->getOctahedralNormalLocation(), VertexNormalFormat == NormalFormat::Octahedral16 ? 1 : 0 );
 }
 
 void ObjectGL::updateDataBuffer(const std::vector<glm::vec3>& vertices, const std::vector<glm::vec3>& normals)
 {
    assert( VBO != 0 );
 
-   VerticesCount = 0;
-   DataBuffer.clear();
-   for (size_t i = 0; i < vertices.size(); ++i) {
-      DataBuffer.push_back( vertices[i].x );
-      DataBuffer.push_back( vertices[i].y );
-      DataBuffer.push_back( vertices[i].z );
-      DataBuffer.push_back( normals[i].x );
-      DataBuffer.push_back( normals[i].y );
-      DataBuffer.push_back( normals[i].z );
-      VerticesCount++;
-   }
+   VerticesCount = static_cast<GLsizei>(vertices.size());
+   VertexLayout::interleave( DataBuffer, vertices.size(), vertices.data(), normals.data() );
    glNamedBufferSubData( VBO, 0, sizeof( GLfloat ) * DataBuffer.size(), DataBuffer.data() );
 }
 
@@ -446,21 +928,10 @@ void ObjectGL::updateDataBuffer(
    const std::vector<glm::vec2>& textures
 )
 {
-   assert( VBO != 0 );
+   assert( VBO != 0 && isFloatVertexFormat() );
 
-   VerticesCount = 0;
-   DataBuffer.clear();
-   for (size_t i = 0; i < vertices.size(); ++i) {
-      DataBuffer.push_back( vertices[i].x );
-      DataBuffer.push_back( vertices[i].y );
-      DataBuffer.push_back( vertices[i].z );
-      DataBuffer.push_back( normals[i].x );
-      DataBuffer.push_back( normals[i].y );
-      DataBuffer.push_back( normals[i].z );
-      DataBuffer.push_back( textures[i].x );
-      DataBuffer.push_back( textures[i].y );
-      VerticesCount++;
-   }
+   VerticesCount = static_cast<GLsizei>(vertices.size());
+   VertexLayout::interleave( DataBuffer, vertices.size(), vertices.data(), normals.data(), textures.data() );
    glNamedBufferSubData( VBO, 0, sizeof( GLfloat ) * DataBuffer.size(), DataBuffer.data() );
 }
 
@@ -470,19 +941,7 @@ void ObjectGL::replaceVertices(
    bool textures_exist
 )
 {
-   assert( VBO != 0 );
-
-   VerticesCount = 0;
-   int step = 3;
-   if (normals_exist) step += 3;
-   if (textures_exist) step += 2;
-   for (size_t i = 0; i < vertices.size(); ++i) {
-      DataBuffer[i * step] = vertices[i].x;
-      DataBuffer[i * step + 1] = vertices[i].y;
-      DataBuffer[i * step + 2] = vertices[i].z;
-      VerticesCount++;
-   }
-   glNamedBufferSubData( VBO, 0, sizeof( GLfloat ) * VerticesCount * step, DataBuffer.data() );
+   replaceVertices( reinterpret_cast<const GLfloat*>(vertices.data()), vertices.size(), normals_exist, textures_exist );
 }
 
 void ObjectGL::replaceVertices(
@@ -491,34 +950,63 @@ void ObjectGL::replaceVertices(
    bool textures_exist
 )
 {
-   assert( VBO != 0 );
+   replaceVertices( vertices.data(), vertices.size() / 3, normals_exist, textures_exist );
+}
+
+void ObjectGL::replaceVertices(
+   const GLfloat* vertices,
+   size_t vertex_num,
+   bool normals_exist,
+   bool textures_exist
+)
+{
+   assert( VBO != 0 && isFloatVertexFormat() && !DataBuffer.empty() );
 
-   VerticesCount = 0;
    int step = 3;
    if (normals_exist) step += 3;
    if (textures_exist) step += 2;
-   for (size_t i = 0, j = 0; i < vertices.size(); i += 3, ++j) {
-      DataBuffer[j * step] = vertices[i];
-      DataBuffer[j * step + 1] = vertices[i + 1];
-      DataBuffer[j * step + 2] = vertices[i + 2];
-      VerticesCount++;
-   }
+   assert( vertex_num * step <= DataBuffer.size() );
+
+   VerticesCount = static_cast<GLsizei>(vertex_num);
+   VertexLayout::scatter<3>( DataBuffer.data(), step, 0, vertex_num, vertices );
    glNamedBufferSubData( VBO, 0, sizeof( GLfloat ) * VerticesCount * step, DataBuffer.data() );
 }
 
 void ObjectGL::prepareShaderStorageBuffer()
 {
+   assert( isFloatVertexFormat() );
+
+   // The three buffers are the previous, current, and next steps of the simulation, which are rotated every step.
+   // They do not alias VBO, so the renderer pulls the vertices from the newest one.
+   if (!ShaderStorageBufferObjects.empty()) {
+      GPUMemoryGL::removeBuffers( 3, ShaderStorageBufferObjects.data() );
+      glDeleteBuffers( 3, ShaderStorageBufferObjects.data() );
+   }
    ShaderStorageBufferObjects.resize( 3 );
-   ShaderStorageBufferObjects[0] = VBO;
-   glCreateBuffers( 1, &ShaderStorageBufferObjects[1] );
-   glCreateBuffers( 1, &ShaderStorageBufferObjects[2] );
-   
-   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 0, ShaderStorageBufferObjects[0] );
-   glBufferData( GL_SHADER_STORAGE_BUFFER, sizeof( GLfloat ) * DataBuffer.size(), DataBuffer.data(), GL_DYNAMIC_DRAW );
-
-   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 1, ShaderStorageBufferObjects[1] );
-   glBufferData( GL_SHADER_STORAGE_BUFFER, sizeof( GLfloat ) * DataBuffer.size(), DataBuffer.data(), GL_DYNAMIC_DRAW );
-   
-   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 2, ShaderStorageBufferObjects[2] );
-   glBufferData( GL_SHADER_STORAGE_BUFFER, sizeof( GLfloat ) * DataBuffer.size(), nullptr, GL_DYNAMIC_DRAW );
+   glCreateBuffers( 3, ShaderStorageBufferObjects.data() );
+   for (GLuint i = 0; i < 3; ++i) {
+      glNamedBufferStorage(
+         ShaderStorageBufferObjects[i],
+         sizeof( GLfloat ) * DataBuffer.size(),
+         DataBuffer.data(),
+         GL_DYNAMIC_STORAGE_BIT
+      );
+      GPUMemoryGL::addBuffer(
+         ShaderStorageBufferObjects[i],
+         GPUMemoryGL::Category::Storage,
+         static_cast<GLsizeiptr>(sizeof( GLfloat ) * DataBuffer.size()),
+         Name,
+         "points " + std::to_string( i )
+      );
+      glBindBufferBase( GL_SHADER_STORAGE_BUFFER, i, ShaderStorageBufferObjects[i] );
+   }
+
+   // The shaders pull the vertices from the newest of them by gl_VertexID, so VBO and its attributes are not used.
+   if (VBO != 0) {
+      for (const GLuint location : { VertexLoc, NormalLoc, TextureLoc }) glDisableVertexArrayAttrib( VAO, location );
+      glVertexArrayVertexBuffer( VAO, 0, 0, 0, 0 );
+      GPUMemoryGL::removeBuffers( 1, &VBO );
+      glDeleteBuffers( 1, &VBO );
+      VBO = 0;
+   }
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "OffscreenContext.h"
+
+#ifndef _WIN32
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+OffscreenContextGL::OffscreenContextGL() :
+   ContextBackend( Backend::None ), Window( nullptr ), Display( nullptr ), Context( nullptr ), Framebuffer( 0 ),
+   Renderbuffers{}
+{
+}
+
+OffscreenContextGL::~OffscreenContextGL()
+{
+   destroy();
+}
+
+#ifdef _WIN32
+bool OffscreenContextGL::createEGLContext()
+{
+   return false;
+}
+
+void OffscreenContextGL::destroyEGLContext()
+{
+}
+#else
+bool OffscreenContextGL::createEGLContext()
+{
+   // The surfaceless platform of Mesa needs neither a display server nor a GPU. Otherwise, the default display may
+   // still be one without a display server, as the one of the proprietary drivers is.
+   EGLDisplay display = EGL_NO_DISPLAY;
+   const char* extensions = eglQueryString( EGL_NO_DISPLAY, EGL_EXTENSIONS );
+   const auto get_platform_display =
+      reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress( "eglGetPlatformDisplayEXT" ));
+   if (extensions != nullptr && std::strstr( extensions, "EGL_MESA_platform_surfaceless" ) != nullptr &&
+       get_platform_display != nullptr) {
+      display = get_platform_display( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr );
+   }
+   EGLint major, minor;
+   if (display == EGL_NO_DISPLAY || !eglInitialize( display, &major, &minor )) {
+      display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+      if (display == EGL_NO_DISPLAY || !eglInitialize( display, &major, &minor )) return false;
+   }
+   Display = display;
+
+   // The context is made current without a surface and a config, as it draws only into the framebuffer objects.
+   const char* display_extensions = eglQueryString( display, EGL_EXTENSIONS );
+   if (display_extensions == nullptr ||
+       std::strstr( display_extensions, "EGL_KHR_surfaceless_context" ) == nullptr ||
+       std::strstr( display_extensions, "EGL_KHR_no_config_context" ) == nullptr ||
+       !eglBindAPI( EGL_OPENGL_API )) {
+      destroyEGLContext();
+      return false;
+   }
+   const std::array<EGLint, 7> attributes = {
+      EGL_CONTEXT_MAJOR_VERSION, 4,
+      EGL_CONTEXT_MINOR_VERSION, 6,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+      EGL_NONE
+   };
+   Context = eglCreateContext( display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes.data() );
+   if (Context == EGL_NO_CONTEXT || !eglMakeCurrent( display, EGL_NO_SURFACE, EGL_NO_SURFACE, Context )) {
+      destroyEGLContext();
+      return false;
+   }
+   if (!gladLoadGLLoader( (GLADloadproc)eglGetProcAddress )) {
+      destroyEGLContext();
+      return false;
+   }
+   return true;
+}
+
+void OffscreenContextGL::destroyEGLContext()
+{
+   if (Display == nullptr) return;
+
+   eglMakeCurrent( Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+   if (Context != nullptr) eglDestroyContext( Display, Context );
+   eglTerminate( Display );
+   Display = nullptr;
+   Context = nullptr;
+}
+#endif
+
+bool OffscreenContextGL::createWindowContext()
+{
+   if (!glfwInit()) return false;
+
+   glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+   glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 6 );
+   glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+   glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+   Window = glfwCreateWindow( 64, 64, "Offscreen", nullptr, nullptr );
+   if (Window == nullptr) {
+      glfwTerminate();
+      return false;
+   }
+
+   glfwMakeContextCurrent( Window );
+   if (!gladLoadGLLoader( (GLADloadproc)glfwGetProcAddress )) {
+      glfwDestroyWindow( Window );
+      glfwTerminate();
+      Window = nullptr;
+      return false;
+   }
+   return true;
+}
+
+bool OffscreenContextGL::create()
+{
+   if (isCreated()) return true;
+
+   if (createEGLContext()) ContextBackend = Backend::EGL;
+   else if (createWindowContext()) ContextBackend = Backend::HiddenWindow;
+   else return false;
+   Renderer = reinterpret_cast<const char*>(glGetString( GL_RENDERER ));
+   return true;
+}
+
+bool OffscreenContextGL::createFramebuffer(int width, int height)
+{
+   if (!isCreated() || width <= 0 || height <= 0) return false;
+
+   if (Framebuffer != 0) {
+      glDeleteFramebuffers( 1, &Framebuffer );
+      GPUMemoryGL::removeRenderbuffers( 2, Renderbuffers.data() );
+      glDeleteRenderbuffers( 2, Renderbuffers.data() );
+   }
+   // Both formats take 4 bytes per pixel.
+   const GLsizeiptr size = static_cast<GLsizeiptr>(4) * width * height;
+   glCreateRenderbuffers( 2, Renderbuffers.data() );
+   glNamedRenderbufferStorage( Renderbuffers[0], GL_RGBA8, width, height );
+   glNamedRenderbufferStorage( Renderbuffers[1], GL_DEPTH24_STENCIL8, width, height );
+   GPUMemoryGL::addRenderbuffer( Renderbuffers[0], size, "OffscreenContext", "color" );
+   GPUMemoryGL::addRenderbuffer( Renderbuffers[1], size, "OffscreenContext", "depth stencil" );
+   glCreateFramebuffers( 1, &Framebuffer );
+   glNamedFramebufferRenderbuffer( Framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, Renderbuffers[0] );
+   glNamedFramebufferRenderbuffer( Framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, Renderbuffers[1] );
+   if (glCheckNamedFramebufferStatus( Framebuffer, GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE) {
+      std::cerr << "The offscreen framebuffer of " << width << "x" << height << " is not complete.\n";
+      return false;
+   }
+   glBindFramebuffer( GL_FRAMEBUFFER, Framebuffer );
+   return true;
+}
+
+void OffscreenContextGL::destroy()
+{
+   if (!isCreated()) return;
+
+   if (Framebuffer != 0) {
+      glDeleteFramebuffers( 1, &Framebuffer );
+      GPUMemoryGL::removeRenderbuffers( 2, Renderbuffers.data() );
+      glDeleteRenderbuffers( 2, Renderbuffers.data() );
+      Framebuffer = 0;
+      Renderbuffers.fill( 0 );
+   }
+   if (ContextBackend == Backend::EGL) destroyEGLContext();
+   else {
+      glfwDestroyWindow( Window );
+      glfwTerminate();
+      Window = nullptr;
+   }
+   ContextBackend = Backend::None;
+   Renderer.clear();
+}
\ No newline at end of file
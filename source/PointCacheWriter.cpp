@@ -0,0 +1,54 @@
+#include "PointCacheWriter.h"
+
+PointCacheWriter::PointCacheWriter() : Header{}
+{
+}
+
+PointCacheWriter::~PointCacheWriter()
+{
+   close();
+}
+
+bool PointCacheWriter::open(const std::string& file_path, int point_num, float start_frame, float sample_rate)
+{
+   close();
+
+   std::error_code error;
+   std::filesystem::create_directories( std::filesystem::path(file_path).parent_path(), error );
+   File.open( file_path, std::ios::binary | std::ios::trunc );
+   if (!File.is_open()) {
+      std::cerr << "Cannot write the point cache: " << file_path << "\n";
+      return false;
+   }
+
+   Header.Signature = Signature;
+   Header.FileVersion = 1;
+   Header.PointNum = point_num;
+   Header.StartFrame = start_frame;
+   Header.SampleRate = sample_rate;
+   Header.SampleNum = 0;
+   File.write( reinterpret_cast<const char*>(&Header), sizeof( PC2Header ) );
+   Positions.resize( static_cast<size_t>(point_num) * 3 );
+   return true;
+}
+
+void PointCacheWriter::addFrame(const float* points, int stride)
+{
+   if (!isOpen()) return;
+
+   for (int i = 0; i < Header.PointNum; ++i) {
+      std::memcpy( &Positions[static_cast<size_t>(i) * 3], points + static_cast<size_t>(i) * stride, sizeof( float ) * 3 );
+   }
+   File.write( reinterpret_cast<const char*>(Positions.data()), static_cast<std::streamsize>(sizeof( float ) * Positions.size()) );
+   Header.SampleNum++;
+}
+
+void PointCacheWriter::close()
+{
+   if (!isOpen()) return;
+
+   File.seekp( 0 );
+   File.write( reinterpret_cast<const char*>(&Header), sizeof( PC2Header ) );
+   File.close();
+   if (!File) std::cerr << "Could not finish the point cache\n";
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "PointCodec.h"
+
+void PointCodec::BitWriter::write(uint32_t value, int bit_num)
+{
+   Bits |= static_cast<uint64_t>(value) << BitNum;
+   BitNum += bit_num;
+   while (BitNum >= 8) {
+      Bytes.emplace_back( static_cast<uint8_t>(Bits) );
+      Bits >>= 8;
+      BitNum -= 8;
+   }
+}
+
+void PointCodec::BitWriter::flush()
+{
+   if (BitNum > 0) Bytes.emplace_back( static_cast<uint8_t>(Bits) );
+   Bits = 0;
+   BitNum = 0;
+}
+
+bool PointCodec::BitReader::read(uint32_t& value, int bit_num)
+{
+   while (BitNum < bit_num) {
+      if (Position >= Size) return false;
+      Bits |= static_cast<uint64_t>(Bytes[Position++]) << BitNum;
+      BitNum += 8;
+   }
+   value = static_cast<uint32_t>(Bits & ((1ull << bit_num) - 1));
+   Bits >>= bit_num;
+   BitNum -= bit_num;
+   return true;
+}
+
+int PointCodec::getPrediction(const std::vector<uint32_t>& quantized, int point_num, int frame, int index)
+{
+   // The quantized values are laid out as [frame][component][point], and index is of [component][point].
+   const size_t frame_size = static_cast<size_t>(point_num) * 3;
+   if (frame == 0) return index % point_num == 0 ? 0 : static_cast<int>(quantized[index - 1]);
+
+   const auto previous = static_cast<int>(quantized[(frame - 1) * frame_size + index]);
+   if (frame == 1) return previous;
+
+   // The cloth moves smoothly, so it is extrapolated with the velocity of the previous frames.
+   const auto before_previous = static_cast<int>(quantized[(frame - 2) * frame_size + index]);
+   return std::clamp( 2 * previous - before_previous, 0, static_cast<int>(QuantizedMax) );
+}
+
+int PointCodec::getRiceParameter(const uint32_t* values, int value_num)
+{
+   uint64_t sum = 0;
+   for (int i = 0; i < value_num; ++i) sum += values[i];
+   const uint64_t mean = sum / static_cast<uint64_t>(value_num);
+   int k = 0;
+   while (k < 24 && (2ull << k) <= mean) k++;
+   return k;
+}
+
+void PointCodec::encodeChunk(std::vector<uint8_t>& encoded, const std::vector<glm::vec3>& positions, int point_num)
+{
+   const auto frame_num = static_cast<int>(positions.size() / point_num);
+   glm::vec3 min_point(std::numeric_limits<float>::max());
+   glm::vec3 max_point(std::numeric_limits<float>::lowest());
+   for (const auto& position : positions) {
+      min_point = glm::min( min_point, position );
+      max_point = glm::max( max_point, position );
+   }
+
+   encoded.clear();
+   encoded.resize( sizeof( glm::vec3 ) * 2 );
+   std::memcpy( encoded.data(), &min_point, sizeof( glm::vec3 ) );
+   std::memcpy( encoded.data() + sizeof( glm::vec3 ), &max_point, sizeof( glm::vec3 ) );
+
+   const glm::vec3 extent = max_point - min_point;
+   const size_t frame_size = static_cast<size_t>(point_num) * 3;
+   std::vector<uint32_t> quantized(frame_size * frame_num);
+   for (int f = 0; f < frame_num; ++f) {
+      for (int c = 0; c < 3; ++c) {
+         const float scale = extent[c] > 0.0f ? static_cast<float>(QuantizedMax) / extent[c] : 0.0f;
+         for (int i = 0; i < point_num; ++i) {
+            const float value = (positions[static_cast<size_t>(f) * point_num + i][c] - min_point[c]) * scale;
+            quantized[f * frame_size + c * point_num + i] =
+               static_cast<uint32_t>(std::clamp( std::lround( value ), 0l, static_cast<long>(QuantizedMax) ));
+         }
+      }
+   }
+
+   BitWriter writer(encoded);
+   std::vector<uint32_t> residuals(frame_size);
+   for (int f = 0; f < frame_num; ++f) {
+      for (int i = 0; i < static_cast<int>(frame_size); ++i) {
+         const int residual = static_cast<int>(quantized[f * frame_size + i]) - getPrediction( quantized, point_num, f, i );
+         residuals[i] = residual >= 0 ? static_cast<uint32_t>(residual) << 1 : (static_cast<uint32_t>(-residual) << 1) - 1;
+      }
+
+      // The residuals of a component are similar, so the blocks do not span the components.
+      for (int c = 0; c < 3; ++c) {
+         for (int first = 0; first < point_num; first += RiceBlockSize) {
+            const uint32_t* block = residuals.data() + c * point_num + first;
+            const int block_size = std::min( RiceBlockSize, point_num - first );
+            const int k = getRiceParameter( block, block_size );
+            writer.write( static_cast<uint32_t>(k), 5 );
+            for (int i = 0; i < block_size; ++i) {
+               const uint32_t quotient = block[i] >> k;
+               if (quotient < EscapeQuotient) {
+                  writer.write( (1u << quotient) - 1, static_cast<int>(quotient) + 1 );
+                  if (k > 0) writer.write( block[i] & ((1u << k) - 1), k );
+               }
+               else {
+                  writer.write( (1u << EscapeQuotient) - 1, static_cast<int>(EscapeQuotient) );
+                  writer.write( block[i], QuantizationBits + 2 );
+               }
+            }
+         }
+      }
+   }
+   writer.flush();
+}
+
+bool PointCodec::decodeChunk(
+   std::vector<glm::vec3>& positions,
+   const uint8_t* encoded,
+   size_t size,
+   int point_num,
+   int frame_num
+)
+{
+   if (size < sizeof( glm::vec3 ) * 2) return false;
+
+   glm::vec3 min_point, max_point;
+   std::memcpy( &min_point, encoded, sizeof( glm::vec3 ) );
+   std::memcpy( &max_point, encoded + sizeof( glm::vec3 ), sizeof( glm::vec3 ) );
+
+   const size_t frame_size = static_cast<size_t>(point_num) * 3;
+   std::vector<uint32_t> quantized(frame_size * frame_num);
+   BitReader reader(encoded + sizeof( glm::vec3 ) * 2, size - sizeof( glm::vec3 ) * 2);
+   for (int f = 0; f < frame_num; ++f) {
+      for (int c = 0; c < 3; ++c) {
+         for (int first = 0; first < point_num; first += RiceBlockSize) {
+            uint32_t k;
+            if (!reader.read( k, 5 )) return false;
+
+            const int block_size = std::min( RiceBlockSize, point_num - first );
+            for (int i = 0; i < block_size; ++i) {
+               uint32_t bit = 1, quotient = 0;
+               while (quotient < EscapeQuotient) {
+                  if (!reader.read( bit, 1 )) return false;
+                  if (bit == 0) break;
+                  quotient++;
+               }
+
+               uint32_t residual;
+               if (quotient < EscapeQuotient) {
+                  uint32_t remainder = 0;
+                  if (k > 0 && !reader.read( remainder, static_cast<int>(k) )) return false;
+                  residual = (quotient << k) | remainder;
+               }
+               else if (!reader.read( residual, QuantizationBits + 2 )) return false;
+
+               const int index = c * point_num + first + i;
+               const int difference = residual & 1u ? -static_cast<int>((residual + 1) >> 1) : static_cast<int>(residual >> 1);
+               const int value = getPrediction( quantized, point_num, f, index ) + difference;
+               if (value < 0 || value > static_cast<int>(QuantizedMax)) return false;
+               quantized[f * frame_size + index] = static_cast<uint32_t>(value);
+            }
+         }
+      }
+   }
+
+   const glm::vec3 step = (max_point - min_point) / static_cast<float>(QuantizedMax);
+   positions.resize( static_cast<size_t>(point_num) * frame_num );
+   for (int f = 0; f < frame_num; ++f) {
+      for (int i = 0; i < point_num; ++i) {
+         glm::vec3& position = positions[static_cast<size_t>(f) * point_num + i];
+         for (int c = 0; c < 3; ++c) {
+            position[c] = min_point[c] + step[c] * static_cast<float>(quantized[f * frame_size + c * point_num + i]);
+         }
+      }
+   }
+   return true;
+}
\ No newline at end of file
@@ -1,19 +1,28 @@
 #include "Renderer.h"
 
-RendererGL::RendererGL() : 
-   Window( nullptr ), FrameWidth( 1920 ), FrameHeight( 1080 ), ClickedPoint( -1, -1 ),
-   ClothTargetIndex( 0 ), ClothPointNumSize( 100, 100 ), ClothGridSize( 50, 50 ),
-   SpherePosition( 0.0f, 0.0f, 0.0f ), SphereRadius( 20.0f ),
-   ClothWorldMatrix( translate( glm::mat4(1.0f), glm::vec3(50.0f, 100.0f, 0.0f) ) ),
-   SphereWorldMatrix( translate( glm::mat4(1.0f), glm::vec3(100.0f, 30.0f, 20.0f) ) ),
-   MainCamera( std::make_unique<CameraGL>() ), ObjectShader( std::make_unique<ShaderGL>() ),
+RendererGL::RendererGL(bool headless, int frame_width, int frame_height) :
+   UseTessellation( false ), Headless( headless ), CaptureOnStart( false ), GPUMemoryReport( false ),
+   UseStatistics( false ), ShowOverlay( false ), FrameLimit( 0 ), Window( nullptr ),
+   FrameWidth( frame_width ), FrameHeight( frame_height ), ClickedPoint( -1, -1 ),
+   ClothTargetIndex( 0 ), ClothDrawIndex( -1 ), ClothPatchDrawIndex( -1 ), SphereDrawIndex( -1 ),
+   SphereRadius( 0.0f ), UseSphereCollider( false ), TessellationEdgeLength( 0.0f ), CaptureFormat( FrameCaptureGL::CaptureFormat::Y4M ), FrameTime( 0.0 ),
+   PlaybackFrame( 0 ),
+   HeadlessContext( std::make_unique<OffscreenContextGL>() ), MainCamera( std::make_unique<CameraGL>() ), ObjectShader( std::make_unique<ShaderGL>() ),
+   ClothShader( std::make_unique<ShaderGL>() ), ClothSurfaceShader( std::make_unique<ShaderGL>() ),
    ClothObject( std::make_unique<ObjectGL>() ), SphereObject( std::make_unique<ObjectGL>() ),
-   Lights( std::make_unique<LightGL>() )
+   Lights( std::make_unique<LightGL>() ), IndirectDraws( std::make_unique<IndirectDrawGL>() ),
+   AssetLoader( std::make_unique<AssetLoaderGL>() ), Recorder( std::make_unique<SimulationRecorder>() ),
+   Player( std::make_unique<SimulationPlayer>() ), PointCache( std::make_unique<PointCacheWriter>() ),
+   Capture( std::make_unique<FrameCaptureGL>() ), GPUProfiler( std::make_unique<GPUProfilerGL>() ),
+   Statistics( std::make_unique<ClothStatisticsGL>() ), Overlay( std::make_unique<TextOverlayGL>() ),
+   Pacer( std::make_unique<FramePacerGL>() )
 {
    Renderer = this;
 
-   initialize();
-   printOpenGLInformation();
+   setSceneDescription( SceneDescription() );
+   ClothObject->setName( "Cloth" );
+   SphereObject->setName( "Sphere" );
+   if (initialize()) printOpenGLInformation();
 }
 
 void RendererGL::printOpenGLInformation()
@@ -26,11 +35,11 @@ void RendererGL::printOpenGLInformation()
    std::cout << "****************************************************************\n\n";
 }
 
-void RendererGL::initialize()
+bool RendererGL::createWindow()
 {
    if (!glfwInit()) {
       std::cout << "Cannot Initialize OpenGL...\n";
-      return;
+      return false;
    }
    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 6 );
@@ -42,10 +51,23 @@ void RendererGL::initialize()
 
    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
       std::cout << "Failed to initialize GLAD" << std::endl;
-      return;
+      return false;
    }
    
    registerCallbacks();
+   return true;
+}
+
+bool RendererGL::initialize()
+{
+   const ZoneProfiler::Zone zone( "initialize" );
+   if (Headless) {
+      if (!HeadlessContext->create() || !HeadlessContext->createFramebuffer( FrameWidth, FrameHeight )) {
+         std::cout << "Cannot Initialize OpenGL without a window...\n";
+         return false;
+      }
+   }
+   else if (!createWindow()) return false;
    
    glEnable( GL_DEPTH_TEST );
    glClearColor( 0.3f, 0.3f, 0.3f, 1.0f );
@@ -57,9 +79,18 @@ void RendererGL::initialize()
       std::string(shader_directory_path + "/BasicPipeline.vert").c_str(),
       std::string(shader_directory_path + "/BasicPipeline.frag").c_str()
    );
-   ObjectShader->setComputeShaders( { 
-      std::string(shader_directory_path + "/ClothSimulator.comp").c_str()
-   } );
+   ClothShader->setShader(
+      std::string(shader_directory_path + "/ClothPipeline.vert").c_str(),
+      std::string(shader_directory_path + "/BasicPipeline.frag").c_str()
+   );
+   ClothSurfaceShader->setShader(
+      std::string(shader_directory_path + "/ClothSurface.vert").c_str(),
+      std::string(shader_directory_path + "/BasicPipeline.frag").c_str(),
+      nullptr,
+      std::string(shader_directory_path + "/ClothSurface.tesc").c_str(),
+      std::string(shader_directory_path + "/ClothSurface.tese").c_str()
+   );
+   return true;
 }
 
 void RendererGL::error(int error, const char* description) const
@@ -86,6 +117,7 @@ void RendererGL::keyboard(GLFWwindow* window, int key, int scancode, int action,
 {
    if (action != GLFW_PRESS) return;
 
+   Pacer->markInput();
    switch (key) {
       case GLFW_KEY_UP:
          MainCamera->moveForward();
@@ -112,6 +144,35 @@ void RendererGL::keyboard(GLFWwindow* window, int key, int scancode, int action,
          Lights->toggleLightSwitch();
          std::cout << "Light Turned " << (Lights->isLightOn() ? "On!\n" : "Off!\n");
          break;
+      case GLFW_KEY_T:
+         UseTessellation = !UseTessellation;
+         std::cout << "Cloth Tessellation Turned " << (UseTessellation ? "On!\n" : "Off!\n");
+         break;
+      case GLFW_KEY_R:
+         toggleRecording();
+         break;
+      case GLFW_KEY_V:
+         togglePlayback();
+         break;
+      case GLFW_KEY_E:
+         togglePointCacheExport();
+         break;
+      case GLFW_KEY_C:
+         toggleFrameCapture();
+         break;
+      case GLFW_KEY_F5:
+         saveCheckpoint();
+         break;
+      case GLFW_KEY_F9:
+         loadCheckpoint( getCheckpointPath() );
+         break;
+      case GLFW_KEY_O:
+         if (UseStatistics) {
+            ShowOverlay = !ShowOverlay;
+            std::cout << "Statistics Overlay Turned " << (ShowOverlay ? "On!\n" : "Off!\n");
+         }
+         else std::cout << "The statistics are not enabled, so run with --stats to show them.\n";
+         break;
       case GLFW_KEY_P: {
          const glm::vec3 pos = MainCamera->getCameraPosition();
          std::cout << "Camera Position: " << pos.x << ", " << pos.y << ", " << pos.z << "\n";
@@ -133,6 +194,7 @@ void RendererGL::keyboardWrapper(GLFWwindow* window, int key, int scancode, int
 void RendererGL::cursor(GLFWwindow* window, double xpos, double ypos)
 {
    if (MainCamera->getMovingState()) {
+      Pacer->markInput();
       const auto x = static_cast<int>(round( xpos ));
       const auto y = static_cast<int>(round( ypos ));
       const int dx = x - ClickedPoint.x;
@@ -157,6 +219,7 @@ void RendererGL::cursorWrapper(GLFWwindow* window, double xpos, double ypos)
 void RendererGL::mouse(GLFWwindow* window, int button, int action, int mods)
 {
    if (button == GLFW_MOUSE_BUTTON_LEFT) {
+      Pacer->markInput();
       const bool moving_state = action == GLFW_PRESS;
       if (moving_state) {
          double x, y;
@@ -175,6 +238,7 @@ void RendererGL::mouseWrapper(GLFWwindow* window, int button, int action, int mo
 
 void RendererGL::mousewheel(GLFWwindow* window, double xoffset, double yoffset) const
 {
+   Pacer->markInput();
    if (yoffset >= 0.0) MainCamera->zoomIn();
    else MainCamera->zoomOut();
 }
@@ -206,33 +270,90 @@ void RendererGL::registerCallbacks() const
    glfwSetFramebufferSizeCallback( Window, reshapeWrapper );
 }
 
+bool RendererGL::setScene()
+{
+   const ZoneProfiler::Zone zone( "setScene" );
+   setComputeShaders();
+   setLights();
+   setClothObject();
+   setSphereObject();
+   setClothPhysicsVariables();
+   setCullingVariables();
+   setIndirectDraws();
+   ObjectShader->setUniformLocations( Lights->getTotalLightNum() );
+   setClothShaderVariables();
+   if (UseStatistics) {
+      const glm::ivec2 tile_num = getClothWorkGroupNum();
+      Statistics->prepare( getClothPointNum(), tile_num.x * tile_num.y );
+   }
+   if (!WarmStartPath.empty()) loadCheckpoint( WarmStartPath );
+   // The textures are still loading, so the budget is checked against what the scene allocates at once.
+   if (GPUMemoryGL::isOverBudget()) {
+      std::cerr << "The scene needs " << GPUMemoryGL::toMiB( GPUMemoryGL::getTotalSize() )
+         << " MiB of GPU memory, which exceeds the budget of " << GPUMemoryGL::toMiB( GPUMemoryGL::getBudget() ) << " MiB.\n";
+      return false;
+   }
+   return true;
+}
+
+void RendererGL::setSceneDescription(const SceneDescription& scene)
+{
+   ClothPointNumSize = scene.Cloth.PointNum;
+   ClothGridSize = scene.Cloth.GridSize;
+   ClothWorldMatrix = scene.Cloth.ClothWorldMatrix;
+   SphereWorldMatrix = scene.Cloth.SphereWorldMatrix;
+   SpherePosition = scene.Cloth.SpherePosition;
+   SphereRadius = scene.Cloth.SphereRadius;
+   UseSphereCollider = scene.Cloth.UseSphereCollider;
+   ClothPhysics = scene.Physics;
+   LightPosition = scene.LightPosition;
+   LightAmbientColor = scene.LightAmbientColor;
+   LightDiffuseColor = scene.LightDiffuseColor;
+   LightSpecularColor = scene.LightSpecularColor;
+   UseTessellation = scene.UseTessellation;
+   TessellationEdgeLength = scene.TessellationEdgeLength;
+}
+
 void RendererGL::setLights() const
-{  
-   const glm::vec4 light_position(30.0f, 500.0f, 30.0f, 1.0f);
-   const glm::vec4 ambient_color(1.0f, 1.0f, 1.0f, 1.0f);
-   const glm::vec4 diffuse_color(0.7f, 0.7f, 0.7f, 1.0f);
-   const glm::vec4 specular_color(0.9f, 0.9f, 0.9f, 1.0f);
-   Lights->addLight( light_position, ambient_color, diffuse_color, specular_color );
+{
+   Lights->addLight( LightPosition, LightAmbientColor, LightDiffuseColor, LightSpecularColor );
+}
+
+void RendererGL::setComputeShaders() const
+{
+   // The grid size is fixed in the simulator, so the compiler can fold the indexing and the tiles need not divide it.
+   // It is compiled with the scene, as the scene file can change the grid size.
+   const std::string shader_directory_path = std::string(CMAKE_SOURCE_DIR) + "/shaders";
+   const ShaderGL::DefineSet cloth_simulator_defines = {
+      { "WORKGROUP_SIZE_X", std::to_string( ClothWorkGroupSize ) },
+      { "WORKGROUP_SIZE_Y", std::to_string( ClothWorkGroupSize ) },
+      { "CLOTH_POINT_NUM_X", std::to_string( ClothPointNumSize.x ) },
+      { "CLOTH_POINT_NUM_Y", std::to_string( ClothPointNumSize.y ) },
+      { "USE_SPHERE_COLLIDER", UseSphereCollider ? "1" : "0" },
+      { "USE_COUNTERS", UseStatistics ? "1" : "0" }
+   };
+   const ShaderGL::DefineSet frustum_culling_defines = {
+      { "WORKGROUP_SIZE_X", std::to_string( IndirectDrawGL::CullingWorkGroupSize ) }
+   };
+   ObjectShader->setComputeShaders(
+      {
+         std::string(shader_directory_path + "/ClothSimulator.comp").c_str(),
+         std::string(shader_directory_path + "/FrustumCulling.comp").c_str(),
+         std::string(shader_directory_path + "/ClothBoundingSphere.comp").c_str()
+      },
+      { cloth_simulator_defines, frustum_culling_defines }
+   );
 }
 
 void RendererGL::setClothObject() const
 {
-   const float ds = 1.0f / static_cast<float>(ClothPointNumSize.x - 1);
-   const float dt = 1.0f / static_cast<float>(ClothPointNumSize.y - 1);
-   const float dx = static_cast<float>(ClothGridSize.x) * ds;
-   const float dy = static_cast<float>(ClothGridSize.y) * dt;
-   
-   std::vector<glm::vec3> cloth_vertices, cloth_normals;
+   ClothSetup setup;
+   setup.PointNum = ClothPointNumSize;
+   setup.GridSize = ClothGridSize;
+   std::vector<glm::vec3> cloth_vertices;
    std::vector<glm::vec2> cloth_textures;
-   for (int j = 0; j < ClothPointNumSize.y; ++j) {
-      const auto y = static_cast<float>(j);
-      for (int i = 0; i < ClothPointNumSize.x; ++i) {
-         const auto x = static_cast<float>(i);   
-         cloth_vertices.emplace_back( x * dx, 0.0f, y * dy );
-         cloth_normals.emplace_back( 0.0f, 1.0f, 0.0f );
-         cloth_textures.emplace_back( x * ds, y * dt );
-      }
-   }
+   setup.buildPoints( cloth_vertices, cloth_textures );
+   const std::vector<glm::vec3> cloth_normals(cloth_vertices.size(), glm::vec3(0.0f, 1.0f, 0.0f));
 
    std::vector<GLuint> indices;
    for (int j = 0; j < ClothPointNumSize.y - 1; ++j) {
@@ -242,27 +363,46 @@ void RendererGL::setClothObject() const
       }
    }
 
+   // The patches for the tessellated surface follow the strips in the same element buffer.
+   // Each patch has 4x4 points around a grid cell, and the points out of the cloth are clamped to the border.
+   for (int j = 0; j < ClothPointNumSize.y - 1; ++j) {
+      for (int i = 0; i < ClothPointNumSize.x - 1; ++i) {
+         for (int r = -1; r <= 2; ++r) {
+            const int y = std::clamp( j + r, 0, ClothPointNumSize.y - 1 );
+            for (int c = -1; c <= 2; ++c) {
+               const int x = std::clamp( i + c, 0, ClothPointNumSize.x - 1 );
+               indices.emplace_back( y * ClothPointNumSize.x + x );
+            }
+         }
+      }
+   }
+
    const std::string sample_directory_path = std::string(CMAKE_SOURCE_DIR) + "/samples";
-   ClothObject->setObject( 
-      GL_TRIANGLE_STRIP, 
-      cloth_vertices, 
-      cloth_normals, 
-      cloth_textures, 
-      std::string(sample_directory_path + "/cloth.jpg") 
-   );
+   ClothObject->setObject( GL_TRIANGLE_STRIP, cloth_vertices, cloth_normals, cloth_textures );
    ClothObject->setElementBuffer( indices );
+   AssetLoader->requestTexture( ClothObject.get(), std::string(sample_directory_path + "/cloth.jpg") );
    ClothObject->setDiffuseReflectionColor( { 1.0f, 1.0f, 1.0f, 1.0f } );
    ClothObject->prepareShaderStorageBuffer();
 }
 
-void RendererGL::setSphereObject() const
+void RendererGL::setSphereObject()
 {
    const std::string sample_directory_path = std::string(CMAKE_SOURCE_DIR) + "/samples";
-   SphereObject->setObject( 
-      GL_TRIANGLES, 
-      std::string(sample_directory_path + "/sphere.obj"), 
-      std::string(sample_directory_path + "/sphere.jpg") 
+   SphereObject->setVertexFormat(
+      ObjectGL::PositionFormat::Unorm16,
+      ObjectGL::NormalFormat::Octahedral16,
+      ObjectGL::TextureFormat::HalfFloat16
+   );
+   // The sphere is not drawn until it is loaded, because its draw command has no index until then.
+   AssetLoader->requestObject(
+      SphereObject.get(),
+      GL_TRIANGLES,
+      std::string(sample_directory_path + "/sphere.obj"),
+      [this]() {
+         IndirectDraws->setCommands( SphereDrawIndex, { { static_cast<GLuint>(SphereObject->getIndexNum()), 0 } } );
+      }
    );
+   AssetLoader->requestTexture( SphereObject.get(), std::string(sample_directory_path + "/sphere.jpg") );
    SphereObject->setDiffuseReflectionColor( { 1.0f, 1.0f, 1.0f, 1.0f } );
 }
 
@@ -288,98 +428,551 @@ void RendererGL::setClothPhysicsVariables() const
    ObjectShader->addUniformLocationToComputeShader( "SphereWorldMatrix", 0 );
 }
 
+void RendererGL::setCullingVariables() const
+{
+   ObjectShader->addUniformLocationToComputeShader( "FrustumPlanes", 1 );
+   ObjectShader->addUniformLocationToComputeShader( "BoundsWorldMatrix", 2 );
+   ObjectShader->addUniformLocationToComputeShader( "BoundingSphereIndices", 2 );
+}
+
+void RendererGL::setClothShaderVariables() const
+{
+   ClothShader->setUniformLocations( Lights->getTotalLightNum() );
+   ClothShader->addUniformLocation( "ClothPointNumX" );
+   ClothSurfaceShader->setUniformLocations( Lights->getTotalLightNum() );
+   ClothSurfaceShader->addUniformLocation( "ViewportSize" );
+   ClothSurfaceShader->addUniformLocation( "TessellationEdgeLength" );
+}
+
+void RendererGL::setIndirectDraws()
+{
+   std::vector<IndirectDrawGL::DrawElementsCommand> cloth_commands;
+   for (int j = 0; j < ClothPointNumSize.y - 1; ++j) {
+      cloth_commands.emplace_back( ClothPointNumSize.x * 2, j * ClothPointNumSize.x * 2 );
+   }
+   ClothDrawIndex = IndirectDraws->addObject( cloth_commands );
+
+   const GLuint strip_index_num = (ClothPointNumSize.y - 1) * ClothPointNumSize.x * 2;
+   const GLuint patch_index_num = (ClothPointNumSize.y - 1) * (ClothPointNumSize.x - 1) * 16;
+   ClothPatchDrawIndex = IndirectDraws->addObject( { { patch_index_num, strip_index_num } } );
+   SphereDrawIndex = IndirectDraws->addObject( { { static_cast<GLuint>(SphereObject->getIndexNum()), 0 } } );
+   IndirectDraws->setBoundingSphereOnGPU( ClothDrawIndex );
+   IndirectDraws->setBoundingSphereOnGPU( ClothPatchDrawIndex );
+   IndirectDraws->prepareBuffers();
+}
+
+glm::vec4 RendererGL::getSphereBoundingSphere() const
+{
+   const glm::mat4 to_world = SphereWorldMatrix * translate( glm::mat4(1.0f), SpherePosition );
+   const glm::vec4& sphere = SphereObject->getBoundingSphere();
+   const float scale = std::max(
+      glm::length( glm::vec3(to_world[0]) ),
+      std::max( glm::length( glm::vec3(to_world[1]) ), glm::length( glm::vec3(to_world[2]) ) )
+   );
+   return { glm::vec3(to_world * glm::vec4(glm::vec3(sphere), 1.0f)), sphere.w * scale };
+}
+
+GLuint RendererGL::getNewestClothBuffer() const
+{
+   // ClothTargetIndex points to the previous step of the next dispatch, so the newest one is right after it.
+   return ClothObject->getShaderStorageBuffer( (ClothTargetIndex + 1) % 3 );
+}
+
+std::string RendererGL::getRecordingPath()
+{
+   return std::string(CMAKE_BINARY_DIR) + "/recordings/cloth.crec";
+}
+
+std::string RendererGL::getPointCachePath()
+{
+   return std::string(CMAKE_BINARY_DIR) + "/recordings/cloth.pc2";
+}
+
+std::string RendererGL::getCheckpointPath()
+{
+   return std::string(CMAKE_BINARY_DIR) + "/checkpoints/cloth.checkpoint";
+}
+
+void RendererGL::saveCheckpoint() const
+{
+   // It is saved only on request, so the buffers are read back synchronously.
+   ClothCheckpoint::Ring buffers;
+   const auto size = static_cast<GLsizeiptr>(sizeof( GLfloat ) * ClothPointStride * getClothPointNum());
+   for (int i = 0; i < ClothCheckpoint::RingSize; ++i) {
+      buffers[i].resize( static_cast<size_t>(ClothPointStride) * getClothPointNum() );
+      glGetNamedBufferSubData( ClothObject->getShaderStorageBuffer( i ), 0, size, buffers[i].data() );
+   }
+
+   ClothCheckpoint::Header header{};
+   header.TargetIndex = ClothTargetIndex;
+   header.Parameters = ClothPhysics;
+   header.ClothWorldMatrix = ClothWorldMatrix;
+   header.SphereWorldMatrix = SphereWorldMatrix;
+   header.SpherePosition = SpherePosition;
+   header.SphereRadius = SphereRadius;
+   if (ClothCheckpoint::write( getCheckpointPath(), header, buffers, ClothPointStride )) {
+      std::cout << "Checkpoint Saved: " << getCheckpointPath() << "\n";
+   }
+}
+
+bool RendererGL::loadCheckpoint(const std::string& checkpoint_path)
+{
+   if (Player->isOpen()) togglePlayback();
+
+   // The normals are not in the checkpoint, so they are kept from the current buffers.
+   ClothCheckpoint::Ring buffers;
+   const auto size = static_cast<GLsizeiptr>(sizeof( GLfloat ) * ClothPointStride * getClothPointNum());
+   for (int i = 0; i < ClothCheckpoint::RingSize; ++i) {
+      buffers[i].resize( static_cast<size_t>(ClothPointStride) * getClothPointNum() );
+      glGetNamedBufferSubData( ClothObject->getShaderStorageBuffer( i ), 0, size, buffers[i].data() );
+   }
+
+   ClothCheckpoint::Header header{};
+   if (!ClothCheckpoint::read( checkpoint_path, header, buffers, ClothPointStride )) return false;
+
+   for (int i = 0; i < ClothCheckpoint::RingSize; ++i) {
+      glNamedBufferSubData( ClothObject->getShaderStorageBuffer( i ), 0, size, buffers[i].data() );
+   }
+   ClothTargetIndex = header.TargetIndex;
+   ClothPhysics = header.Parameters;
+   ClothWorldMatrix = header.ClothWorldMatrix;
+   SphereWorldMatrix = header.SphereWorldMatrix;
+   SpherePosition = header.SpherePosition;
+   SphereRadius = header.SphereRadius;
+   std::cout << "Checkpoint Loaded: " << checkpoint_path << "\n";
+   return true;
+}
+
+void RendererGL::prepareClothReadback()
+{
+   if (ClothReadback) return;
+
+   ClothReadback = std::make_unique<BufferReadbackGL>(
+      static_cast<GLsizeiptr>(sizeof( GLfloat ) * ClothPointStride * getClothPointNum()),
+      [this](const uint8_t* data) {
+         const auto* points = reinterpret_cast<const float*>(data);
+         if (Recorder->isRecording()) Recorder->addFrame( points, ClothPointStride );
+         if (PointCache->isOpen()) PointCache->addFrame( points, ClothPointStride );
+      }
+   );
+}
+
+void RendererGL::toggleRecording()
+{
+   if (Recorder->isRecording()) {
+      ClothReadback->flush();
+      Recorder->stop();
+      const uint64_t raw_size =
+         sizeof( GLfloat ) * ClothPointStride * static_cast<uint64_t>(getClothPointNum()) * Recorder->getFrameNum();
+      std::cout << "Recording Stopped: " << Recorder->getFrameNum() << " frames in " << Recorder->getFileSize()
+         << " bytes (" << static_cast<double>(raw_size) / static_cast<double>(std::max<uint64_t>( Recorder->getFileSize(), 1 ))
+         << "x smaller than the points)\n";
+      return;
+   }
+
+   if (Player->isOpen()) {
+      std::cout << "Stop the playback before recording!\n";
+      return;
+   }
+   prepareClothReadback();
+   if (Recorder->start( getRecordingPath(), getClothPointNum() )) std::cout << "Recording Started!\n";
+}
+
+void RendererGL::togglePointCacheExport()
+{
+   if (PointCache->isOpen()) {
+      ClothReadback->flush();
+      PointCache->close();
+      std::cout << "Point Cache Exported: " << PointCache->getFrameNum() << " frames\n";
+      return;
+   }
+
+   if (Player->isOpen()) {
+      std::cout << "Stop the playback before exporting!\n";
+      return;
+   }
+   prepareClothReadback();
+   if (PointCache->open( getPointCachePath(), getClothPointNum() )) std::cout << "Point Cache Export Started!\n";
+}
+
+void RendererGL::togglePlayback()
+{
+   const auto size = static_cast<GLsizeiptr>(sizeof( GLfloat ) * ClothPointStride * getClothPointNum());
+   if (Player->isOpen()) {
+      // The solver resumes from the last played frame at rest, so the whole ring has the same points.
+      for (int i = 0; i < 3; ++i) {
+         glNamedBufferSubData( ClothObject->getShaderStorageBuffer( i ), 0, size, PlaybackPoints.data() );
+      }
+      Player->close();
+      std::cout << "Playback Stopped!\n";
+      return;
+   }
+
+   if (Recorder->isRecording()) toggleRecording();
+   if (PointCache->isOpen()) togglePointCacheExport();
+   if (!Player->open( getRecordingPath() )) return;
+   if (Player->getPointNum() != getClothPointNum() || Player->getFrameNum() == 0) {
+      std::cerr << "The recording does not fit the cloth\n";
+      Player->close();
+      return;
+   }
+
+   // The texture coordinates are not recorded, so they are kept from the current points.
+   PlaybackFrame = 0;
+   PlaybackPoints.resize( static_cast<size_t>(ClothPointStride) * getClothPointNum() );
+   glGetNamedBufferSubData( getNewestClothBuffer(), 0, size, PlaybackPoints.data() );
+   std::cout << "Playback Started: " << Player->getFrameNum() << " frames\n";
+}
+
+void RendererGL::toggleFrameCapture()
+{
+   if (Capture->isCapturing()) {
+      Capture->stop();
+      std::cout << "Frame Capture Stopped: " << Capture->getFrameNum() << " frames\n";
+      if (Capture->getDroppedFrameNum() > 0) {
+         std::cerr << Capture->getDroppedFrameNum() << " frames were dropped, so the capture has gaps.\n";
+      }
+      return;
+   }
+
+   const std::string directory_path = std::string(CMAKE_BINARY_DIR) + "/captures";
+   if (Capture->start( directory_path, CaptureFormat, FrameWidth, FrameHeight, CaptureFPS )) {
+      std::cout << "Frame Capture Started: " << directory_path << "\n";
+   }
+}
+
+void RendererGL::playRecording()
+{
+   const ZoneProfiler::Zone zone( "playRecording" );
+   const glm::vec3* positions = Player->getFrame( PlaybackFrame );
+   if (positions == nullptr) {
+      togglePlayback();
+      return;
+   }
+
+   for (int i = 0; i < getClothPointNum(); ++i) {
+      std::memcpy( &PlaybackPoints[static_cast<size_t>(i) * ClothPointStride], &positions[i], sizeof( glm::vec3 ) );
+   }
+   glNamedBufferSubData(
+      getNewestClothBuffer(),
+      0,
+      static_cast<GLsizeiptr>(sizeof( GLfloat ) * PlaybackPoints.size()),
+      PlaybackPoints.data()
+   );
+   PlaybackFrame = (PlaybackFrame + 1) % Player->getFrameNum();
+}
+
 void RendererGL::applyForces()
 {
+   const ZoneProfiler::Zone zone( "applyForces" );
    const float rest_length = static_cast<float>(ClothGridSize.x) / static_cast<float>(ClothPointNumSize.x);
    glUseProgram( ObjectShader->getComputeShaderProgram( 0 ) );
    glUniform1f( ObjectShader->getLocation( "SpringRestLength" ), rest_length );
-   glUniform1f( ObjectShader->getLocation( "SpringStiffness" ), 10.0f );
-   glUniform1f( ObjectShader->getLocation( "SpringDamping" ), -0.5f );
+   glUniform1f( ObjectShader->getLocation( "SpringStiffness" ), ClothPhysics.SpringStiffness );
+   glUniform1f( ObjectShader->getLocation( "SpringDamping" ), ClothPhysics.SpringDamping );
    glUniform1f( ObjectShader->getLocation( "ShearRestLength" ), 1.5f * rest_length );
-   glUniform1f( ObjectShader->getLocation( "ShearStiffness" ), 10.0f );
-   glUniform1f( ObjectShader->getLocation( "ShearDamping" ), -0.5f );
+   glUniform1f( ObjectShader->getLocation( "ShearStiffness" ), ClothPhysics.ShearStiffness );
+   glUniform1f( ObjectShader->getLocation( "ShearDamping" ), ClothPhysics.ShearDamping );
    glUniform1f( ObjectShader->getLocation( "FlexionRestLength" ), 2.0f * rest_length );
-   glUniform1f( ObjectShader->getLocation( "FlexionStiffness" ), 5.0f );
-   glUniform1f( ObjectShader->getLocation( "FlexionDamping" ), -0.5f );
-   glUniform1f( ObjectShader->getLocation( "GravityConstant" ), -5.0f );
-   glUniform1f( ObjectShader->getLocation( "GravityDamping" ), -0.3f );
-   glUniform1f( ObjectShader->getLocation( "dt" ), 0.1f );
-   glUniform1f( ObjectShader->getLocation( "Mass" ), 1.0f );
+   glUniform1f( ObjectShader->getLocation( "FlexionStiffness" ), ClothPhysics.FlexionStiffness );
+   glUniform1f( ObjectShader->getLocation( "FlexionDamping" ), ClothPhysics.FlexionDamping );
+   glUniform1f( ObjectShader->getLocation( "GravityConstant" ), ClothPhysics.GravityConstant );
+   glUniform1f( ObjectShader->getLocation( "GravityDamping" ), ClothPhysics.GravityDamping );
+   glUniform1f( ObjectShader->getLocation( "dt" ), ClothPhysics.TimeStep );
+   glUniform1f( ObjectShader->getLocation( "Mass" ), ClothPhysics.Mass );
    glUniformMatrix4fv( ObjectShader->getLocation( "ClothWorldMatrix" ), 1, GL_FALSE, &ClothWorldMatrix[0][0] );
    glUniform3fv( ObjectShader->getLocation( "SpherePosition" ), 1, &SpherePosition[0] );
    glUniform1f( ObjectShader->getLocation( "SphereRadius" ), SphereRadius );
    glUniformMatrix4fv( ObjectShader->getLocation( "SphereWorldMatrix" ), 1, GL_FALSE, &SphereWorldMatrix[0][0] );
-   
-   glDispatchCompute( ClothPointNumSize.x / 10, ClothPointNumSize.y / 10, 1 );
-   glMemoryBarrier( GL_SHADER_STORAGE_BARRIER_BIT );
-   
+
    glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 0, ClothObject->getShaderStorageBuffer( ClothTargetIndex ) );
    glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 1, ClothObject->getShaderStorageBuffer( (ClothTargetIndex + 1) % 3 ) );
    glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 2, ClothObject->getShaderStorageBuffer( (ClothTargetIndex + 2) % 3 ) );
+   if (UseStatistics) Statistics->bind();
+   const glm::ivec2 work_group_num = getClothWorkGroupNum();
+   glDispatchCompute( work_group_num.x, work_group_num.y, 1 );
+   glMemoryBarrier( GL_SHADER_STORAGE_BARRIER_BIT );
+   if (UseStatistics) Statistics->request();
    ClothTargetIndex = (ClothTargetIndex + 1) % 3;
 }
 
+void RendererGL::cullObjects() const
+{
+   const ZoneProfiler::Zone zone( "cullObjects" );
+   std::array<glm::vec4, 6> frustum_planes{};
+   MainCamera->getFrustumPlanes( frustum_planes );
+   IndirectDraws->setBoundingSphere( SphereDrawIndex, getSphereBoundingSphere() );
+
+   // The cloth keeps moving on GPU, so its sphere is reduced from the newest points there instead of read back.
+   glUseProgram( ObjectShader->getComputeShaderProgram( 2 ) );
+   glUniformMatrix4fv( ObjectShader->getLocation( "BoundsWorldMatrix" ), 1, GL_FALSE, &ClothWorldMatrix[0][0] );
+   glUniform2ui(
+      ObjectShader->getLocation( "BoundingSphereIndices" ),
+      static_cast<GLuint>(ClothDrawIndex),
+      static_cast<GLuint>(ClothPatchDrawIndex)
+   );
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, ClothPointsBinding, getNewestClothBuffer() );
+   IndirectDraws->bindBoundingSpheres();
+   glDispatchCompute( 1, 1, 1 );
+   glMemoryBarrier( GL_SHADER_STORAGE_BARRIER_BIT );
+
+   glUseProgram( ObjectShader->getComputeShaderProgram( 1 ) );
+   glUniform4fv( ObjectShader->getLocation( "FrustumPlanes" ), 6, &frustum_planes[0][0] );
+   IndirectDraws->cull();
+}
+
 void RendererGL::drawClothObject() const
 {
-   ObjectShader->transferBasicTransformationUniforms( ClothWorldMatrix, MainCamera.get(), true );
-   ClothObject->transferUniformsToShader( ObjectShader.get() );
+   const ZoneProfiler::Zone zone( "drawClothObject" );
+   const ShaderGL* shader = UseTessellation ? ClothSurfaceShader.get() : ClothShader.get();
+   glUseProgram( shader->getShaderProgram() );
+   Lights->transferUniformsToShader( shader );
+   shader->transferBasicTransformationUniforms( ClothWorldMatrix, MainCamera.get(), true );
+   ClothObject->transferUniformsToShader( shader );
 
    glBindTextureUnit( 0, ClothObject->getTextureID( 0 ) );
+   glBindBufferBase( GL_SHADER_STORAGE_BUFFER, ClothPointsBinding, getNewestClothBuffer() );
    glBindVertexArray( ClothObject->getVAO() );
-   for (int j = 0; j < ClothPointNumSize.y - 1; ++j) {
-      glDrawElements( 
-         ClothObject->getDrawMode(), 
-         ClothPointNumSize.x * 2, 
-         GL_UNSIGNED_INT, 
-         reinterpret_cast<GLvoid*>(j * ClothPointNumSize.x * 2 * sizeof(GLuint))
+   if (UseTessellation) {
+      glUniform2f(
+         ClothSurfaceShader->getLocation( "ViewportSize" ),
+         static_cast<float>(FrameWidth),
+         static_cast<float>(FrameHeight)
       );
+      glUniform1f( ClothSurfaceShader->getLocation( "TessellationEdgeLength" ), TessellationEdgeLength );
+      glPatchParameteri( GL_PATCH_VERTICES, 16 );
+      IndirectDraws->draw( ClothPatchDrawIndex, GL_PATCHES );
+   }
+   else {
+      glUniform1i( ClothShader->getLocation( "ClothPointNumX" ), ClothPointNumSize.x );
+      IndirectDraws->draw( ClothDrawIndex, ClothObject->getDrawMode() );
    }
 }
 
 void RendererGL::drawSphereObject() const
 {
+   // The cloth falls through the sphere without the collider, so the sphere is not drawn then.
+   if (SphereObject->getVAO() == 0 || !UseSphereCollider) return;
+
+   const ZoneProfiler::Zone zone( "drawSphereObject" );
+   glUseProgram( ObjectShader->getShaderProgram() );
+   Lights->transferUniformsToShader( ObjectShader.get() );
    const glm::mat4 to_world = SphereWorldMatrix * translate(glm::mat4(1.0f), SpherePosition );
    ObjectShader->transferBasicTransformationUniforms( to_world, MainCamera.get(), true );
    SphereObject->transferUniformsToShader( ObjectShader.get() );
 
    glBindTextureUnit( 0, SphereObject->getTextureID( 0 ) );
    glBindVertexArray( SphereObject->getVAO() );
-   glDrawArrays( SphereObject->getDrawMode(), 0, SphereObject->getVertexNum() );
+   IndirectDraws->draw( SphereDrawIndex, SphereObject->getDrawMode() );
+}
+
+void RendererGL::drawOverlay() const
+{
+   if (!UseStatistics || !ShowOverlay) return;
+
+   const ZoneProfiler::Zone zone( "drawOverlay" );
+   const ClothStatisticsGL::Counters& counters = Statistics->getLatest();
+   const std::array<double, 5> average = Statistics->getRollingAverage();
+   // A step is simulated in each frame, so the work of a step over the frame time is its throughput.
+   const double springs_per_second = FrameTime > 0.0 ? average[1] * 1000.0 / FrameTime : 0.0;
+   std::ostringstream frame, points, springs, collisions, contacts, tiles;
+   frame << std::fixed << std::setprecision( 2 ) << "step " << Statistics->getStepNum() << "  " << FrameTime << " ms";
+   points << "points " << counters.MovedPoints << " / " << Statistics->getPointNum() << " moved";
+   springs << std::fixed << std::setprecision( 1 ) << "springs " << counters.EvaluatedSprings << "  "
+      << springs_per_second * 1e-6 << " M/s";
+   collisions << "collision tests " << counters.CollisionTests;
+   contacts << "contacts " << counters.Contacts;
+   tiles << "tiles " << counters.AwakeTiles << " / " << Statistics->getTileNum() << " awake";
+   Overlay->draw( { frame.str(), points.str(), springs.str(), collisions.str(), contacts.str(), tiles.str() }, FrameWidth, FrameHeight );
 }
 
 void RendererGL::render()
 {
+   const ZoneProfiler::Zone zone( "render" );
    glClear( OPENGL_COLOR_BUFFER_BIT | OPENGL_DEPTH_BUFFER_BIT );
 
-   applyForces();
+   GPUProfiler->beginFrame();
+   AssetLoader->update();
+   if (Player->isOpen()) playRecording();
+   else {
+      GPUProfiler->beginScope( "applyForces" );
+      applyForces();
+      GPUProfiler->endScope();
+      if (Recorder->isRecording() || PointCache->isOpen()) ClothReadback->request( getNewestClothBuffer() );
+   }
+   if (ClothReadback) ClothReadback->update();
+   if (UseStatistics) Statistics->update();
 
    MainCamera->updateWindowSize( FrameWidth, FrameHeight );
    glViewport( 0, 0, FrameWidth, FrameHeight );
+   GPUProfiler->beginScope( "cullObjects" );
+   cullObjects();
+   GPUProfiler->endScope();
 
-   glUseProgram( ObjectShader->getShaderProgram() );
-   Lights->transferUniformsToShader( ObjectShader.get() );
+   GPUProfiler->beginScope( "drawClothObject" );
    drawClothObject();
+   GPUProfiler->endScope();
+   GPUProfiler->beginScope( "drawSphereObject" );
    drawSphereObject();
+   GPUProfiler->endScope();
+   GPUProfiler->beginScope( "drawOverlay" );
+   drawOverlay();
+   GPUProfiler->endScope();
+   GPUProfiler->endFrame();
 
    glBindVertexArray( 0 );
    glUseProgram( 0 );
 }
 
-void RendererGL::play()
+void RendererGL::reportGPUProfile() const
 {
-   if (glfwWindowShouldClose( Window )) initialize();
+   if (!GPUProfiler->isEnabled()) return;
 
-   setLights();
-   setClothObject();
-   setSphereObject();
-   setClothPhysicsVariables();
-   ObjectShader->setUniformLocations( Lights->getTotalLightNum() );
+   GPUProfiler->finish();
+   GPUProfiler->printSummary();
+   if (!GPUProfilePath.empty() && GPUProfiler->writeCSV( GPUProfilePath )) {
+      std::cout << "GPU profile is written into " << GPUProfilePath << "\n";
+   }
+}
+
+void RendererGL::reportGPUMemory() const
+{
+   if (GPUMemoryReport) GPUMemoryGL::printReport();
+}
+
+void RendererGL::reportStatistics() const
+{
+   if (!UseStatistics) return;
+
+   Statistics->flush();
+   const std::array<double, 5> average = Statistics->getRollingAverage();
+   std::cout << "Statistics of the last steps: " << average[0] << " moved points, " << average[1] << " springs, "
+      << average[2] << " collision tests, " << average[3] << " contacts, " << average[4] << " awake tiles\n";
+   if (!StatisticsPath.empty() && Statistics->writeCSV( StatisticsPath )) {
+      std::cout << "Statistics are written into " << StatisticsPath << "\n";
+   }
+}
+
+bool RendererGL::shouldClose(int frame_index) const
+{
+   if (FrameLimit > 0 && frame_index >= FrameLimit) return true;
+   return !Headless && glfwWindowShouldClose( Window );
+}
 
-   while (!glfwWindowShouldClose( Window )) {
+bool RendererGL::play()
+{
+   if (Headless) {
+      if (!HeadlessContext->isCreated()) return false;
+   }
+   else if (glfwWindowShouldClose( Window ) && !initialize()) return false;
+
+   const auto start_time = std::chrono::steady_clock::now();
+   const auto get_elapsed_milliseconds = [start_time]() {
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+   };
+   if (!setScene()) {
+      if (!Headless) glfwDestroyWindow( Window );
+      return false;
+   }
+   if (CaptureOnStart && !Capture->isCapturing()) toggleFrameCapture();
+   if (!Headless) glfwSwapInterval( Pacer->getSwapInterval() );
+
+   // The startup is reported with the headless summary, and the trace shows it in detail.
+   int frame_index = 0;
+   double first_frame_time = 0.0, assets_loaded_time = -1.0;
+   auto frame_start_time = std::chrono::steady_clock::now();
+   while (!shouldClose( frame_index )) {
+      // The events are polled after the wait of the pacing, so the frame shows the newest inputs.
+      {
+         const ZoneProfiler::Zone zone( "waitForFrame" );
+         Pacer->beginFrame();
+      }
+      if (!Headless) {
+         glfwPollEvents();
+         Pacer->markPoll();
+      }
       render();
+      Capture->capture();
+
+      // Nothing swaps the buffers of the headless one, so it only flushes the commands of the frame instead.
+      if (Headless) glFlush();
+      else {
+         const ZoneProfiler::Zone zone( "swapBuffers" );
+         glfwSwapBuffers( Window );
+      }
+      Pacer->endFrame();
+
+      const auto frame_end_time = std::chrono::steady_clock::now();
+      const double frame_time =
+         std::chrono::duration<double, std::milli>(frame_end_time - frame_start_time).count();
+      FrameTime = frame_index == 0 ? frame_time : FrameTime + 0.05 * (frame_time - FrameTime);
+      frame_start_time = frame_end_time;
+
+      if (frame_index++ == 0) first_frame_time = get_elapsed_milliseconds();
+      if (assets_loaded_time < 0.0 && AssetLoader->isIdle()) assets_loaded_time = get_elapsed_milliseconds();
+   }
+   if (Recorder->isRecording()) toggleRecording();
+   if (PointCache->isOpen()) togglePointCacheExport();
+   if (Capture->isCapturing()) toggleFrameCapture();
+   Pacer->finish();
+   if (Headless) {
+      glFinish();
+      const double elapsed_time = get_elapsed_milliseconds() / 1000.0;
+      std::cout << "Rendered " << frame_index << " frames of " << FrameWidth << "x" << FrameHeight << " in "
+         << elapsed_time << " s (" << static_cast<double>(frame_index) / std::max( elapsed_time, 1e-6 )
+         << " frames/s)\n";
+      std::cout << "First frame in " << first_frame_time << " ms, ";
+      if (assets_loaded_time < 0.0) std::cout << "assets still loading at the end\n";
+      else std::cout << "assets loaded in " << assets_loaded_time << " ms\n";
+   }
+   Pacer->printSummary();
+   reportGPUProfile();
+   reportGPUMemory();
+   reportStatistics();
+   if (!Headless) glfwDestroyWindow( Window );
+   return true;
+}
 
-      glfwSwapBuffers( Window );
-      glfwPollEvents();
+bool RendererGL::bake(int frame_num, const std::string& point_cache_path)
+{
+   if (Headless) {
+      if (!HeadlessContext->isCreated()) return false;
+   }
+   else {
+      if (glfwWindowShouldClose( Window ) && !initialize()) return false;
+      glfwHideWindow( Window );
+   }
+
+   if (!setScene() || !PointCache->open( point_cache_path, getClothPointNum() )) {
+      if (!Headless) glfwDestroyWindow( Window );
+      return false;
+   }
+   // Nothing is drawn, so the readback ring is the only thing that throttles the solver.
+   const auto start_time = std::chrono::steady_clock::now();
+   prepareClothReadback();
+   for (int i = 0; i < frame_num; ++i) {
+      GPUProfiler->beginFrame();
+      GPUProfiler->beginScope( "applyForces" );
+      applyForces();
+      GPUProfiler->endScope();
+      GPUProfiler->endFrame();
+      ClothReadback->request( getNewestClothBuffer() );
+      ClothReadback->update();
+      if (UseStatistics) Statistics->update();
+   }
+   ClothReadback->flush();
+   PointCache->close();
+
+   const double elapsed_time =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+   std::cout << "Baked " << PointCache->getFrameNum() << " frames into " << point_cache_path << " in "
+      << elapsed_time << " s (" << static_cast<double>(frame_num) / std::max( elapsed_time, 1e-6 ) << " steps/s)\n";
+   if (ClothReadback->getDroppedNum() > 0) {
+      std::cerr << ClothReadback->getDroppedNum() << " frames were dropped, so the point cache has gaps.\n";
    }
-   glfwDestroyWindow( Window );
+   reportGPUProfile();
+   reportGPUMemory();
+   reportStatistics();
+   if (!Headless) glfwDestroyWindow( Window );
+   return true;
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "SceneFile.h"
+
+std::vector<SceneFile::Setting> SceneFile::getSettings(SceneDescription& scene)
+{
+   ClothSetup& cloth = scene.Cloth;
+   ClothParameters& physics = scene.Physics;
+   return {
+      { "cloth_points", 2, nullptr, &cloth.PointNum.x, nullptr },
+      { "cloth_size", 2, &cloth.GridSize.x, nullptr, nullptr },
+      { "cloth_position", 3, &cloth.ClothWorldMatrix[3][0], nullptr, nullptr },
+      { "sphere_position", 3, &cloth.SphereWorldMatrix[3][0], nullptr, nullptr },
+      { "sphere_radius", 1, &cloth.SphereRadius, nullptr, nullptr },
+      { "sphere_collider", 1, nullptr, nullptr, &cloth.UseSphereCollider },
+      { "spring_stiffness", 1, &physics.SpringStiffness, nullptr, nullptr },
+      { "spring_damping", 1, &physics.SpringDamping, nullptr, nullptr },
+      { "shear_stiffness", 1, &physics.ShearStiffness, nullptr, nullptr },
+      { "shear_damping", 1, &physics.ShearDamping, nullptr, nullptr },
+      { "flexion_stiffness", 1, &physics.FlexionStiffness, nullptr, nullptr },
+      { "flexion_damping", 1, &physics.FlexionDamping, nullptr, nullptr },
+      { "gravity", 1, &physics.GravityConstant, nullptr, nullptr },
+      { "gravity_damping", 1, &physics.GravityDamping, nullptr, nullptr },
+      { "time_step", 1, &physics.TimeStep, nullptr, nullptr },
+      { "mass", 1, &physics.Mass, nullptr, nullptr },
+      { "light_position", 3, &scene.LightPosition.x, nullptr, nullptr },
+      { "light_ambient", 3, &scene.LightAmbientColor.x, nullptr, nullptr },
+      { "light_diffuse", 3, &scene.LightDiffuseColor.x, nullptr, nullptr },
+      { "light_specular", 3, &scene.LightSpecularColor.x, nullptr, nullptr },
+      { "tessellation", 1, nullptr, nullptr, &scene.UseTessellation },
+      { "tessellation_edge_length", 1, &scene.TessellationEdgeLength, nullptr, nullptr }
+   };
+}
+
+bool SceneFile::set(SceneDescription& scene, const std::string& line)
+{
+   std::istringstream stream(line);
+   std::string keyword;
+   if (!(stream >> keyword)) return false;
+
+   const std::vector<Setting> settings = getSettings( scene );
+   const auto setting = std::find_if(
+      settings.begin(), settings.end(),
+      [&keyword](const Setting& candidate) { return keyword == candidate.Keyword; }
+   );
+   if (setting == settings.end()) return false;
+
+   // The values are parsed before any is set, so a broken line leaves the scene as it was.
+   std::array<float, 3> floats{};
+   std::array<int, 3> integers{};
+   for (int i = 0; i < setting->ValueNum; ++i) {
+      if (setting->Floats != nullptr ? !(stream >> floats[i]) : !(stream >> integers[i])) return false;
+   }
+   std::string rest;
+   if (stream >> rest) return false;
+
+   for (int i = 0; i < setting->ValueNum; ++i) {
+      if (setting->Floats != nullptr) setting->Floats[i] = floats[i];
+      else if (setting->Integers != nullptr) setting->Integers[i] = integers[i];
+      else *setting->Flag = integers[i] != 0;
+   }
+   return true;
+}
+
+std::string SceneFile::getError(const SceneDescription& scene)
+{
+   // The flexion springs span two intervals, so a side needs three points at least.
+   if (scene.Cloth.PointNum.x < 3 || scene.Cloth.PointNum.y < 3) return "the cloth needs 3x3 points at least";
+   if (scene.Cloth.GridSize.x <= 0.0f || scene.Cloth.GridSize.y <= 0.0f) return "the cloth size is not positive";
+   if (scene.Cloth.SphereRadius < 0.0f) return "the sphere radius is negative";
+   if (scene.Physics.TimeStep <= 0.0f) return "the time step is not positive";
+   if (scene.Physics.Mass <= 0.0f) return "the mass is not positive";
+   if (scene.TessellationEdgeLength <= 0.0f) return "the tessellation edge length is not positive";
+   return "";
+}
+
+bool SceneFile::read(const std::string& file_path, SceneDescription& scene)
+{
+   std::ifstream file(file_path);
+   if (!file.is_open()) {
+      std::cerr << "Cannot read the scene: " << file_path << "\n";
+      return false;
+   }
+
+   std::string line;
+   for (int line_number = 1; std::getline( file, line ); ++line_number) {
+      line = line.substr( 0, line.find( '#' ) );
+      if (line.find_first_not_of( " \t\r" ) == std::string::npos) continue;
+      if (!set( scene, line )) {
+         std::cerr << file_path << ":" << line_number << ": the setting is unknown or broken: " << line << "\n";
+         return false;
+      }
+   }
+
+   const std::string error = getError( scene );
+   if (!error.empty()) {
+      std::cerr << file_path << ": " << error << "\n";
+      return false;
+   }
+   return true;
+}
+
+bool SceneFile::write(const std::string& file_path, const SceneDescription& scene)
+{
+   std::ofstream file(file_path, std::ios::trunc);
+   if (!file.is_open()) {
+      std::cerr << "Cannot write the scene: " << file_path << "\n";
+      return false;
+   }
+
+   // The floats are written in their shortest form that reads back to the same value.
+   SceneDescription copy = scene;
+   std::array<char, 32> buffer{};
+   for (const auto& setting : getSettings( copy )) {
+      file << setting.Keyword;
+      for (int i = 0; i < setting.ValueNum; ++i) {
+         file << " ";
+         if (setting.Floats != nullptr) {
+            const auto result = std::to_chars( buffer.data(), buffer.data() + buffer.size(), setting.Floats[i] );
+            file.write( buffer.data(), result.ptr - buffer.data() );
+         }
+         else if (setting.Integers != nullptr) file << setting.Integers[i];
+         else file << (*setting.Flag ? 1 : 0);
+      }
+      file << "\n";
+   }
+   return static_cast<bool>(file);
+}
\ No newline at end of file
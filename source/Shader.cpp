@@ -6,15 +6,15 @@ ShaderGL::ShaderGL() : ShaderProgram( 0 )
 
 ShaderGL::~ShaderGL()
 {
-   if (ShaderProgram != 0) glDeleteProgram( ShaderProgram );
+   for (const auto& program : Programs) glDeleteProgram( program.second );
 }
 
-void ShaderGL::readShaderFile(std::string& shader_contents, const char* shader_path)
+bool ShaderGL::readShaderFile(std::string& shader_contents, const char* shader_path)
 {
    std::ifstream file( shader_path, std::ios::in );
    if (!file.is_open()) {
       std::cerr << "Cannot open shader file: " << shader_path << "\n";
-      return;
+      return false;
    }
 
    std::string line;
@@ -23,14 +23,70 @@ void ShaderGL::readShaderFile(std::string& shader_contents, const char* shader_p
       shader_contents.append( line + "\n" );
    }
    file.close();
+   return true;
 }
 
+bool ShaderGL::preprocess(
+   std::string& shader_contents,
+   const std::filesystem::path& shader_path,
+   const DefineSet& defines,
+   std::vector<std::string>& included_paths
+)
+{
+   std::string contents;
+   if (!readShaderFile( contents, shader_path.string().c_str() )) return false;
+
+   // The index of the file in included_paths is the source string number of #line, which the compile log refers to.
+   const std::string source_number = std::to_string( included_paths.size() );
+   included_paths.emplace_back( shader_path.lexically_normal().generic_string() );
+
+   int line_number = 0;
+   std::string line;
+   std::istringstream stream(contents);
+   while (std::getline( stream, line )) {
+      line_number++;
+      const size_t first = line.find_first_not_of( " \t" );
+      if (first != std::string::npos && line.compare( first, 8, "#version" ) == 0) {
+         shader_contents.append( line + "\n" );
+         for (const auto& define : defines) {
+            shader_contents.append( "#define " + define.first + " " + define.second + "\n" );
+         }
+         shader_contents.append( "#line " + std::to_string( line_number + 1 ) + " " + source_number + "\n" );
+      }
+      else if (first != std::string::npos && line.compare( first, 8, "#include" ) == 0) {
+         const size_t open = line.find( '"', first );
+         const size_t close = line.rfind( '"' );
+         if (open == std::string::npos || close <= open) {
+            std::cerr << "Invalid #include at " << shader_path.string() << ":" << line_number << "\n";
+            return false;
+         }
+
+         // Every file is included once as if it had #pragma once, which also stops the recursive inclusion.
+         const std::filesystem::path include_path = shader_path.parent_path() / line.substr( open + 1, close - open - 1 );
+         const std::string normalized_path = include_path.lexically_normal().generic_string();
+         if (std::find( included_paths.begin(), included_paths.end(), normalized_path ) != included_paths.end()) {
+            continue;
+         }
+
+         shader_contents.append( "#line 1 " + std::to_string( included_paths.size() ) + "\n" );
+         if (!preprocess( shader_contents, include_path, {}, included_paths )) return false;
+         shader_contents.append( "#line " + std::to_string( line_number + 1 ) + " " + source_number + "\n" );
+      }
+      else shader_contents.append( line + "\n" );
+   }
+   return true;
+}
+
+
 std::string ShaderGL::getShaderTypeString(GLenum shader_type)
 {
    switch (shader_type) {
       case GL_VERTEX_SHADER: return "Vertex Shader";
       case GL_FRAGMENT_SHADER: return "Fragment Shader";
       case GL_GEOMETRY_SHADER: return "Geometry Shader";
+      case GL_TESS_CONTROL_SHADER: return "Tessellation Control Shader";
+      case GL_TESS_EVALUATION_SHADER: return "Tessellation Evaluation Shader";
+      case GL_COMPUTE_SHADER: return "Compute Shader";
       default: return "";
    }
 }
@@ -54,13 +110,26 @@ bool ShaderGL::checkCompileError(GLenum shader_type, const GLuint& shader)
    return compiled == GL_TRUE;
 }
 
-GLuint ShaderGL::getCompiledShader(GLenum shader_type, const char* shader_path)
+bool ShaderGL::checkLinkError(const GLuint& program)
 {
-   if (shader_path == nullptr) return 0;
+   GLint linked = 0;
+   glGetProgramiv( program, GL_LINK_STATUS, &linked );
 
-   std::string shader_contents;
-   readShaderFile( shader_contents, shader_path );
+   if (linked == GL_FALSE) {
+      GLint max_length = 0;
+      glGetProgramiv( program, GL_INFO_LOG_LENGTH, &max_length );
+
+      std::cerr << " ======= Program log ======= \n";
+      std::vector<GLchar> error_log(std::max( max_length, 1 ));
+      glGetProgramInfoLog( program, max_length, &max_length, &error_log[0] );
+      for (const auto& c : error_log) std::cerr << c;
+      std::cerr << "\n";
+   }
+   return linked == GL_TRUE;
+}
 
+GLuint ShaderGL::getCompiledShader(GLenum shader_type, const std::string& shader_contents)
+{
    const GLuint shader = glCreateShader( shader_type );
    const char* shader_source = shader_contents.c_str();
    glShaderSource( shader, 1, &shader_source, nullptr );
@@ -72,43 +141,162 @@ GLuint ShaderGL::getCompiledShader(GLenum shader_type, const char* shader_path)
    return shader;
 }
 
+uint64_t ShaderGL::getProgramKey(const std::vector<ShaderSource>& sources)
+{
+   // The binary is valid only for the same driver, so the renderer and version strings are a part of the key.
+   uint64_t hash = getFNV1aHash( nullptr, 0 );
+   for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+      const auto* string = reinterpret_cast<const char*>(glGetString( name ));
+      if (string != nullptr) hash = getFNV1aHash( string, std::strlen( string ) + 1, hash );
+   }
+   for (const auto& source : sources) {
+      hash = getFNV1aHash( &source.first, sizeof( source.first ), hash );
+      hash = getFNV1aHash( source.second.data(), source.second.size() + 1, hash );
+   }
+   return hash;
+}
+
+std::string ShaderGL::getProgramCachePath(uint64_t key)
+{
+   std::ostringstream file_name;
+   file_name << std::hex << std::setw( 16 ) << std::setfill( '0' ) << key << ".program";
+   return std::string(CMAKE_BINARY_DIR) + "/cache/programs/" + file_name.str();
+}
+
+bool ShaderGL::loadProgramBinary(GLuint program, const std::string& cache_path)
+{
+   std::ifstream file(cache_path, std::ios::binary | std::ios::ate);
+   if (!file.is_open()) return false;
+
+   const auto file_size = static_cast<uint64_t>(std::max( static_cast<std::streamoff>(file.tellg()), std::streamoff(0) ));
+   file.seekg( 0 );
+   ProgramCacheHeader header{};
+   file.read( reinterpret_cast<char*>(&header), sizeof( ProgramCacheHeader ) );
+   if (!file || header.Magic != ProgramCacheMagic || header.Version != ProgramCacheVersion) return false;
+   // The length is checked before it is allocated, as a broken cache can have any length.
+   if (header.Length == 0 || header.Length != file_size - sizeof( ProgramCacheHeader )) {
+      std::cerr << "The program cache is broken: " << cache_path << "\n";
+      return false;
+   }
+
+   std::vector<char> binary(header.Length);
+   file.read( binary.data(), static_cast<std::streamsize>(binary.size()) );
+   if (!file) return false;
+
+   // It fails to link if the driver has been updated in a way that the strings in the key do not tell.
+   glProgramBinary( program, header.Format, binary.data(), static_cast<GLsizei>(binary.size()) );
+   GLint linked = GL_FALSE;
+   glGetProgramiv( program, GL_LINK_STATUS, &linked );
+   return linked == GL_TRUE;
+}
+
+void ShaderGL::saveProgramBinary(GLuint program, const std::string& cache_path)
+{
+   GLint length = 0;
+   glGetProgramiv( program, GL_PROGRAM_BINARY_LENGTH, &length );
+   if (length <= 0) return;
+
+   ProgramCacheHeader header{};
+   std::vector<char> binary(length);
+   glGetProgramBinary( program, length, &length, &header.Format, binary.data() );
+   header.Magic = ProgramCacheMagic;
+   header.Version = ProgramCacheVersion;
+   header.Length = static_cast<uint32_t>(length);
+
+   // The program is linked already, so a cache that is not written only costs the next run a compilation.
+   if (!AtomicFile::write(
+         cache_path, "program cache", [&header, &binary, length](std::ofstream& file) {
+            file.write( reinterpret_cast<const char*>(&header), sizeof( ProgramCacheHeader ) );
+            file.write( binary.data(), length );
+         }
+      )) {
+      std::cerr << "The program is compiled again in the next run.\n";
+   }
+}
+
+GLuint ShaderGL::getProgram(const std::vector<ShaderSource>& sources)
+{
+   const ZoneProfiler::Zone zone( "getProgram" );
+   // The defines are in the preprocessed sources, so each variant has its own key.
+   const uint64_t key = getProgramKey( sources );
+   const auto variant = Programs.find( key );
+   if (variant != Programs.end()) return variant->second;
+
+   const std::string cache_path = getProgramCachePath( key );
+   GLuint program = glCreateProgram();
+   if (loadProgramBinary( program, cache_path )) {
+      Programs[key] = program;
+      return program;
+   }
+
+   glDeleteProgram( program );
+   std::vector<GLuint> shaders;
+   for (const auto& source : sources) {
+      const GLuint shader = getCompiledShader( source.first, source.second );
+      if (shader == 0) {
+         // A program without this stage could still link, and then it would be cached as if nothing were wrong.
+         for (const auto& compiled : shaders) glDeleteShader( compiled );
+         return 0;
+      }
+      shaders.emplace_back( shader );
+   }
+
+   program = glCreateProgram();
+   for (const auto& shader : shaders) glAttachShader( program, shader );
+   glProgramParameteri( program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+   glLinkProgram( program );
+   for (const auto& shader : shaders) glDeleteShader( shader );
+   if (!checkLinkError( program )) {
+      std::cerr << "Could not link program\n";
+      glDeleteProgram( program );
+      return 0;
+   }
+
+   Programs[key] = program;
+   saveProgramBinary( program, cache_path );
+   return program;
+}
+
 void ShaderGL::setShader(
    const char* vertex_shader_path,
    const char* fragment_shader_path,
    const char* geometry_shader_path,
    const char* tessellation_control_shader_path,
-   const char* tessellation_evaluation_shader_path
+   const char* tessellation_evaluation_shader_path,
+   const DefineSet& defines
 )
 {
-   const GLuint vertex_shader = getCompiledShader( GL_VERTEX_SHADER, vertex_shader_path );
-   const GLuint fragment_shader = getCompiledShader( GL_FRAGMENT_SHADER, fragment_shader_path );
-   const GLuint geometry_shader = getCompiledShader( GL_GEOMETRY_SHADER, geometry_shader_path );
-   const GLuint tessellation_control_shader = getCompiledShader( GL_TESS_CONTROL_SHADER, tessellation_control_shader_path );
-   const GLuint tessellation_evaluation_shader = getCompiledShader( GL_TESS_EVALUATION_SHADER, tessellation_evaluation_shader_path );
-   ShaderProgram = glCreateProgram();
-   glAttachShader( ShaderProgram, vertex_shader );
-   glAttachShader( ShaderProgram, fragment_shader );
-   if (geometry_shader != 0) glAttachShader( ShaderProgram, geometry_shader );
-   if (tessellation_control_shader != 0) glAttachShader( ShaderProgram, tessellation_control_shader );
-   if (tessellation_evaluation_shader != 0) glAttachShader( ShaderProgram, tessellation_evaluation_shader );
-   glLinkProgram( ShaderProgram );
-   glDeleteShader( vertex_shader );
-   glDeleteShader( fragment_shader );
-   if (geometry_shader != 0) glDeleteShader( geometry_shader );
-   if (tessellation_control_shader != 0) glDeleteShader( tessellation_control_shader );
-   if (tessellation_evaluation_shader != 0) glDeleteShader( tessellation_evaluation_shader );
-}
-
-void ShaderGL::setComputeShaders(const std::vector<const char*>& compute_shader_paths)
+   std::vector<ShaderSource> sources;
+   const std::array<std::pair<GLenum, const char*>, 5> shader_paths = {
+      std::make_pair( GL_VERTEX_SHADER, vertex_shader_path ),
+      std::make_pair( GL_FRAGMENT_SHADER, fragment_shader_path ),
+      std::make_pair( GL_GEOMETRY_SHADER, geometry_shader_path ),
+      std::make_pair( GL_TESS_CONTROL_SHADER, tessellation_control_shader_path ),
+      std::make_pair( GL_TESS_EVALUATION_SHADER, tessellation_evaluation_shader_path )
+   };
+   for (const auto& shader_path : shader_paths) {
+      if (shader_path.second == nullptr) continue;
+
+      std::vector<std::string> included_paths;
+      sources.emplace_back( shader_path.first, std::string() );
+      if (!preprocess( sources.back().second, shader_path.second, defines, included_paths )) return;
+   }
+   ShaderProgram = getProgram( sources );
+}
+
+void ShaderGL::setComputeShaders(
+   const std::vector<const char*>& compute_shader_paths,
+   const std::vector<DefineSet>& defines
+)
 {
    ComputeShaderPrograms.clear();
-   ComputeShaderPrograms.resize( compute_shader_paths.size() );
+   ComputeShaderPrograms.resize( compute_shader_paths.size(), 0 );
    for (size_t i = 0; i < ComputeShaderPrograms.size(); ++i) {
-      const GLuint compute_shader = getCompiledShader( GL_COMPUTE_SHADER, compute_shader_paths[i] );
-      ComputeShaderPrograms[i] = glCreateProgram();
-      glAttachShader( ComputeShaderPrograms[i], compute_shader );
-      glLinkProgram( ComputeShaderPrograms[i] );
-      glDeleteShader( compute_shader );
+      std::vector<std::string> included_paths;
+      std::vector<ShaderSource> sources(1, std::make_pair( GL_COMPUTE_SHADER, std::string() ));
+      const DefineSet& program_defines = i < defines.size() ? defines[i] : DefineSet{};
+      if (!preprocess( sources[0].second, compute_shader_paths[i], program_defines, included_paths )) continue;
+      ComputeShaderPrograms[i] = getProgram( sources );
    }
 }
 
@@ -130,6 +318,10 @@ void ShaderGL::setUniformLocations(int light_num)
    Location.MaterialSpecular = glGetUniformLocation( ShaderProgram, "Material.SpecularColor" );
    Location.MaterialSpecularExponent = glGetUniformLocation( ShaderProgram, "Material.SpecularExponent" );
 
+   Location.PositionScale = glGetUniformLocation( ShaderProgram, "PositionScale" );
+   Location.PositionOffset = glGetUniformLocation( ShaderProgram, "PositionOffset" );
+   Location.OctahedralNormal = glGetUniformLocation( ShaderProgram, "OctahedralNormal" );
+
    Location.Texture[0] = glGetUniformLocation( ShaderProgram, "BaseTexture" );
    Location.UseTexture = glGetUniformLocation( ShaderProgram, "UseTexture" );
 
@@ -0,0 +1,74 @@
+#include "SimulationPlayer.h"
+
+SimulationPlayer::SimulationPlayer() : DecodedChunkIndex( -1 )
+{
+}
+
+bool SimulationPlayer::open(const std::string& file_path)
+{
+   DecodedChunkIndex = -1;
+   if (!File.open( file_path )) {
+      std::cerr << "Cannot open the recording: " << file_path << "\n";
+      return false;
+   }
+
+   const size_t file_size = File.getSize();
+   bool valid = file_size >= sizeof( SimulationRecorder::Header );
+   if (valid) {
+      const SimulationRecorder::Header& header = getHeader();
+      valid = header.Magic == SimulationRecorder::Magic &&
+         header.Version == SimulationRecorder::Version &&
+         header.PointNum > 0 && header.FramesPerChunk > 0 &&
+         header.IndexOffset >= sizeof( SimulationRecorder::Header ) &&
+         header.IndexOffset % alignof( SimulationRecorder::ChunkEntry ) == 0 &&
+         header.IndexOffset + sizeof( SimulationRecorder::ChunkEntry ) * header.ChunkNum <= file_size &&
+         static_cast<uint64_t>(header.ChunkNum) * header.FramesPerChunk >= header.FrameNum;
+      for (uint32_t i = 0; valid && i < header.ChunkNum; ++i) {
+         const SimulationRecorder::ChunkEntry& entry = getChunkEntry( static_cast<int>(i) );
+         valid = entry.Offset >= sizeof( SimulationRecorder::Header ) &&
+            entry.Offset + entry.Size <= header.IndexOffset &&
+            entry.FrameNum > 0 && entry.FrameNum <= header.FramesPerChunk;
+      }
+   }
+   if (!valid) {
+      std::cerr << "The recording is broken or not finished: " << file_path << "\n";
+      File.close();
+      return false;
+   }
+   return true;
+}
+
+void SimulationPlayer::close()
+{
+   DecodedChunkIndex = -1;
+   DecodedPositions.clear();
+   File.close();
+}
+
+const glm::vec3* SimulationPlayer::getFrame(int frame_index)
+{
+   if (!isOpen() || frame_index < 0 || frame_index >= getFrameNum()) return nullptr;
+
+   const SimulationRecorder::Header& header = getHeader();
+   const int chunk_index = frame_index / static_cast<int>(header.FramesPerChunk);
+   if (chunk_index != DecodedChunkIndex) {
+      const SimulationRecorder::ChunkEntry& entry = getChunkEntry( chunk_index );
+      const bool decoded = PointCodec::decodeChunk(
+         DecodedPositions,
+         reinterpret_cast<const uint8_t*>(File.getData() + entry.Offset),
+         entry.Size,
+         static_cast<int>(header.PointNum),
+         static_cast<int>(entry.FrameNum)
+      );
+      if (!decoded) {
+         std::cerr << "Could not decode the chunk " << chunk_index << " of the recording\n";
+         DecodedChunkIndex = -1;
+         return nullptr;
+      }
+      DecodedChunkIndex = chunk_index;
+   }
+
+   const auto frame_in_chunk = static_cast<size_t>(frame_index % static_cast<int>(header.FramesPerChunk));
+   if (frame_in_chunk >= DecodedPositions.size() / header.PointNum) return nullptr;
+   return DecodedPositions.data() + frame_in_chunk * header.PointNum;
+}
\ No newline at end of file
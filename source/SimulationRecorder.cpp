@@ -0,0 +1,118 @@
+#include "SimulationRecorder.h"
+
+SimulationRecorder::SimulationRecorder() :
+   PointNum( 0 ), FrameNum( 0 ), FileSize( 0 ), Stop( false ), Recording( false )
+{
+}
+
+SimulationRecorder::~SimulationRecorder()
+{
+   stop();
+}
+
+bool SimulationRecorder::start(const std::string& file_path, int point_num)
+{
+   stop();
+
+   std::error_code error;
+   std::filesystem::create_directories( std::filesystem::path(file_path).parent_path(), error );
+   File.open( file_path, std::ios::binary | std::ios::trunc );
+   if (!File.is_open()) {
+      std::cerr << "Cannot write the recording: " << file_path << "\n";
+      return false;
+   }
+
+   PointNum = point_num;
+   FrameNum = 0;
+   Stop = false;
+   Chunk.clear();
+   Index.clear();
+
+   // The header is rewritten with the frame number and the index offset when the recording is stopped.
+   Header header{};
+   File.write( reinterpret_cast<const char*>(&header), sizeof( Header ) );
+   FileSize = 0;
+   Writer = std::thread( &SimulationRecorder::write, this );
+   Recording = true;
+   return true;
+}
+
+void SimulationRecorder::addFrame(const float* points, int stride)
+{
+   if (!isRecording()) return;
+
+   for (int i = 0; i < PointNum; ++i) {
+      const float* point = points + static_cast<size_t>(i) * stride;
+      Chunk.emplace_back( point[0], point[1], point[2] );
+   }
+   FrameNum++;
+
+   if (Chunk.size() == static_cast<size_t>(PointNum) * FramesPerChunk) {
+      {
+         std::lock_guard<std::mutex> lock( Mutex );
+         PendingChunks.emplace_back( std::move( Chunk ) );
+      }
+      Condition.notify_one();
+      Chunk.clear();
+   }
+}
+
+void SimulationRecorder::write()
+{
+   ZoneProfiler::setThreadName( "SimulationRecorder" );
+   std::vector<uint8_t> encoded;
+   while (true) {
+      std::vector<glm::vec3> chunk;
+      {
+         std::unique_lock<std::mutex> lock( Mutex );
+         Condition.wait( lock, [this]() { return Stop || !PendingChunks.empty(); } );
+         if (PendingChunks.empty()) return;
+         chunk = std::move( PendingChunks.front() );
+         PendingChunks.pop_front();
+      }
+
+      const ZoneProfiler::Zone zone( "encodeChunk" );
+      PointCodec::encodeChunk( encoded, chunk, PointNum );
+      ChunkEntry entry{};
+      entry.Offset = static_cast<uint64_t>(File.tellp());
+      entry.Size = static_cast<uint32_t>(encoded.size());
+      entry.FrameNum = static_cast<uint32_t>(chunk.size() / PointNum);
+      File.write( reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()) );
+      Index.emplace_back( entry );
+   }
+}
+
+void SimulationRecorder::stop()
+{
+   if (!isRecording()) return;
+
+   Recording = false;
+   {
+      std::lock_guard<std::mutex> lock( Mutex );
+      if (!Chunk.empty()) PendingChunks.emplace_back( std::move( Chunk ) );
+      Stop = true;
+   }
+   Condition.notify_one();
+   Writer.join();
+   Chunk.clear();
+
+   Header header{};
+   header.Magic = Magic;
+   header.Version = Version;
+   header.PointNum = static_cast<uint32_t>(PointNum);
+   header.FramesPerChunk = FramesPerChunk;
+   header.FrameNum = static_cast<uint32_t>(FrameNum);
+   header.ChunkNum = static_cast<uint32_t>(Index.size());
+
+   // The index is aligned, so the player reads it in place from the mapped file.
+   const std::array<char, alignof( ChunkEntry )> padding{};
+   const auto chunk_end = static_cast<uint64_t>(File.tellp());
+   header.IndexOffset = (chunk_end + alignof( ChunkEntry ) - 1) / alignof( ChunkEntry ) * alignof( ChunkEntry );
+   File.write( padding.data(), static_cast<std::streamsize>(header.IndexOffset - chunk_end) );
+   File.write( reinterpret_cast<const char*>(Index.data()), static_cast<std::streamsize>(sizeof( ChunkEntry ) * Index.size()) );
+   FileSize = static_cast<uint64_t>(File.tellp());
+   File.seekp( 0 );
+   File.write( reinterpret_cast<const char*>(&header), sizeof( Header ) );
+   File.close();
+   if (!File) std::cerr << "Could not finish the recording\n";
+}
\ No newline at end of file
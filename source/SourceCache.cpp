@@ -0,0 +1,49 @@
+#include "SourceCache.h"
+
+SourceCache::SourceCache(const std::string& source_file_path, const std::string& directory, const std::string& suffix)
+{
+   std::error_code error;
+   std::filesystem::path source_path = std::filesystem::absolute( source_file_path, error );
+   if (error) source_path = source_file_path;
+   SourcePath = source_path.lexically_normal().generic_string();
+
+   std::ostringstream file_name;
+   file_name << std::hex << std::setw( 16 ) << std::setfill( '0' )
+      << getFNV1aHash( SourcePath.data(), SourcePath.size() ) << suffix;
+   CachePath = std::string(CMAKE_BINARY_DIR) + "/cache/" + directory + "/" + file_name.str();
+}
+
+uint64_t SourceCache::align(uint64_t offset, uint64_t alignment)
+{
+   return (offset + alignment - 1) / alignment * alignment;
+}
+
+bool SourceCache::getSourceStatus(int64_t& modified_time, uint64_t& size) const
+{
+   std::error_code error;
+   const auto time = std::filesystem::last_write_time( SourcePath, error );
+   if (error) return false;
+   size = std::filesystem::file_size( SourcePath, error );
+   if (error) return false;
+   modified_time = static_cast<int64_t>(time.time_since_epoch().count());
+   return true;
+}
+
+bool SourceCache::open(size_t header_size, int64_t& modified_time, uint64_t& source_size)
+{
+   if (!getSourceStatus( modified_time, source_size )) return false;
+   if (!File.open( CachePath )) return false;
+
+   if (File.getSize() < header_size) {
+      File.close();
+      return false;
+   }
+   return true;
+}
+
+bool SourceCache::hasSourcePath(size_t header_size, uint32_t source_path_length) const
+{
+   return source_path_length == SourcePath.size() &&
+      header_size + source_path_length <= File.getSize() &&
+      std::memcmp( File.getData() + header_size, SourcePath.data(), SourcePath.size() ) == 0;
+}
\ No newline at end of file
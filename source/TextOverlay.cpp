@@ -0,0 +1,124 @@
+#include "TextOverlay.h"
+
+TextOverlayGL::TextOverlayGL() :
+   FontTexture( 0 ), VAO( 0 ), VBO( 0 ), VertexCapacity( 0 ), Shader( std::make_unique<ShaderGL>() )
+{
+}
+
+TextOverlayGL::~TextOverlayGL()
+{
+   if (FontTexture != 0) {
+      GPUMemoryGL::removeTextures( 1, &FontTexture );
+      glDeleteTextures( 1, &FontTexture );
+   }
+   if (VAO != 0) glDeleteVertexArrays( 1, &VAO );
+   if (VBO != 0) {
+      GPUMemoryGL::removeBuffers( 1, &VBO );
+      glDeleteBuffers( 1, &VBO );
+   }
+}
+
+void TextOverlayGL::prepare()
+{
+   // The glyphs are laid in a row of cells, whose padding is left empty.
+   constexpr int width = CellWidth * GlyphNum;
+   std::vector<uint8_t> texels(static_cast<size_t>(width) * CellHeight, 0);
+   for (int g = 0; g < GlyphNum; ++g) {
+      for (int y = 0; y < GlyphHeight; ++y) {
+         const uint8_t row = Glyphs[g * GlyphHeight + y];
+         for (int x = 0; x < GlyphWidth; ++x) {
+            if ((row >> (GlyphWidth - 1 - x)) & 1) texels[y * width + g * CellWidth + x] = 255;
+         }
+      }
+   }
+   glCreateTextures( GL_TEXTURE_2D, 1, &FontTexture );
+   glTextureStorage2D( FontTexture, 1, GL_R8, width, CellHeight );
+   glTextureSubImage2D( FontTexture, 0, 0, 0, width, CellHeight, GL_RED, GL_UNSIGNED_BYTE, texels.data() );
+   GPUMemoryGL::addTexture( FontTexture, static_cast<GLsizeiptr>(texels.size()), "TextOverlay", "font" );
+
+   glCreateVertexArrays( 1, &VAO );
+   glVertexArrayAttribFormat( VAO, 0, 4, GL_FLOAT, GL_FALSE, 0 );
+   glEnableVertexArrayAttrib( VAO, 0 );
+   glVertexArrayAttribBinding( VAO, 0, 0 );
+
+   const std::string shader_directory_path = std::string(CMAKE_SOURCE_DIR) + "/shaders";
+   Shader->setShader(
+      std::string(shader_directory_path + "/TextOverlay.vert").c_str(),
+      std::string(shader_directory_path + "/TextOverlay.frag").c_str()
+   );
+   Shader->addUniformLocation( "FrameSize" );
+}
+
+void TextOverlayGL::reserveVertices(int vertex_num)
+{
+   if (vertex_num <= VertexCapacity) return;
+
+   if (VBO != 0) {
+      GPUMemoryGL::removeBuffers( 1, &VBO );
+      glDeleteBuffers( 1, &VBO );
+   }
+   // It grows by doubling, so the buffer is created again only a few times while the text changes.
+   VertexCapacity = std::max( vertex_num, VertexCapacity * 2 );
+   const auto size = static_cast<GLsizeiptr>(sizeof( glm::vec4 ) * VertexCapacity);
+   glCreateBuffers( 1, &VBO );
+   glNamedBufferStorage( VBO, size, nullptr, GL_DYNAMIC_STORAGE_BIT );
+   GPUMemoryGL::addBuffer( VBO, GPUMemoryGL::Category::Vertex, size, "TextOverlay", "vertices" );
+   glVertexArrayVertexBuffer( VAO, 0, VBO, 0, sizeof( glm::vec4 ) );
+}
+
+void TextOverlayGL::addCharacter(char character, const glm::vec2& position)
+{
+   if ('a' <= character && character <= 'z') character = static_cast<char>(character - 'a' + 'A');
+   int glyph = character - FirstGlyph;
+   if (glyph < 0 || glyph >= GlyphNum) glyph = '?' - FirstGlyph;
+
+   const glm::vec2 size(CellWidth * Scale, CellHeight * Scale);
+   const glm::vec2 texel(static_cast<float>(glyph * CellWidth), 0.0f);
+   const glm::vec2 cell(CellWidth, CellHeight);
+   const std::array<glm::vec2, 6> corners = {
+      glm::vec2(0.0f, 0.0f), glm::vec2(0.0f, 1.0f), glm::vec2(1.0f, 1.0f),
+      glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(1.0f, 0.0f)
+   };
+   for (const auto& corner : corners) {
+      Vertices.emplace_back( position + corner * size, texel + corner * cell );
+   }
+}
+
+void TextOverlayGL::draw(const std::vector<std::string>& lines, int frame_width, int frame_height)
+{
+   if (FontTexture == 0) prepare();
+
+   Vertices.clear();
+   for (size_t i = 0; i < lines.size(); ++i) {
+      const float y = static_cast<float>(Margin + static_cast<int>(i) * CellHeight * Scale);
+      for (size_t c = 0; c < lines[i].size(); ++c) {
+         addCharacter( lines[i][c], { static_cast<float>(Margin + static_cast<int>(c) * CellWidth * Scale), y } );
+      }
+   }
+   if (Vertices.empty()) return;
+
+   const auto vertex_num = static_cast<int>(Vertices.size());
+   reserveVertices( vertex_num );
+   glNamedBufferSubData( VBO, 0, static_cast<GLsizeiptr>(sizeof( glm::vec4 ) * vertex_num), Vertices.data() );
+
+   const GLboolean depth_test = glIsEnabled( GL_DEPTH_TEST );
+   const GLboolean blend = glIsEnabled( GL_BLEND );
+   std::array<GLint, 4> blend_factors{};
+   glGetIntegerv( GL_BLEND_SRC_RGB, &blend_factors[0] );
+   glGetIntegerv( GL_BLEND_DST_RGB, &blend_factors[1] );
+   glGetIntegerv( GL_BLEND_SRC_ALPHA, &blend_factors[2] );
+   glGetIntegerv( GL_BLEND_DST_ALPHA, &blend_factors[3] );
+
+   glDisable( GL_DEPTH_TEST );
+   glEnable( GL_BLEND );
+   glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+   glUseProgram( Shader->getShaderProgram() );
+   glUniform2f( Shader->getLocation( "FrameSize" ), static_cast<float>(frame_width), static_cast<float>(frame_height) );
+   glBindTextureUnit( 0, FontTexture );
+   glBindVertexArray( VAO );
+   glDrawArrays( GL_TRIANGLES, 0, vertex_num );
+
+   glBlendFuncSeparate( blend_factors[0], blend_factors[1], blend_factors[2], blend_factors[3] );
+   if (blend == GL_FALSE) glDisable( GL_BLEND );
+   if (depth_test == GL_TRUE) glEnable( GL_DEPTH_TEST );
+}
\ No newline at end of file
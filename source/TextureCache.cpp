@@ -0,0 +1,75 @@
+#include "TextureCache.h"
+
+TextureCache::TextureCache(const std::string& source_file_path, GLenum internal_format) :
+   SourceCache( source_file_path, "textures", getFileSuffix( internal_format ) ), InternalFormat( internal_format )
+{
+}
+
+std::string TextureCache::getFileSuffix(GLenum internal_format)
+{
+   std::ostringstream suffix;
+   suffix << "-" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << internal_format << ".texture";
+   return suffix.str();
+}
+
+bool TextureCache::load()
+{
+   int64_t modified_time;
+   uint64_t source_size;
+   if (!open( sizeof( Header ), modified_time, source_size )) return false;
+
+   const size_t file_size = File.getSize();
+   const Header& header = getHeader();
+   bool valid =
+      header.Magic == Magic &&
+      header.Version == Version &&
+      header.SourceModifiedTime == modified_time &&
+      header.SourceSize == source_size &&
+      header.InternalFormat == InternalFormat &&
+      header.LevelNum > 0 && header.LevelNum <= MaxLevelNum &&
+      hasSourcePath( sizeof( Header ), header.SourcePathLength );
+   for (uint32_t i = 0; valid && i < header.LevelNum; ++i) {
+      valid = header.Levels[i].Offset % LevelAlignment == 0 &&
+         header.Levels[i].Offset >= sizeof( Header ) + header.SourcePathLength &&
+         header.Levels[i].Offset + header.Levels[i].Size <= file_size;
+   }
+   if (!valid) {
+      File.close();
+      return false;
+   }
+   return true;
+}
+
+bool TextureCache::write(Header header, const std::vector<std::vector<uint8_t>>& levels) const
+{
+   if (levels.empty() || levels.size() > MaxLevelNum) return false;
+   if (!getSourceStatus( header.SourceModifiedTime, header.SourceSize )) return false;
+
+   header.Magic = Magic;
+   header.Version = Version;
+   header.InternalFormat = InternalFormat;
+   header.LevelNum = static_cast<uint32_t>(levels.size());
+   header.SourcePathLength = static_cast<uint32_t>(SourcePath.size());
+   header.Reserved = 0;
+   uint64_t offset = sizeof( Header ) + SourcePath.size();
+   for (size_t i = 0; i < levels.size(); ++i) {
+      offset = align( offset, LevelAlignment );
+      header.Levels[i].Offset = offset;
+      header.Levels[i].Size = levels[i].size();
+      offset += levels[i].size();
+   }
+
+   return AtomicFile::write(
+      CachePath, "texture cache", [&](std::ofstream& file) {
+         const std::array<char, LevelAlignment> padding{};
+         file.write( reinterpret_cast<const char*>(&header), sizeof( Header ) );
+         file.write( SourcePath.data(), static_cast<std::streamsize>(SourcePath.size()) );
+         uint64_t written = sizeof( Header ) + SourcePath.size();
+         for (size_t i = 0; i < levels.size(); ++i) {
+            file.write( padding.data(), static_cast<std::streamsize>(header.Levels[i].Offset - written) );
+            file.write( reinterpret_cast<const char*>(levels[i].data()), static_cast<std::streamsize>(levels[i].size()) );
+            written = header.Levels[i].Offset + header.Levels[i].Size;
+         }
+      }
+   );
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "TextureCompressor.h"
+
+void TextureCompressor::writeBits(uint8_t* block, int& position, uint32_t value, int bit_num)
+{
+   for (int i = 0; i < bit_num; ++i, ++position) {
+      if ((value >> i) & 1u) block[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+   }
+}
+
+size_t TextureCompressor::getCompressedSize(int width, int height, bool is_grayscale)
+{
+   const size_t block_num =
+      static_cast<size_t>((width + BlockSize - 1) / BlockSize) * static_cast<size_t>((height + BlockSize - 1) / BlockSize);
+   return block_num * (is_grayscale ? BC4BlockBytes : BC7BlockBytes);
+}
+
+int TextureCompressor::getMipmapLevelNum(int width, int height)
+{
+   int level_num = 1;
+   for (int size = std::max( width, height ); size > 1; size >>= 1) level_num++;
+   return level_num;
+}
+
+void TextureCompressor::halve(
+   std::vector<uint8_t>& halved,
+   const std::vector<uint8_t>& image,
+   int width,
+   int height,
+   int channel_num
+)
+{
+   const int halved_width = std::max( width / 2, 1 );
+   const int halved_height = std::max( height / 2, 1 );
+   halved.resize( static_cast<size_t>(halved_width) * halved_height * channel_num );
+   for (int j = 0; j < halved_height; ++j) {
+      const int y0 = std::min( 2 * j, height - 1 );
+      const int y1 = std::min( 2 * j + 1, height - 1 );
+      for (int i = 0; i < halved_width; ++i) {
+         const int x0 = std::min( 2 * i, width - 1 );
+         const int x1 = std::min( 2 * i + 1, width - 1 );
+         for (int c = 0; c < channel_num; ++c) {
+            const int sum =
+               image[(y0 * width + x0) * channel_num + c] + image[(y0 * width + x1) * channel_num + c] +
+               image[(y1 * width + x0) * channel_num + c] + image[(y1 * width + x1) * channel_num + c];
+            halved[(j * halved_width + i) * channel_num + c] = static_cast<uint8_t>((sum + 2) / 4);
+         }
+      }
+   }
+}
+
+void TextureCompressor::compressBlocks(
+   std::vector<uint8_t>& blocks,
+   const uint8_t* image,
+   int width,
+   int height,
+   int block_bytes,
+   BlockFunction compress_block
+)
+{
+   const int block_num_x = (width + BlockSize - 1) / BlockSize;
+   const int block_num_y = (height + BlockSize - 1) / BlockSize;
+   blocks.assign( static_cast<size_t>(block_num_x) * block_num_y * block_bytes, 0 );
+
+   const int thread_num = std::clamp( static_cast<int>(std::thread::hardware_concurrency()), 1, block_num_y );
+   const auto compress_rows = [&](int first_row, int last_row) {
+      for (int j = first_row; j < last_row; ++j) {
+         for (int i = 0; i < block_num_x; ++i) {
+            uint8_t* block = blocks.data() + (static_cast<size_t>(j) * block_num_x + i) * block_bytes;
+            compress_block( block, image, width, height, i * BlockSize, j * BlockSize );
+         }
+      }
+   };
+
+   std::vector<std::thread> workers;
+   const int rows_per_thread = (block_num_y + thread_num - 1) / thread_num;
+   for (int t = 1; t < thread_num; ++t) {
+      const int first_row = t * rows_per_thread;
+      if (first_row >= block_num_y) break;
+      workers.emplace_back( compress_rows, first_row, std::min( first_row + rows_per_thread, block_num_y ) );
+   }
+   compress_rows( 0, std::min( rows_per_thread, block_num_y ) );
+   for (auto& worker : workers) worker.join();
+}
+
+void TextureCompressor::compressBC7Block(uint8_t* block, const uint8_t* rgba, int width, int height, int x, int y)
+{
+   std::array<glm::vec4, 16> texels{};
+   for (int j = 0; j < BlockSize; ++j) {
+      for (int i = 0; i < BlockSize; ++i) {
+         const uint8_t* texel = rgba + 4 * (std::min( y + j, height - 1 ) * width + std::min( x + i, width - 1 ));
+         texels[j * BlockSize + i] = glm::vec4(texel[0], texel[1], texel[2], texel[3]);
+      }
+   }
+
+   // The initial endpoints are the extents of the texels along the principal axis.
+   glm::vec4 mean(0.0f);
+   for (const auto& texel : texels) mean += texel;
+   mean /= 16.0f;
+   glm::mat4 covariance(0.0f);
+   glm::vec4 min_texel = texels[0], max_texel = texels[0];
+   for (const auto& texel : texels) {
+      covariance += glm::outerProduct( texel - mean, texel - mean );
+      min_texel = glm::min( min_texel, texel );
+      max_texel = glm::max( max_texel, texel );
+   }
+   glm::vec4 axis = max_texel - min_texel;
+   for (int i = 0; i < 8; ++i) {
+      const glm::vec4 next = covariance * axis;
+      const float length = glm::length( next );
+      if (length < 1e-6f) break;
+      axis = next / length;
+   }
+   if (glm::length( axis ) < 1e-6f) axis = glm::vec4(0.0f);
+   else axis = glm::normalize( axis );
+
+   float min_t = 0.0f, max_t = 0.0f;
+   for (const auto& texel : texels) {
+      const float t = glm::dot( texel - mean, axis );
+      min_t = std::min( min_t, t );
+      max_t = std::max( max_t, t );
+   }
+
+   const auto encode = [&texels](const glm::vec4& e0, const glm::vec4& e1) {
+      BC7Encoding encoding{};
+      const std::array<glm::vec4, 2> endpoints = { e0, e1 };
+      std::array<glm::vec4, 2> decoded{};
+      for (int k = 0; k < 2; ++k) {
+         float best_error = std::numeric_limits<float>::max();
+         for (int p = 0; p < 2; ++p) {
+            std::array<int, 4> quantized{};
+            glm::vec4 value;
+            float error = 0.0f;
+            for (int c = 0; c < 4; ++c) {
+               const float v = std::clamp( endpoints[k][c], 0.0f, 255.0f );
+               quantized[c] = std::clamp( static_cast<int>(std::lround( (v - static_cast<float>(p)) * 0.5f )), 0, 127 );
+               value[c] = static_cast<float>((quantized[c] << 1) | p);
+               error += (value[c] - v) * (value[c] - v);
+            }
+            if (error < best_error) {
+               best_error = error;
+               encoding.Endpoints[k] = quantized;
+               encoding.PBits[k] = p;
+               decoded[k] = value;
+            }
+         }
+      }
+
+      std::array<glm::vec4, 16> palette{};
+      for (int i = 0; i < 16; ++i) {
+         const auto w = static_cast<float>(BC7Weights[i]);
+         palette[i] = glm::floor( ((64.0f - w) * decoded[0] + w * decoded[1] + 32.0f) / 64.0f );
+      }
+      encoding.Error = 0.0f;
+      for (int t = 0; t < 16; ++t) {
+         float best_error = std::numeric_limits<float>::max();
+         for (int i = 0; i < 16; ++i) {
+            const glm::vec4 d = palette[i] - texels[t];
+            const float error = glm::dot( d, d );
+            if (error < best_error) {
+               best_error = error;
+               encoding.Indices[t] = i;
+            }
+         }
+         encoding.Error += best_error;
+      }
+      return encoding;
+   };
+
+   BC7Encoding best = encode( mean + min_t * axis, mean + max_t * axis );
+
+   // The endpoints are refitted to the chosen indices by the least squares, which is kept only if it is better.
+   float a = 0.0f, b = 0.0f, c = 0.0f;
+   glm::vec4 p(0.0f), q(0.0f);
+   for (int t = 0; t < 16; ++t) {
+      const float w = static_cast<float>(BC7Weights[best.Indices[t]]) / 64.0f;
+      a += (1.0f - w) * (1.0f - w);
+      b += (1.0f - w) * w;
+      c += w * w;
+      p += (1.0f - w) * texels[t];
+      q += w * texels[t];
+   }
+   const float determinant = a * c - b * b;
+   if (determinant > 1e-6f) {
+      const BC7Encoding refitted = encode( (c * p - b * q) / determinant, (a * q - b * p) / determinant );
+      if (refitted.Error < best.Error) best = refitted;
+   }
+
+   // The most significant bit of the first index is implicitly 0, so the endpoints are swapped if it is set.
+   if (best.Indices[0] & 8) {
+      std::swap( best.Endpoints[0], best.Endpoints[1] );
+      std::swap( best.PBits[0], best.PBits[1] );
+      for (auto& index : best.Indices) index = 15 - index;
+   }
+
+   std::memset( block, 0, BC7BlockBytes );
+   int position = 0;
+   writeBits( block, position, 1u << 6, 7 );
+   for (int channel = 0; channel < 4; ++channel) {
+      writeBits( block, position, static_cast<uint32_t>(best.Endpoints[0][channel]), 7 );
+      writeBits( block, position, static_cast<uint32_t>(best.Endpoints[1][channel]), 7 );
+   }
+   writeBits( block, position, static_cast<uint32_t>(best.PBits[0]), 1 );
+   writeBits( block, position, static_cast<uint32_t>(best.PBits[1]), 1 );
+   writeBits( block, position, static_cast<uint32_t>(best.Indices[0]), 3 );
+   for (int t = 1; t < 16; ++t) writeBits( block, position, static_cast<uint32_t>(best.Indices[t]), 4 );
+}
+
+void TextureCompressor::compressBC4Block(uint8_t* block, const uint8_t* red, int width, int height, int x, int y)
+{
+   std::array<int, 16> texels{};
+   for (int j = 0; j < BlockSize; ++j) {
+      for (int i = 0; i < BlockSize; ++i) {
+         texels[j * BlockSize + i] = red[std::min( y + j, height - 1 ) * width + std::min( x + i, width - 1 )];
+      }
+   }
+   const auto [min_red, max_red] = std::minmax_element( texels.begin(), texels.end() );
+
+   // With red0 > red1, the palette has 6 values interpolated between them.
+   const int red0 = *max_red, red1 = *min_red;
+   std::array<float, 8> palette{};
+   palette[0] = static_cast<float>(red0);
+   palette[1] = static_cast<float>(red1);
+   for (int i = 2; i < 8; ++i) palette[i] = static_cast<float>((8 - i) * red0 + (i - 1) * red1) / 7.0f;
+
+   uint64_t indices = 0;
+   for (int t = 0; t < 16; ++t) {
+      int best_index = 0;
+      for (int i = 1; i < 8; ++i) {
+         if (std::abs( palette[i] - texels[t] ) < std::abs( palette[best_index] - texels[t] )) best_index = i;
+      }
+      indices |= static_cast<uint64_t>(best_index) << (3 * t);
+   }
+
+   block[0] = static_cast<uint8_t>(red0);
+   block[1] = static_cast<uint8_t>(red1);
+   for (int i = 0; i < 6; ++i) block[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+
+void TextureCompressor::compressBC7(std::vector<uint8_t>& blocks, const uint8_t* rgba, int width, int height)
+{
+   compressBlocks( blocks, rgba, width, height, BC7BlockBytes, compressBC7Block );
+}
+
+void TextureCompressor::compressBC4(std::vector<uint8_t>& blocks, const uint8_t* red, int width, int height)
+{
+   compressBlocks( blocks, red, width, height, BC4BlockBytes, compressBC4Block );
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "VertexBenchmark.h"
+
+VertexBenchmark::VertexBenchmark(std::vector<int> vertex_nums, int repetition_num) :
+   VertexNums( std::move( vertex_nums ) ), RepetitionNum( std::max( repetition_num, 1 ) ), Sink( 0.0f )
+{
+}
+
+VertexBenchmark::Vertices VertexBenchmark::getVertices(int vertex_num)
+{
+   // They are the vertices of a square grid, which is the shape of the cloth.
+   Vertices vertices;
+   const auto side = static_cast<int>(std::ceil( std::sqrt( static_cast<double>(vertex_num) ) ));
+   for (int i = 0; i < vertex_num; ++i) {
+      const auto x = static_cast<float>(i % side) / static_cast<float>(side);
+      const auto y = static_cast<float>(i / side) / static_cast<float>(side);
+      vertices.Positions.emplace_back( x, 0.1f * std::sin( 10.0f * x ), y );
+      vertices.Normals.emplace_back( 0.0f, 1.0f, 0.0f );
+      vertices.Textures.emplace_back( x, y );
+   }
+   return vertices;
+}
+
+void VertexBenchmark::interleaveWithPushBack(std::vector<GLfloat>& data, const Vertices& vertices, bool reserve)
+{
+   data.clear();
+   if (reserve) data.reserve( vertices.Positions.size() * Stride );
+   for (size_t i = 0; i < vertices.Positions.size(); ++i) {
+      data.push_back( vertices.Positions[i].x );
+      data.push_back( vertices.Positions[i].y );
+      data.push_back( vertices.Positions[i].z );
+      data.push_back( vertices.Normals[i].x );
+      data.push_back( vertices.Normals[i].y );
+      data.push_back( vertices.Normals[i].z );
+      data.push_back( vertices.Textures[i].x );
+      data.push_back( vertices.Textures[i].y );
+   }
+}
+
+void VertexBenchmark::replaceWithIndices(std::vector<GLfloat>& data, const std::vector<glm::vec3>& positions)
+{
+   for (size_t i = 0; i < positions.size(); ++i) {
+      data[i * Stride] = positions[i].x;
+      data[i * Stride + 1] = positions[i].y;
+      data[i * Stride + 2] = positions[i].z;
+   }
+}
+
+void VertexBenchmark::addResult(const std::string& group, const std::string& variant, int vertex_num, double nanoseconds)
+{
+   const auto baseline = std::find_if(
+      Results.begin(), Results.end(),
+      [&](const Result& result) { return result.Group == group && result.VertexNum == vertex_num; }
+   );
+   const double speedup = baseline == Results.end() ? 1.0 : baseline->NanosecondsPerVertex / nanoseconds;
+   Results.push_back( { group, variant, vertex_num, nanoseconds, speedup } );
+}
+
+void VertexBenchmark::runInterleaving(const Vertices& vertices, int vertex_num)
+{
+   const auto n = static_cast<size_t>(vertex_num);
+   const glm::vec3* positions = vertices.Positions.data();
+   const glm::vec3* normals = vertices.Normals.data();
+   const glm::vec2* textures = vertices.Textures.data();
+
+   // A new object starts with an empty buffer, so every float may grow it.
+   addResult( "setObject", "push_back", vertex_num, measure( [&]() {
+      std::vector<GLfloat> data;
+      interleaveWithPushBack( data, vertices, false );
+      Sink = data.back();
+   }, vertex_num ) );
+   addResult( "setObject", "reserve + push_back", vertex_num, measure( [&]() {
+      std::vector<GLfloat> data;
+      interleaveWithPushBack( data, vertices, true );
+      Sink = data.back();
+   }, vertex_num ) );
+   addResult( "setObject", "VertexLayout::interleave", vertex_num, measure( [&]() {
+      std::vector<GLfloat> data;
+      VertexLayout::interleave( data, n, positions, normals, textures );
+      Sink = data.back();
+   }, vertex_num ) );
+
+   // An update keeps the capacity of the previous one, so only the cost of each push_back remains.
+   std::vector<GLfloat> data;
+   addResult( "updateDataBuffer", "push_back", vertex_num, measure( [&]() {
+      interleaveWithPushBack( data, vertices, false );
+      Sink = data.back();
+   }, vertex_num ) );
+   addResult( "updateDataBuffer", "VertexLayout::interleave", vertex_num, measure( [&]() {
+      VertexLayout::interleave( data, n, positions, normals, textures );
+      Sink = data.back();
+   }, vertex_num ) );
+}
+
+void VertexBenchmark::runReplacing(const Vertices& vertices, int vertex_num)
+{
+   const auto n = static_cast<size_t>(vertex_num);
+   std::vector<GLfloat> data;
+   VertexLayout::interleave( data, n, vertices.Positions.data(), vertices.Normals.data(), vertices.Textures.data() );
+   addResult( "replaceVertices", "indexed loop", vertex_num, measure( [&]() {
+      replaceWithIndices( data, vertices.Positions );
+      Sink = data.back();
+   }, vertex_num ) );
+   addResult( "replaceVertices", "VertexLayout::scatter", vertex_num, measure( [&]() {
+      VertexLayout::scatter<3>( data.data(), Stride, 0, n, glm::value_ptr( vertices.Positions[0] ) );
+      Sink = data.back();
+   }, vertex_num ) );
+}
+
+void VertexBenchmark::runUploading(const Vertices& vertices, int vertex_num)
+{
+   const auto n = static_cast<size_t>(vertex_num);
+   const auto size = static_cast<GLsizeiptr>(sizeof( GLfloat ) * n * Stride);
+   const glm::vec3* positions = vertices.Positions.data();
+   const glm::vec3* normals = vertices.Normals.data();
+   const glm::vec2* textures = vertices.Textures.data();
+
+   // Each upload waits for GPU, so the time includes the transfer as well as the building on CPU.
+   GLuint buffer, mapped_buffer;
+   glCreateBuffers( 1, &buffer );
+   glNamedBufferStorage( buffer, size, nullptr, GL_DYNAMIC_STORAGE_BIT );
+   const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+   glCreateBuffers( 1, &mapped_buffer );
+   glNamedBufferStorage( mapped_buffer, size, nullptr, flags );
+   auto* mapped_data = static_cast<GLfloat*>(glMapNamedBufferRange( mapped_buffer, 0, size, flags ));
+
+   std::vector<GLfloat> data;
+   addResult( "updateDataBuffer + upload", "push_back", vertex_num, measure( [&]() {
+      interleaveWithPushBack( data, vertices, false );
+      glNamedBufferSubData( buffer, 0, size, data.data() );
+      glFinish();
+   }, vertex_num ) );
+   addResult( "updateDataBuffer + upload", "VertexLayout::interleave", vertex_num, measure( [&]() {
+      VertexLayout::interleave( data, n, positions, normals, textures );
+      glNamedBufferSubData( buffer, 0, size, data.data() );
+      glFinish();
+   }, vertex_num ) );
+   addResult( "updateDataBuffer + upload", "VertexLayout::write to mapped", vertex_num, measure( [&]() {
+      VertexLayout::write( mapped_data, n, positions, normals, textures );
+      glFinish();
+   }, vertex_num ) );
+
+   addResult( "replaceVertices + upload", "indexed loop", vertex_num, measure( [&]() {
+      replaceWithIndices( data, vertices.Positions );
+      glNamedBufferSubData( buffer, 0, size, data.data() );
+      glFinish();
+   }, vertex_num ) );
+   addResult( "replaceVertices + upload", "VertexLayout::scatter", vertex_num, measure( [&]() {
+      VertexLayout::scatter<3>( data.data(), Stride, 0, n, glm::value_ptr( vertices.Positions[0] ) );
+      glNamedBufferSubData( buffer, 0, size, data.data() );
+      glFinish();
+   }, vertex_num ) );
+   addResult( "replaceVertices + upload", "VertexLayout::scatter to mapped", vertex_num, measure( [&]() {
+      VertexLayout::scatter<3>( mapped_data, Stride, 0, n, glm::value_ptr( vertices.Positions[0] ) );
+      glFinish();
+   }, vertex_num ) );
+
+   glUnmapNamedBuffer( mapped_buffer );
+   glDeleteBuffers( 1, &mapped_buffer );
+   glDeleteBuffers( 1, &buffer );
+}
+
+void VertexBenchmark::run()
+{
+   const bool gpu = Context.create();
+   if (!gpu) std::cerr << "No OpenGL 4.6 context is available, so the uploads are skipped.\n";
+
+   for (const auto& vertex_num : VertexNums) {
+      const Vertices vertices = getVertices( vertex_num );
+      runInterleaving( vertices, vertex_num );
+      runReplacing( vertices, vertex_num );
+      if (gpu) runUploading( vertices, vertex_num );
+   }
+}
+
+void VertexBenchmark::printResults() const
+{
+#ifndef NDEBUG
+   std::cout << "(The benchmark is not an optimized build, so configure it with -DCMAKE_BUILD_TYPE=Release.)\n";
+#endif
+   if (Context.isCreated()) std::cout << "GPU: " << Context.getRenderer() << "\n";
+   std::cout << std::left << std::setw( 28 ) << "Group" << std::setw( 34 ) << "Variant" << std::right
+      << std::setw( 10 ) << "Vertices" << std::setw( 14 ) << "ns/vertex" << std::setw( 10 ) << "Speedup" << "\n";
+   for (const auto& result : Results) {
+      std::cout << std::left << std::setw( 28 ) << result.Group << std::setw( 34 ) << result.Variant << std::right
+         << std::setw( 10 ) << result.VertexNum << std::fixed << std::setprecision( 3 )
+         << std::setw( 14 ) << result.NanosecondsPerVertex << std::setw( 9 ) << result.Speedup << "x\n";
+      std::cout.unsetf( std::ios::floatfield );
+   }
+   std::cout << std::setprecision( 6 );
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "ZoneProfiler.h"
+
+void ZoneProfiler::start()
+{
+   StartTime = std::chrono::steady_clock::now();
+   Enabled = true;
+   setThreadName( "Main" );
+}
+
+int64_t ZoneProfiler::getTime()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - StartTime).count();
+}
+
+ZoneProfiler::ThreadEvents& ZoneProfiler::getThreadEvents()
+{
+   // The profiler shares the events, so they are still there to be written after the thread exits.
+   thread_local std::shared_ptr<ThreadEvents> events;
+   if (!events) {
+      std::lock_guard<std::mutex> lock( Mutex );
+      events = std::make_shared<ThreadEvents>( static_cast<int>(Threads.size()) + 1 );
+      Threads.emplace_back( events );
+   }
+   return *events;
+}
+
+void ZoneProfiler::setThreadName(const char* name)
+{
+   if (Enabled) getThreadEvents().ThreadName = name;
+}
+
+void ZoneProfiler::record(const char* name, int64_t begin_time, int64_t end_time)
+{
+   ThreadEvents& events = getThreadEvents();
+   EventBlock* block = events.Tail;
+   int count = block->Count.load( std::memory_order_relaxed );
+   if (count == BlockSize) {
+      auto* next = new EventBlock();
+      block->Next.store( next, std::memory_order_release );
+      events.Tail = block = next;
+      count = 0;
+   }
+   block->Events[count] = { name, begin_time, end_time };
+   block->Count.store( count + 1, std::memory_order_release );
+}
+
+void ZoneProfiler::writeString(std::ofstream& file, const char* text)
+{
+   file << '"';
+   for (const char* c = text; *c != '\0'; ++c) {
+      if (*c == '"' || *c == '\\') file << '\\';
+      file << *c;
+   }
+   file << '"';
+}
+
+bool ZoneProfiler::writeTrace(const std::string& file_path)
+{
+   std::ofstream file(file_path, std::ios::trunc);
+   if (!file.is_open()) {
+      std::cerr << "Cannot write the trace: " << file_path << "\n";
+      return false;
+   }
+
+   std::vector<std::shared_ptr<ThreadEvents>> threads;
+   {
+      std::lock_guard<std::mutex> lock( Mutex );
+      threads = Threads;
+   }
+
+   // The complete events of the trace event format take the begin time and duration in microseconds.
+   bool first_event = true;
+   const auto begin_event = [&file, &first_event]() {
+      file << (first_event ? "\n" : ",\n");
+      first_event = false;
+   };
+   file << std::fixed << std::setprecision( 3 ) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+   for (const auto& thread : threads) {
+      const char* thread_name = thread->ThreadName.load();
+      if (thread_name != nullptr) {
+         begin_event();
+         file << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << thread->ThreadID << R"(,"args":{"name":)";
+         writeString( file, thread_name );
+         file << "}}";
+      }
+      for (const EventBlock* block = &thread->Head; block != nullptr; block = block->Next.load( std::memory_order_acquire )) {
+         const int count = block->Count.load( std::memory_order_acquire );
+         for (int i = 0; i < count; ++i) {
+            const Event& event = block->Events[i];
+            begin_event();
+            file << R"({"name":)";
+            writeString( file, event.Name );
+            file << R"(,"cat":"cpu","ph":"X","pid":1,"tid":)" << thread->ThreadID
+               << R"(,"ts":)" << static_cast<double>(event.BeginTime) * 1e-3
+               << R"(,"dur":)" << static_cast<double>(event.EndTime - event.BeginTime) * 1e-3 << "}";
+         }
+      }
+   }
+   file << "\n]}\n";
+   return static_cast<bool>(file);
+}
\ No newline at end of file
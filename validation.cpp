@@ -0,0 +1,48 @@
+#include "ClothValidation.h"
+
+int main(int argc, char* argv[])
+{
+   ClothValidation::Options options;
+   std::string baseline_path, new_baseline_path;
+   bool valid = true;
+   for (int i = 1; i < argc && valid; ++i) {
+      const std::string option(argv[i]);
+      const bool has_value = i + 1 < argc;
+      if (option == "--sizes" && has_value) {
+         options.GridSizes.clear();
+         std::istringstream stream(argv[++i]);
+         std::string number;
+         while (std::getline( stream, number, ',' )) {
+            // The flexion springs need at least three points on a side.
+            const int value = std::atoi( number.c_str() );
+            valid = valid && value >= 3;
+            options.GridSizes.emplace_back( value );
+         }
+         valid = valid && !options.GridSizes.empty();
+      }
+      else if (option == "--steps" && has_value) valid = (options.StepNum = std::atoi( argv[++i] )) > 0;
+      else if (option == "--threads" && has_value) options.ThreadNum = std::atoi( argv[++i] );
+      else if (option == "--no-sphere") options.UseSphereCollider = false;
+      else if (option == "--require-gpu") options.RequireGPU = true;
+      else if (option == "--position-tolerance" && has_value) options.PositionTolerance = std::strtof( argv[++i], nullptr );
+      else if (option == "--energy-tolerance" && has_value) options.EnergyTolerance = std::strtof( argv[++i], nullptr );
+      else if (option == "--strain-tolerance" && has_value) options.StrainTolerance = std::strtof( argv[++i], nullptr );
+      else if (option == "--baseline" && has_value) baseline_path = argv[++i];
+      else if (option == "--write-baseline" && has_value) new_baseline_path = argv[++i];
+      else valid = false;
+   }
+   if (!valid) {
+      std::cerr << "Usage: " << argv[0]
+         << " [--sizes 33,100,...] [--steps <number>] [--threads <number>] [--no-sphere] [--require-gpu]"
+         << " [--position-tolerance <spring lengths>] [--energy-tolerance <ratio>] [--strain-tolerance <strain>]"
+         << " [--baseline <file.csv>] [--write-baseline <file.csv>]\n";
+      return 1;
+   }
+
+   ClothValidation validation(options);
+   if (!baseline_path.empty() && !validation.readBaseline( baseline_path )) return 1;
+   const bool passed = validation.run();
+   validation.printResults();
+   if (!new_baseline_path.empty() && !validation.writeBaseline( new_baseline_path )) return 1;
+   return passed ? 0 : 1;
+}
\ No newline at end of file
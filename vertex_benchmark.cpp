@@ -0,0 +1,33 @@
+#include "VertexBenchmark.h"
+
+int main(int argc, char* argv[])
+{
+   // They are the cloth of 100x100, 256x256 and 1024x1024 points.
+   std::vector<int> vertex_nums = { 10000, 65536, 1048576 };
+   int repetition_num = 20;
+   bool valid = true;
+   for (int i = 1; i < argc && valid; ++i) {
+      const std::string option(argv[i]);
+      if (option == "--vertices" && i + 1 < argc) {
+         vertex_nums.clear();
+         std::istringstream stream(argv[++i]);
+         std::string number;
+         while (std::getline( stream, number, ',' )) {
+            const int value = std::atoi( number.c_str() );
+            valid = valid && value > 0;
+            vertex_nums.emplace_back( value );
+         }
+      }
+      else if (option == "--repetitions" && i + 1 < argc) valid = (repetition_num = std::atoi( argv[++i] )) > 0;
+      else valid = false;
+   }
+   if (!valid || vertex_nums.empty()) {
+      std::cerr << "Usage: " << argv[0] << " [--vertices 10000,65536,...] [--repetitions <number>]\n";
+      return 1;
+   }
+
+   VertexBenchmark benchmark(vertex_nums, repetition_num);
+   benchmark.run();
+   benchmark.printResults();
+   return 0;
+}
\ No newline at end of file